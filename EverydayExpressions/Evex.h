@@ -2,6 +2,20 @@
 
 #include "EvexTranslator.h"
 #include "EvexGroupNode.h"
+#include "EvexDfaCache.h"
+#include "EvexPrefilter.h"
+#include "EvexBitParallel.h"
+#include "EvexMatchResult.h"
+#include "EvexMatchContext.h"
+
+#include <string_view>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#if __cplusplus > 201703L || (defined(_MSVC_LANG) && _MSVC_LANG > 201703L)
+#include <span>
+#endif
 
 
 namespace Evex
@@ -22,14 +36,8 @@ namespace Evex
 			std::unordered_set<RegexChunk<T>*> Out;
 			for (RegexNodeGhostIn<T>* currIn : Ins)
 			{
-				for (RegexChunk<T>* currChunk : ChunksInvolved)
-				{
-					if (currChunk->ContainsNode(currIn))
-					{
-						Out.insert(currChunk);
-						break;
-					}
-				}
+				if (ChunksInvolved.find(currIn->Owner) != ChunksInvolved.end())
+					Out.insert(currIn->Owner);
 			}
 			return Out;
 		}
@@ -39,20 +47,16 @@ namespace Evex
 			std::unordered_set<RegexChunk<T>*> Out;
 			for (RegexNodeGhostOut<T>* currOut : Outs)
 			{
-				for (RegexChunk<T>* currChunk : ChunksInvolved)
-				{
-					if (currChunk->ContainsNode(currOut))
-					{
-						Out.insert(currChunk);
-						break;
-					}
-				}
+				if (ChunksInvolved.find(currOut->Owner) != ChunksInvolved.end())
+					Out.insert(currOut->Owner);
 			}
 			return Out;
 		}
 	};
 	
 	template<typename T> class RegexAssembler;
+	template<typename T> class RegexStreamScanner;
+	template<typename T> class RegexSet;
 	
 	class RegexCompileException : public std::exception
 	{
@@ -70,10 +74,16 @@ namespace Evex
 	class Regex
 	{
 	private:
+
+		// Owns every node, chunk, capture and character class below, all of which are released along with it.
+		RegexArena Arena;
 	
 		std::vector<RegexCaptureBase<T>*> Captures;
 		std::vector<RegexCaptureBase<T>*> DefinedSubroutines;
 		std::unordered_map<std::basic_string<T>, RegexCaptureBase<T>*> NamesToCaptures;
+
+		// Group number (i.e. index into Captures + 1) of every named capture, for match results.
+		std::unordered_map<std::basic_string<T>, int> NamesToGroups;
 	
 		std::vector<RegexCharacterClassSymbol<T>*> CharClassSymbols;
 		std::vector<RegexCharacterClassBase<T>*> CharacterClasses;
@@ -83,29 +93,85 @@ namespace Evex
 		std::unordered_set<RegexChunk<T>*> Chunks;
 		std::unordered_set<RegexNodeGhostIn<T>*> StartNodes;
 		std::unordered_set<RegexNodeGhostOut<T>*> EndNodes;
+
+		// Flattened form of the finished automaton, which is what matching actually runs over.
+		RegexStateTable<T> StateTable;
+
+		/*
+			Which frontiers can have their transitions cached, with row 0 being the regex's entry frontier,
+			and row i + 1 the successors of state i. The transitions themselves are cached per match context.
+		*/
+		std::vector<bool> DfaEligible;
+		size_t DfaCacheLimit = RegexDfaCache::DefaultMemoryLimit;
+
+		// Is every frontier cacheable, allowing MatchAll to scan in a single pass?
+		bool AllFrontiersPlain = false;
+
+		// Where matches can start, used to skip offsets which can't possibly match.
+		RegexPrefilter<T> Prefilter;
+
+		// Replaces walking the state table, for small regexes of plain nodes and loops over them.
+		RegexBitParallel<T> BitParallel;
+	
+		// Number of recursion and subroutine nodes, each of which tracks its depth in the match context.
+		int DepthSlotCount = 0;
+
+		/*
+			Can MatchAll be split across threads? Not if anything depends on where the previous match ended,
+			or on code hooks being called in order.
+		*/
+		bool CanMatchInParallel = true;
 	
 		std::string CompileError = "";
-		std::vector<std::string> RuntimeErrors;
 	
 		bool StartsWithLineCheck = false; // starts with word bound check or line check
 		bool EndsWithLineCheck = false; // ends with word bound check or line check
 	
-		// End of the last match, for exclusive use by "\\G"
-		RegexRangeIterator<T> LastMatchEnd;
+		// Context used by every match function which isn't given one.
+		RegexMatchContext<T> DefaultContext;
 	
-		void ResetPreMatch()
+		// Sizes the given context for this regex, unless it already is.
+		void PrepareContext(RegexMatchContext<T>& MatchContext) const
 		{
-			for (RegexTicker<T>& currTicker : Tickers)
-				currTicker.Reset();
+			if (MatchContext.Program == this)
+				return;
+	
+			MatchContext.Program = this;
+			MatchContext.TickerTimes.resize(Tickers.size());
+			MatchContext.Captures.assign(Captures.size() + DefinedSubroutines.size(), RegexCaptureState<T>());
+			MatchContext.Depths.assign(DepthSlotCount, 0);
+			MatchContext.LastMatchEnd = RegexRangeIterator<T>();
+			MatchContext.RuntimeErrors.clear();
+			MatchContext.DfaCache.Reset(DfaEligible);
+			MatchContext.DfaCache.SetMemoryLimit(DfaCacheLimit);
+			MatchContext.StateStamps.assign(StateTable.StateCount(), -1);
+			MatchContext.StoredTickerTimes.reserve(Tickers.size());
+	
+			for (RegexCaptureBase<T>* currCap : Captures)
+				currCap->Reset(MatchContext);
+	
+			for (RegexCaptureBase<T>* currSub : DefinedSubroutines)
+				currSub->Reset(MatchContext);
+		}
+	
+		void ResetPreMatch(RegexMatchContext<T>& MatchContext) const
+		{
+			for (const RegexTicker<T>& currTicker : Tickers)
+				currTicker.Reset(MatchContext);
 	
 			for (RegexCaptureBase<T>* currCap : Captures)
 			{
 				if (!currCap->Manual)
-					currCap->Reset();
+					currCap->Reset(MatchContext);
 			}
 	
 			for (RegexCaptureBase<T>* currSub : DefinedSubroutines)
-				currSub->Reset();
+				currSub->Reset(MatchContext);
+	
+			std::fill(MatchContext.Depths.begin(), MatchContext.Depths.end(), 0);
+	
+			// Left over if the last match was cut short by a runtime error.
+			MatchContext.StoredTickerTimes.clear();
 		}
 	
 	public:
@@ -114,87 +180,109 @@ namespace Evex
 		using FuncMapType = std::unordered_map<std::basic_string<T>, HookFuncType>;
 	
 		template<typename TranslatorType = RegexTranslator<T>, typename AssemblerType = RegexAssembler<T>>
-		Regex(std::basic_string<T> c, FuncMapType* Funcs = nullptr, std::vector<RegexInstruction<T>>* OutInstructions = nullptr, int MaxNestingDepth = 100, RegexRangeIterator<T>* PresetLastMatchEnd = nullptr);
+		Regex(std::basic_string<T> c, FuncMapType* Funcs = nullptr, RegexProgram<T>* OutInstructions = nullptr, int MaxNestingDepth = 100, RegexRangeIterator<T>* PresetLastMatchEnd = nullptr);
 
-		Regex(std::vector<RegexInstruction<T>>& Instructions, FuncMapType* Funcs = nullptr);
-	
-		~Regex()
-		{
-			for (RegexChunk<T>* CurrChunk : Chunks)
-				delete CurrChunk;
-	
-			for (RegexCaptureBase<T>* currCap : Captures)
-				delete currCap;
-	
-			for (RegexCaptureBase<T>* currSub : DefinedSubroutines)
-				delete currSub;
-	
-			for (RegexCharacterClassBase<T>* currCharClass : CharacterClasses)
-				delete currCharClass;
-	
-			for (RegexCharacterClassSymbol<T>* currSymb : CharClassSymbols)
-				delete currSymb;
-		}
+		Regex(const RegexProgram<T>& Instructions, FuncMapType* Funcs = nullptr);
 	
 		bool IsValidForMatching() const { return CompileError.empty(); }
 		std::string GetCompileError() const { return CompileError; }
-		const std::vector<std::string>& GetRuntimeErrors() const { return RuntimeErrors; }
+		const std::vector<std::string>& GetRuntimeErrors() const { return DefaultContext.RuntimeErrors; }
 	
-		RegexRangeIterator<T>& GetLastMatchEnd() const { return LastMatchEnd; }
-		RegexRangeIterator<T>* GetLastMatchEndPtr() const { return &LastMatchEnd; }
-		void SetLastMatchEnd(RegexRangeIterator<T>& NewLastMatch) { LastMatchEnd = NewLastMatch; }
-		void SetLastMatchEnd(RegexRangeIterator<T>* NewLastMatch) { LastMatchEnd = *NewLastMatch; }
+		RegexRangeIterator<T>& GetLastMatchEnd() { return DefaultContext.LastMatchEnd; }
+		RegexRangeIterator<T>* GetLastMatchEndPtr() { return &DefaultContext.LastMatchEnd; }
+		void SetLastMatchEnd(RegexRangeIterator<T>& NewLastMatch) { DefaultContext.LastMatchEnd = NewLastMatch; }
+		void SetLastMatchEnd(RegexRangeIterator<T>* NewLastMatch) { DefaultContext.LastMatchEnd = *NewLastMatch; }
+
+		/*
+			Caps the memory used to cache transitions of the regex's purely regular parts. Clears the default context's cache.
+			Other contexts take the new cap the next time they're set up for this regex.
+		*/
+		void SetDfaCacheLimit(size_t Bytes) { DfaCacheLimit = Bytes; DefaultContext.DfaCache.SetMemoryLimit(Bytes); }
+		size_t GetDfaCacheLimit() const { return DfaCacheLimit; }
+
+		/*
+			Approximate bytes held by the compiled regex: its arena, state table and lookup tables.
+			Doesn't count what match contexts have cached, including the default context.
+		*/
+		size_t GetMemoryUsage() const
+		{
+			return sizeof(*this) + Arena.GetBytesReserved() + StateTable.MemoryUsage() +
+				Tickers.capacity() * sizeof(RegexTicker<T>) + DfaEligible.capacity() / 8 +
+				Prefilter.Literal.capacity() * sizeof(T) + BitParallel.MemoryUsage();
+		}
 	
 	private:
 	
-		// Returns true if matches the given input string, from the beginning.
-		bool MatchInternal(std::basic_string<T>& String)
+		/*
+			Walks the state table from Iter onward, leaving Iter where the walk stopped and
+			OutState as the last state entered (or -1 if none could be).
+			OutAccepting is set to whether the walk ended in a match.
+			Returns false if a runtime error occurred along the way.
+		*/
+		bool RunInternal(RegexRangeIterator<T>& Iter, int& OutState, bool& OutAccepting, RegexMatchContext<T>& MatchContext) const
 		{
-			if (!CompileError.empty())
-				throw RegexCompileException(CompileError);
-	
-			RuntimeErrors.clear();
-	
-			ResetPreMatch();
+			if (BitParallel.IsActive())
+			{
+				OutState = BitParallel.Run(Iter, OutAccepting);
+				return true;
+			}
 	
-			RegexRangeIterator<T> Iter(String.begin(), String.begin(), String.end());
+			OutState = -1;
+			OutAccepting = false;
+
+			const int* CurrNextsBegin = nullptr, *CurrNextsEnd = nullptr;
+			StateTable.GetEntries(0, CurrNextsBegin, CurrNextsEnd);
 	
-			std::vector<RegexNode<T>*> CurrentNexts;
+			int CurrRow = 0;
 	
-			for (RegexNodeGhostIn<T>* currIn : StartNodes)
-			{
-				std::vector<RegexNode<T>*> NextReals = currIn->GetNexts();
-				CurrentNexts.insert(CurrentNexts.end(), NextReals.begin(), NextReals.end());
-			}
+			// As within RegexChunk::Match, a state that took no input isn't entered again straight after at the same place.
+			bool GaveWay = false;
 	
 			bool FirstTime = true;
 			bool LastTime = EndsWithLineCheck;
-			RegexNode<T>* CurrNode = nullptr;
-			while (CurrentNexts.size() > 0 && (!Iter.IsEnd() || LastTime))
+			while (CurrNextsBegin != CurrNextsEnd && (!Iter.IsEnd() || LastTime))
 			{
-				bool NewNodeFound = false;
-				for (RegexNode<T>* currNext : CurrentNexts)
+				const T* EnteredAt = Iter;
+	
+				int NextState = -1;
+
+				// Plain frontiers only ever look at the current character, so their pick can be cached per byte.
+				int* Row = (Iter.IsEnd() ? nullptr : MatchContext.DfaCache.GetRow(CurrRow));
+				if (Row && Row[(unsigned char)*Iter] != RegexDfaCache::Unknown)
+					NextState = Row[(unsigned char)*Iter];
+				else
 				{
-					try
+					for (const int* currNext = CurrNextsBegin; currNext != CurrNextsEnd; ++currNext)
 					{
-						if (currNext->CanEnter(Iter))
+						if (GaveWay && *currNext == OutState)
+							continue;
+	
+						try
 						{
-							CurrNode = currNext;
-							NewNodeFound = true;
-							break;
+							if (RegexEnterNode(StateTable.States[*currNext], Iter, MatchContext))
+							{
+								NextState = *currNext;
+								break;
+							}
+						}
+						catch (RegexRuntimeException e)
+						{
+							MatchContext.RuntimeErrors.push_back(e.what());
+							return false;
 						}
 					}
-					catch (RegexRuntimeException e)
-					{
-						RuntimeErrors.push_back(e.what());
-						return false;
-					}
+
+					if (Row)
+						Row[(unsigned char)*Iter] = (NextState < 0 ? RegexDfaCache::Dead : NextState);
 				}
 	
-				if (!NewNodeFound)
+				if (NextState < 0)
 					break;
-	
-				CurrentNexts = CurrNode->GetNexts();
+
+				GaveWay = (const T*)Iter < EnteredAt;
+				OutState = NextState;
+				CurrRow = OutState + 1;
+				StateTable.GetSuccessors(OutState, MatchContext, CurrNextsBegin, CurrNextsEnd);
 	
 				if (!(StartsWithLineCheck && FirstTime))
 				{
@@ -207,147 +295,621 @@ namespace Evex
 					FirstTime = false;
 			}
 	
-			CurrentNexts.clear();
+			OutAccepting = OutState >= 0 && StateTable.IsAccepting(OutState, 0, MatchContext);
+			return true;
+		}
 	
-			if (CurrNode)
-			{
-				for (RegexNodeGhostOut<T>* CurrOut : CurrNode->GhostNexts)
-				{
-					if (EndNodes.find(CurrOut) != EndNodes.end())
-						return true;
-				}
-			}
+		// Returns true if matches the given input string, from the beginning.
+		bool MatchInternal(const T* Begin, const T* End, RegexMatchContext<T>& MatchContext) const
+		{
+			if (!CompileError.empty())
+				throw RegexCompileException(CompileError);
 	
-			return false;
+			PrepareContext(MatchContext);
+			MatchContext.RuntimeErrors.clear();
+	
+			if (Begin != End && !Prefilter.CanStartAt(Begin, End - Begin, 0))
+				return false;
+	
+			ResetPreMatch(MatchContext);
+	
+			RegexRangeIterator<T> Iter(Begin, Begin, End);
+
+			int EndState = -1;
+			bool Accepting = false;
+			if (!RunInternal(Iter, EndState, Accepting, MatchContext))
+				return false;
+	
+			return Accepting;
 		}
 	
-		// Returns true if matches the given input string, from the given offset position onward
-		bool MatchFromInternal(std::basic_string<T>& String, int Offset, std::basic_string<T>& OutSubstring)
+		// Returns true if matches the given input string, from the given offset position onward. OutMatchEnd is set to the offset the match ends at.
+		bool MatchFromInternal(const T* Begin, const T* End, ptrdiff_t Offset, ptrdiff_t& OutMatchEnd, RegexMatchContext<T>& MatchContext) const
 		{
 			if (!CompileError.empty())
 				throw RegexCompileException(CompileError);
 	
-			RuntimeErrors.clear();
+			PrepareContext(MatchContext);
+			MatchContext.RuntimeErrors.clear();
+
+			ptrdiff_t LastRead = -1;
+			return AttemptAt(Begin, End, Offset, OutMatchEnd, LastRead, MatchContext);
+		}
+
+		/*
+			MatchFromInternal without the setup. OutLastRead is set to the furthest offset the attempt
+			looked at, which is the input's length if it ran into the end.
+		*/
+		bool AttemptAt(const T* Begin, const T* End, ptrdiff_t Offset, ptrdiff_t& OutMatchEnd, ptrdiff_t& OutLastRead, RegexMatchContext<T>& MatchContext) const
+		{
+			const ptrdiff_t Length = End - Begin;
+			if (Offset < Length && !Prefilter.CanStartAt(Begin, Length, Offset))
+			{
+				OutLastRead = std::min(Length, Offset + std::max<ptrdiff_t>(1, Prefilter.Literal.size()) - 1);
+				return false;
+			}
 	
-			ResetPreMatch();
+			ResetPreMatch(MatchContext);
 	
-			RegexRangeIterator<T> Iter(String.begin() + Offset, String.begin(), String.end());
+			RegexRangeIterator<T> Iter(Begin + Offset, Begin, End);
+
+			int EndState = -1;
+			bool Accepting = false;
+			bool Completed = RunInternal(Iter, EndState, Accepting, MatchContext);
+			OutLastRead = (const T*)Iter - Begin;
 	
-			std::vector<RegexNode<T>*> CurrentNexts;
+			if (Completed && Accepting)
+			{
+				OutMatchEnd = OutLastRead;
+				return true;
+			}
 	
-			for (RegexNodeGhostIn<T>* currIn : StartNodes)
+			return false;
+		}
+
+		// Prepares the given results to receive matches found in the given input.
+		void BeginResults(RegexMatchResults<T>& OutResults, const T* Begin) const
+		{
+			OutResults.Reset(Begin, int(Captures.size()) + 1, &NamesToGroups);
+		}
+
+		// Appends a match to the given results, along with whatever the captures currently hold.
+		void RecordMatch(RegexMatchResults<T>& OutResults, const T* Begin, const T* End, ptrdiff_t MatchBegin, ptrdiff_t MatchEnd, const RegexMatchContext<T>& MatchContext) const
+		{
+			ptrdiff_t* Groups = OutResults.AddMatch();
+			Groups[0] = MatchBegin;
+			Groups[1] = MatchEnd;
+
+			for (unsigned int i = 0; i < Captures.size(); ++i)
 			{
-				std::vector<RegexNode<T>*> NextReals = currIn->GetNexts();
-				CurrentNexts.insert(CurrentNexts.end(), NextReals.begin(), NextReals.end());
+				// Pre-set captures don't point into the input, so they have no offsets to give.
+				const T* CapBegin = nullptr, *CapEnd = nullptr;
+				if (Captures[i]->GetState(MatchContext).Succeeded && Captures[i]->GetCaptureRange(MatchContext, CapBegin, CapEnd) && CapBegin >= Begin && CapEnd <= End)
+				{
+					Groups[(i + 1) * 2] = CapBegin - Begin;
+					Groups[(i + 1) * 2 + 1] = CapEnd - Begin;
+				}
 			}
+		}
 	
-			bool FirstTime = true;
-			bool LastTime = EndsWithLineCheck;
-			RegexNode<T>* CurrNode = nullptr;
-			while (CurrentNexts.size() > 0 && (!Iter.IsEnd() || LastTime))
+		// Gets the state entered from the given one (-1 being the entry frontier) on the character at Iter, or -1 if none.
+		inline int StepPlain(int State, RegexRangeIterator<T>& Iter, RegexMatchContext<T>& MatchContext) const
+		{
+			int* Row = MatchContext.DfaCache.GetRow(State + 1);
+			int& Cached = Row[(unsigned char)*Iter];
+			if (Cached != RegexDfaCache::Unknown)
+				return Cached;
+
+			const int* NextsBegin = nullptr, *NextsEnd = nullptr;
+			if (State < 0)
+				StateTable.GetEntries(0, NextsBegin, NextsEnd);
+			else
+				StateTable.GetSuccessors(State, MatchContext, NextsBegin, NextsEnd);
+
+			Cached = RegexDfaCache::Dead;
+			for (const int* currNext = NextsBegin; currNext != NextsEnd; ++currNext)
+			{
+				if (RegexEnterNode(StateTable.States[*currNext], Iter, MatchContext))
+				{
+					Cached = *currNext;
+					break;
+				}
+			}
+
+			return Cached;
+		}
+
+		/*
+			Advances every walk in flight over the character at Pos, or finishes them all if Pos is the end of the input,
+			first starting a new walk there if MayStart allows it. Matches are recorded as soon as nothing older is left in flight.
+			MinStart is the offset before which no walk may start, being covered by an earlier match, and LastEnd the end of the last match.
+		*/
+		void StepWalks(const T* Begin, const T* End, ptrdiff_t Pos, bool MayStart, ptrdiff_t& MinStart, ptrdiff_t& LastEnd, RegexMatchResults<T>& OutResults, RegexMatchContext<T>& MatchContext) const
+		{
+			using Walk = RegexSearchWalk;
+
+			const ptrdiff_t Length = End - Begin;
+			const T* Data = Begin;
+
+			std::vector<Walk>& Walks = MatchContext.Walks;
+			std::vector<Walk>& NextWalks = MatchContext.NextWalks;
+			std::vector<ptrdiff_t>& StateStamps = MatchContext.StateStamps;
+
+			if (MayStart && Pos >= MinStart && Prefilter.CanStartAt(Data, Length, Pos))
+				Walks.push_back({ Pos, -1, false, false, -1 });
+
+			RegexRangeIterator<T> Iter(Data + Pos, Data, Data + Length);
+
+			NextWalks.clear();
+			ptrdiff_t MatchedUpTo = -1;
+			for (Walk& currWalk : Walks)
 			{
-				bool NewNodeFound = false;
-				for (RegexNode<T>* currNext : CurrentNexts)
+				if (currWalk.Start < MatchedUpTo)
+					continue;
+
+				if (!currWalk.Finished)
 				{
-					try
+					int NextState = (Pos < Length ? StepPlain(currWalk.State, Iter, MatchContext) : -1);
+					if (NextState < 0)
 					{
-						if (currNext->CanEnter(Iter))
-						{
-							CurrNode = currNext;
-							NewNodeFound = true;
-							break;
-						}
+						currWalk.Finished = true;
+						currWalk.Matched = currWalk.State >= 0 && StateTable.IsAccepting(currWalk.State, 0);
+						currWalk.End = Pos;
+
+						if (!currWalk.Matched)
+							continue;
+
+						MatchedUpTo = Pos;
 					}
-					catch (RegexRuntimeException e)
+					else
 					{
-						RuntimeErrors.push_back(e.what());
-						return false;
+						if (StateStamps[NextState] == Pos)
+							continue;
+
+						StateStamps[NextState] = Pos;
+						currWalk.State = NextState;
 					}
 				}
-	
-				if (!NewNodeFound)
-					break;
-	
-				CurrentNexts = CurrNode->GetNexts();
-	
-				if (!(StartsWithLineCheck && FirstTime))
+
+				NextWalks.push_back(currWalk);
+			}
+			Walks.swap(NextWalks);
+
+			// Report finished walks from the front, as nothing older can still take their place, and drop any covered walks.
+			size_t Reported = 0;
+			while (Reported < Walks.size() && (Walks[Reported].Finished || Walks[Reported].Start < MinStart))
+			{
+				const Walk& currWalk = Walks[Reported++];
+				if (currWalk.Start >= MinStart)
 				{
-					if (!Iter.IsEnd())
-						++Iter;
-					else if (LastTime)
-						LastTime = false;
+					RecordMatch(OutResults, Begin, End, currWalk.Start, currWalk.End, MatchContext);
+					MinStart = LastEnd = currWalk.End;
 				}
-				else
-					FirstTime = false;
 			}
+
+			Walks.erase(Walks.begin(), Walks.begin() + Reported);
+		}
+
+		/*
+			MatchAll for regexes made only of plain nodes, running over the input once rather than once per offset.
+
+			Walks from every start offset are run side by side. Once a walk finishes with a match, every younger
+			walk starts inside that match (or inside whichever older match ends up covering it), so they're dropped.
+			Past that, each walk is deterministic, so two walks entering the same state at the same position end
+			identically, and the younger can be dropped: if the older one matches it covers the younger's start,
+			and if it fails the younger would have too.
+			Finished walks are reported oldest first, skipping any that start inside an earlier match.
+			Only starts within [From, StartLimit) are walked from, though their matches may run past StartLimit.
+		*/
+		bool MatchAllUnanchored(const T* Begin, const T* End, ptrdiff_t From, ptrdiff_t StartLimit, RegexMatchResults<T>& OutResults, RegexMatchContext<T>& MatchContext) const
+		{
+			MatchContext.RuntimeErrors.clear();
+
+			ResetPreMatch(MatchContext);
+
+			const ptrdiff_t Length = End - Begin;
+			const T* Data = Begin;
+
+			std::vector<RegexSearchWalk>& Walks = MatchContext.Walks;
+			Walks.clear();
+			MatchContext.StateStamps.assign(StateTable.StateCount(), -1);
+
+			ptrdiff_t MinStart = From;
+			ptrdiff_t LastEnd = -1;
+
+			for (ptrdiff_t currPos = From; currPos <= Length; ++currPos)
+			{
+				// With nothing in flight, skip straight to the next offset a match could start at.
+				if (Walks.empty())
+				{
+					currPos = Prefilter.NextCandidate(Data, Length, currPos);
+					if (currPos < 0 || currPos >= StartLimit)
+						break;
+				}
+
+				StepWalks(Begin, End, currPos, currPos < StartLimit, MinStart, LastEnd, OutResults, MatchContext);
+			}
+
+			if (LastEnd >= 0)
+				MatchContext.LastMatchEnd = RegexRangeIterator<T>(Data + LastEnd - 1, Data, Data + Length);
+
+			return !OutResults.empty() && MatchContext.RuntimeErrors.empty();
+		}
 	
-			CurrentNexts.clear();
+		/*
+			Finds every match starting within [From, StartLimit), as MatchAll would were it to reach From
+			without an earlier match covering it. Matches may run past StartLimit.
+		*/
+		bool MatchAllRange(const T* Begin, const T* End, ptrdiff_t From, ptrdiff_t StartLimit, RegexMatchResults<T>& OutResults, RegexMatchContext<T>& MatchContext) const
+		{
+			if (AllFrontiersPlain)
+				return MatchAllUnanchored(Begin, End, From, StartLimit, OutResults, MatchContext);
 	
-			if (CurrNode)
+			const ptrdiff_t Length = End - Begin;
+
+			// Offsets up to here are known to be worth trying, so needn't be scanned for again.
+			ptrdiff_t LiveUntil = -1;
+
+			auto NextCandidate =
+				[this, Begin, Length, &LiveUntil](ptrdiff_t CandidateFrom)
+				{
+					ptrdiff_t Candidate = Prefilter.NextCandidate(Begin, Length, CandidateFrom);
+					if (Candidate < 0 || Candidate <= LiveUntil || !BitParallel.IsActive())
+						return Candidate;
+
+					ptrdiff_t PossibleStart = BitParallel.NextPossibleStart(Begin, Length, Candidate, LiveUntil);
+					return (PossibleStart < 0 ? -1 : Prefilter.NextCandidate(Begin, Length, PossibleStart));
+				};
+
+			for (ptrdiff_t i = NextCandidate(From); i >= 0 && i < StartLimit; i = NextCandidate(i + 1))
 			{
-				for (RegexNodeGhostOut<T>* CurrOut : CurrNode->GhostNexts)
+				ptrdiff_t MatchEnd = -1;
+				if (MatchFromInternal(Begin, End, i, MatchEnd, MatchContext))
 				{
-					if (EndNodes.find(CurrOut) != EndNodes.end())
-					{
-						RegexRangeIterator<T> Copy(String.begin() + Offset, String.begin(), String.end());
-						for (; Copy != Iter; ++Copy)
-							OutSubstring += *Copy;
+					RecordMatch(OutResults, Begin, End, i, MatchEnd, MatchContext);
+					MatchContext.LastMatchEnd = RegexRangeIterator<T>(Begin + MatchEnd - 1, Begin, End);
 	
-						return true;
-					}
+					// An empty match leaves the next attempt to start one further on.
+					i = std::max(i, MatchEnd - 1);
 				}
 			}
 	
-			return false;
+			return !OutResults.empty() && MatchContext.RuntimeErrors.empty();
 		}
 	
 		// Returns true if any matching substrings were found in the given text, from any position.
-		bool MatchAllInternal(std::basic_string<T>& String, std::vector<std::basic_string<T>>& OutSubstrings)
+		bool MatchAllInternal(const T* Begin, const T* End, RegexMatchResults<T>& OutResults, RegexMatchContext<T>& MatchContext) const
 		{
 			if (!CompileError.empty())
 				throw RegexCompileException(CompileError);
 	
-			OutSubstrings.clear();
-	
-			for (unsigned int i = 0; i < String.length(); ++i)
+			PrepareContext(MatchContext);
+			BeginResults(OutResults, Begin);
+
+			return MatchAllRange(Begin, End, 0, End - Begin, OutResults, MatchContext);
+		}
+
+		/*
+			MatchAll split over several threads, giving exactly what MatchAllInternal would.
+
+			The input is cut into chunks, more of them than there are threads so that threads finishing early
+			can take on what's left. Each chunk is searched from its first offset as though nothing before it
+			had matched, against the whole input, so matches may run past the chunk and lookarounds and anchors
+			still see everything. Chunks are then stitched together in order: wherever the sequential search
+			would resume inside a match the chunk found from an earlier start, it's rescanned from there until
+			it resumes somewhere the chunk's own search did, after which the two agree.
+		*/
+		bool MatchAllParallelInternal(const T* Begin, const T* End, RegexMatchResults<T>& OutResults, unsigned int ThreadCount, RegexMatchContext<T>& MatchContext) const
+		{
+			if (!CompileError.empty())
+				throw RegexCompileException(CompileError);
+
+			if (0 == ThreadCount)
+				ThreadCount = std::max(1u, std::thread::hardware_concurrency());
+
+			// Below this, a chunk isn't worth handing to a thread.
+			const ptrdiff_t MinChunkLength = 1 << 16;
+			const int ChunksPerThread = 4;
+
+			const ptrdiff_t Length = End - Begin;
+			const int ChunkCount = int(std::min<ptrdiff_t>(ptrdiff_t(ThreadCount) * ChunksPerThread, Length / MinChunkLength));
+			if (ThreadCount < 2 || ChunkCount < 2 || !CanMatchInParallel)
+				return MatchAllInternal(Begin, End, OutResults, MatchContext);
+
+			PrepareContext(MatchContext);
+			BeginResults(OutResults, Begin);
+
+			auto ChunkStart =
+				[Length, ChunkCount](int Chunk)
+				{
+					return Length * Chunk / ChunkCount;
+				};
+
+			std::vector<RegexMatchResults<T>> ChunkResults(ChunkCount);
+
+			// Workers start from copies of the given context, so pre-set captures and cached transitions carry over.
+			ThreadCount = std::min(ThreadCount, unsigned(ChunkCount));
+			std::vector<RegexMatchContext<T>> WorkerContexts(ThreadCount, MatchContext);
+
+			std::atomic<int> NextChunk(0);
+			auto Work =
+				[this, Begin, End, ChunkCount, &ChunkStart, &ChunkResults, &NextChunk](RegexMatchContext<T>* WorkerContext)
+				{
+					for (int currChunk = NextChunk++; currChunk < ChunkCount; currChunk = NextChunk++)
+					{
+						BeginResults(ChunkResults[currChunk], Begin);
+						MatchAllRange(Begin, End, ChunkStart(currChunk), ChunkStart(currChunk + 1), ChunkResults[currChunk], *WorkerContext);
+					}
+				};
+
+			std::vector<std::thread> Workers;
+			for (unsigned int i = 1; i < ThreadCount; ++i)
+				Workers.emplace_back(Work, &WorkerContexts[i]);
+			Work(&WorkerContexts[0]);
+
+			for (std::thread& currWorker : Workers)
+				currWorker.join();
+
+			// Offset the sequential search would carry on from.
+			ptrdiff_t Pos = 0;
+			ptrdiff_t LastEnd = -1;
+
+			for (int currChunk = 0; currChunk < ChunkCount; ++currChunk)
 			{
-				std::basic_string<T> NextSub;
-				if (MatchFromInternal(String, i, NextSub))
+				const ptrdiff_t ChunkEnd = ChunkStart(currChunk + 1);
+				const RegexMatchResults<T>& Found = ChunkResults[currChunk];
+
+				size_t Next = 0;
+				while (Pos < ChunkEnd)
 				{
-					OutSubstrings.push_back(NextSub);
-					i += NextSub.length() - 1;
-					LastMatchEnd = RegexRangeIterator<T>(String.begin() + i, String.begin(), String.end());
+					// Skip whatever the chunk found that the sequential search has already gone past.
+					while (Next < Found.size() && Found[Next].Begin() < Pos && Found[Next].End() <= Pos)
+						++Next;
+
+					if (Next < Found.size() && Found[Next].Begin() < Pos)
+					{
+						// The chunk never tried Pos, as it lies inside one of its matches, so try it here.
+						ptrdiff_t Candidate = Prefilter.NextCandidate(Begin, Length, Pos);
+						if (Candidate < 0)
+						{
+							Pos = Length;
+							break;
+						}
+
+						if (Candidate != Pos)
+						{
+							Pos = Candidate;
+							continue;
+						}
+
+						ptrdiff_t MatchEnd = -1;
+						if (MatchFromInternal(Begin, End, Pos, MatchEnd, MatchContext))
+						{
+							RecordMatch(OutResults, Begin, End, Pos, MatchEnd, MatchContext);
+							Pos = (MatchEnd > Pos ? MatchEnd : Pos + 1);
+							LastEnd = MatchEnd;
+						}
+						else
+							++Pos;
+
+						continue;
+					}
+
+					// The chunk's search resumed from Pos as well, so everything it found from here on stands.
+					for (; Next < Found.size(); ++Next)
+					{
+						OutResults.AppendMatch(Found, Next);
+						Pos = LastEnd = Found[Next].End();
+					}
+
+					Pos = std::max(Pos, ChunkEnd);
 				}
 			}
+
+			if (LastEnd >= 0)
+				MatchContext.LastMatchEnd = RegexRangeIterator<T>(Begin + LastEnd - 1, Begin, End);
+
+			MatchContext.RuntimeErrors.clear();
+			for (const RegexMatchContext<T>& currWorkerContext : WorkerContexts)
+				MatchContext.RuntimeErrors.insert(MatchContext.RuntimeErrors.end(), currWorkerContext.RuntimeErrors.begin(), currWorkerContext.RuntimeErrors.end());
+
+			return !OutResults.empty() && MatchContext.RuntimeErrors.empty();
+		}
+
+		bool MatchFromInternal(const T* Begin, const T* End, ptrdiff_t Offset, std::basic_string<T>& OutSubstring, RegexMatchContext<T>& MatchContext) const
+		{
+			ptrdiff_t MatchEnd = -1;
+			if (!MatchFromInternal(Begin, End, Offset, MatchEnd, MatchContext))
+				return false;
+
+			OutSubstring.append(Begin + Offset, Begin + MatchEnd);
+			return true;
+		}
+
+		bool MatchFromInternal(const T* Begin, const T* End, ptrdiff_t Offset, RegexMatchResults<T>& OutResults, RegexMatchContext<T>& MatchContext) const
+		{
+			BeginResults(OutResults, Begin);
+
+			ptrdiff_t MatchEnd = -1;
+			if (!MatchFromInternal(Begin, End, Offset, MatchEnd, MatchContext))
+				return false;
+
+			RecordMatch(OutResults, Begin, End, Offset, MatchEnd, MatchContext);
+			return true;
+		}
+
+		void ForgetInputInternal(RegexMatchResults<T>& Results, RegexMatchContext<T>& MatchContext) const
+		{
+			Results.Subject = nullptr;
+			MatchContext.LastMatchEnd = RegexRangeIterator<T>();
+			ResetPreMatch(MatchContext);
+			for (RegexCaptureState<T>& currCap : MatchContext.Captures)
+				currCap.DropInputRanges();
+		}
 	
-			return !OutSubstrings.empty() && RuntimeErrors.empty();
+		// Copies every whole match out of the given results.
+		static void CopySubstrings(const T* Begin, const RegexMatchResults<T>& Results, std::vector<std::basic_string<T>>& OutSubstrings)
+		{
+			OutSubstrings.clear();
+			OutSubstrings.reserve(Results.size());
+			for (size_t i = 0; i < Results.size(); ++i)
+				OutSubstrings.emplace_back(Begin + Results[i].Begin(), Begin + Results[i].End());
 		}
+
+		bool MatchAllInternal(const T* Begin, const T* End, std::vector<std::basic_string<T>>& OutSubstrings, RegexMatchContext<T>& MatchContext) const
+		{
+			RegexMatchResults<T> Results;
+			bool Success = MatchAllInternal(Begin, End, Results, MatchContext);
+			CopySubstrings(Begin, Results, OutSubstrings);
+			return Success;
+		}
+
+		bool MatchAllParallelInternal(const T* Begin, const T* End, std::vector<std::basic_string<T>>& OutSubstrings, unsigned int ThreadCount, RegexMatchContext<T>& MatchContext) const
+		{
+			RegexMatchResults<T> Results;
+			bool Success = MatchAllParallelInternal(Begin, End, Results, ThreadCount, MatchContext);
+			CopySubstrings(Begin, Results, OutSubstrings);
+			return Success;
+		}
+
+		static inline const T* EndOf(const T* String) { return String + std::char_traits<T>::length(String); }
 	
 	public:
 
 		// Returns true if matches the given input string, from the beginning.
-		inline bool Match(const T* String) { return MatchInternal(std::basic_string<T>(String)); }
+		inline bool Match(const T* String) { return MatchInternal(String, EndOf(String), DefaultContext); }
 
 		// Returns true if matches the given input string, from the beginning.
-		inline bool Match(std::basic_string<T>& String) { return MatchInternal(String); }
+		inline bool Match(const std::basic_string<T>& String) { return MatchInternal(String.data(), String.data() + String.size(), DefaultContext); }
+
+		// Captures point into the matched input rather than holding copies of it, so temporary strings are refused here and below.
+		bool Match(std::basic_string<T>&& String) = delete;
+
+		// Returns true if matches the given input string, from the beginning. The input needn't be null-terminated.
+		inline bool Match(const T* String, size_t Length) { return MatchInternal(String, String + Length, DefaultContext); }
+
+		// Returns true if matches the given input string, from the beginning. The input needn't be null-terminated.
+		inline bool Match(std::basic_string_view<T> String) { return MatchInternal(String.data(), String.data() + String.size(), DefaultContext); }
 
 
 		// Returns true if matches the given input string, from the given offset position onward
-		inline bool MatchFrom(const T* String, int Offset, std::basic_string<T>& OutSubstring) { return MatchFromInternal(std::basic_string<T>(String), Offset, OutSubstring); }
+		inline bool MatchFrom(const T* String, ptrdiff_t Offset, std::basic_string<T>& OutSubstring) { return MatchFromInternal(String, EndOf(String), Offset, OutSubstring, DefaultContext); }
 
 		// Returns true if matches the given input string, from the given offset position onward
-		inline bool MatchFrom(std::basic_string<T>& String, int Offset, std::basic_string<T>& OutSubstring) { return MatchFromInternal(String, Offset, OutSubstring); }
+		inline bool MatchFrom(const std::basic_string<T>& String, ptrdiff_t Offset, std::basic_string<T>& OutSubstring) { return MatchFromInternal(String.data(), String.data() + String.size(), Offset, OutSubstring, DefaultContext); }
+		bool MatchFrom(std::basic_string<T>&& String, ptrdiff_t Offset, std::basic_string<T>& OutSubstring) = delete;
+
+		// Returns true if matches the given input string, from the given offset position onward. The input needn't be null-terminated.
+		inline bool MatchFrom(const T* String, size_t Length, ptrdiff_t Offset, std::basic_string<T>& OutSubstring) { return MatchFromInternal(String, String + Length, Offset, OutSubstring, DefaultContext); }
+
+		// Returns true if matches the given input string, from the given offset position onward. The input needn't be null-terminated.
+		inline bool MatchFrom(std::basic_string_view<T> String, ptrdiff_t Offset, std::basic_string<T>& OutSubstring) { return MatchFromInternal(String.data(), String.data() + String.size(), Offset, OutSubstring, DefaultContext); }
+
+		// Returns true if matches the given input string, from the given offset position onward. The match and its groups are given as offsets into String.
+		inline bool MatchFrom(const T* String, ptrdiff_t Offset, RegexMatchResults<T>& OutResults) { return MatchFromInternal(String, EndOf(String), Offset, OutResults, DefaultContext); }
+
+		// Returns true if matches the given input string, from the given offset position onward. The match and its groups are given as offsets into String.
+		inline bool MatchFrom(const std::basic_string<T>& String, ptrdiff_t Offset, RegexMatchResults<T>& OutResults) { return MatchFromInternal(String.data(), String.data() + String.size(), Offset, OutResults, DefaultContext); }
+		bool MatchFrom(std::basic_string<T>&& String, ptrdiff_t Offset, RegexMatchResults<T>& OutResults) = delete;
+
+		// Returns true if matches the given input string, from the given offset position onward. The match and its groups are given as offsets into String.
+		inline bool MatchFrom(const T* String, size_t Length, ptrdiff_t Offset, RegexMatchResults<T>& OutResults) { return MatchFromInternal(String, String + Length, Offset, OutResults, DefaultContext); }
+
+		// Returns true if matches the given input string, from the given offset position onward. The match and its groups are given as offsets into String.
+		inline bool MatchFrom(std::basic_string_view<T> String, ptrdiff_t Offset, RegexMatchResults<T>& OutResults) { return MatchFromInternal(String.data(), String.data() + String.size(), Offset, OutResults, DefaultContext); }
 
 
 		// Returns true if any matching substrings were found in the given text, from any position.
-		inline bool MatchAll(const T* String, std::vector<std::basic_string<T>>& OutSubstrings) { return MatchAllInternal(std::basic_string<T>(String), OutSubstrings); }
+		inline bool MatchAll(const T* String, std::vector<std::basic_string<T>>& OutSubstrings) { return MatchAllInternal(String, EndOf(String), OutSubstrings, DefaultContext); }
 
 		// Returns true if any matching substrings were found in the given text, from any position.
-		inline bool MatchAll(std::basic_string<T>& String, std::vector<std::basic_string<T>>& OutSubstrings) { return MatchAllInternal(String, OutSubstrings); }
+		inline bool MatchAll(const std::basic_string<T>& String, std::vector<std::basic_string<T>>& OutSubstrings) { return MatchAllInternal(String.data(), String.data() + String.size(), OutSubstrings, DefaultContext); }
+		bool MatchAll(std::basic_string<T>&& String, std::vector<std::basic_string<T>>& OutSubstrings) = delete;
+
+		// Returns true if any matching substrings were found in the given text, from any position. The input needn't be null-terminated.
+		inline bool MatchAll(const T* String, size_t Length, std::vector<std::basic_string<T>>& OutSubstrings) { return MatchAllInternal(String, String + Length, OutSubstrings, DefaultContext); }
+
+		// Returns true if any matching substrings were found in the given text, from any position. The input needn't be null-terminated.
+		inline bool MatchAll(std::basic_string_view<T> String, std::vector<std::basic_string<T>>& OutSubstrings) { return MatchAllInternal(String.data(), String.data() + String.size(), OutSubstrings, DefaultContext); }
+
+		// Returns true if any matching substrings were found in the given text, from any position. Matches and their groups are given as offsets into String, all sharing one array.
+		inline bool MatchAll(const T* String, RegexMatchResults<T>& OutResults) { return MatchAllInternal(String, EndOf(String), OutResults, DefaultContext); }
+
+		// Returns true if any matching substrings were found in the given text, from any position. Matches and their groups are given as offsets into String, all sharing one array.
+		inline bool MatchAll(const std::basic_string<T>& String, RegexMatchResults<T>& OutResults) { return MatchAllInternal(String.data(), String.data() + String.size(), OutResults, DefaultContext); }
+		bool MatchAll(std::basic_string<T>&& String, RegexMatchResults<T>& OutResults) = delete;
+
+		// Returns true if any matching substrings were found in the given text, from any position. Matches and their groups are given as offsets into String, all sharing one array.
+		inline bool MatchAll(const T* String, size_t Length, RegexMatchResults<T>& OutResults) { return MatchAllInternal(String, String + Length, OutResults, DefaultContext); }
+
+		// Returns true if any matching substrings were found in the given text, from any position. Matches and their groups are given as offsets into String, all sharing one array.
+		inline bool MatchAll(std::basic_string_view<T> String, RegexMatchResults<T>& OutResults) { return MatchAllInternal(String.data(), String.data() + String.size(), OutResults, DefaultContext); }
+
+		/*
+			As MatchAll, but splitting large inputs across the given number of threads, or one per core if 0.
+			Gives exactly what the single-threaded version would. Regexes using "\\G" or code hooks, and inputs
+			too small to be worth splitting, are matched on the calling thread.
+		*/
+		inline bool MatchAll(std::basic_string_view<T> String, std::vector<std::basic_string<T>>& OutSubstrings, unsigned int ThreadCount) { return MatchAllParallelInternal(String.data(), String.data() + String.size(), OutSubstrings, ThreadCount, DefaultContext); }
+		inline bool MatchAll(std::basic_string_view<T> String, RegexMatchResults<T>& OutResults, unsigned int ThreadCount) { return MatchAllParallelInternal(String.data(), String.data() + String.size(), OutResults, ThreadCount, DefaultContext); }
+		bool MatchAll(std::basic_string<T>&& String, std::vector<std::basic_string<T>>& OutSubstrings, unsigned int ThreadCount) = delete;
+		bool MatchAll(std::basic_string<T>&& String, RegexMatchResults<T>& OutResults, unsigned int ThreadCount) = delete;
+
+		/*
+			Drops whatever the given results and the last match left behind that points into the input, for when it's about
+			to go away, e.g. a file being unmapped. Only the offsets are left to give. Pre-set captures don't point into it, so they're kept.
+		*/
+		inline void ForgetInput(RegexMatchResults<T>& Results) { ForgetInputInternal(Results, DefaultContext); }
+
+#ifdef __cpp_lib_span
+		// std::span equivalents of the above, for any contiguous buffer (e.g. a mapped file or a network buffer).
+
+		inline bool Match(std::span<const T> String) { return MatchInternal(String.data(), String.data() + String.size(), DefaultContext); }
+
+		inline bool MatchFrom(std::span<const T> String, ptrdiff_t Offset, std::basic_string<T>& OutSubstring) { return MatchFromInternal(String.data(), String.data() + String.size(), Offset, OutSubstring, DefaultContext); }
+		inline bool MatchFrom(std::span<const T> String, ptrdiff_t Offset, RegexMatchResults<T>& OutResults) { return MatchFromInternal(String.data(), String.data() + String.size(), Offset, OutResults, DefaultContext); }
+
+		inline bool MatchAll(std::span<const T> String, std::vector<std::basic_string<T>>& OutSubstrings) { return MatchAllInternal(String.data(), String.data() + String.size(), OutSubstrings, DefaultContext); }
+		inline bool MatchAll(std::span<const T> String, RegexMatchResults<T>& OutResults) { return MatchAllInternal(String.data(), String.data() + String.size(), OutResults, DefaultContext); }
+#endif
+
+
+		/*
+			Equivalents of the above which keep everything the match changes in the given context rather than in the regex.
+			These never write to the regex, so any number of threads may use them at once, each with its own context.
+			As above, the input must outlive any captures read back from the context, so temporary strings are refused.
+		*/
+
+		// Picks out rvalue strings alone, so that string literals still go to the string_view overloads.
+		template<typename StringType>
+		using OnlyTemporary = typename std::enable_if<std::is_same<StringType, std::basic_string<T>>::value>::type;
+
+		inline bool Match(RegexMatchContext<T>& MatchContext, std::basic_string_view<T> String) const { return MatchInternal(String.data(), String.data() + String.size(), MatchContext); }
+
+		inline bool MatchFrom(RegexMatchContext<T>& MatchContext, std::basic_string_view<T> String, ptrdiff_t Offset, std::basic_string<T>& OutSubstring) const { return MatchFromInternal(String.data(), String.data() + String.size(), Offset, OutSubstring, MatchContext); }
+		inline bool MatchFrom(RegexMatchContext<T>& MatchContext, std::basic_string_view<T> String, ptrdiff_t Offset, RegexMatchResults<T>& OutResults) const { return MatchFromInternal(String.data(), String.data() + String.size(), Offset, OutResults, MatchContext); }
+
+		inline bool MatchAll(RegexMatchContext<T>& MatchContext, std::basic_string_view<T> String, std::vector<std::basic_string<T>>& OutSubstrings) const { return MatchAllInternal(String.data(), String.data() + String.size(), OutSubstrings, MatchContext); }
+		inline bool MatchAll(RegexMatchContext<T>& MatchContext, std::basic_string_view<T> String, RegexMatchResults<T>& OutResults) const { return MatchAllInternal(String.data(), String.data() + String.size(), OutResults, MatchContext); }
+
+		inline bool MatchAll(RegexMatchContext<T>& MatchContext, std::basic_string_view<T> String, std::vector<std::basic_string<T>>& OutSubstrings, unsigned int ThreadCount) const { return MatchAllParallelInternal(String.data(), String.data() + String.size(), OutSubstrings, ThreadCount, MatchContext); }
+		inline bool MatchAll(RegexMatchContext<T>& MatchContext, std::basic_string_view<T> String, RegexMatchResults<T>& OutResults, unsigned int ThreadCount) const { return MatchAllParallelInternal(String.data(), String.data() + String.size(), OutResults, ThreadCount, MatchContext); }
+
+		template<typename StringType, typename = OnlyTemporary<StringType>> bool Match(RegexMatchContext<T>& MatchContext, StringType&& String) const = delete;
+		template<typename StringType, typename = OnlyTemporary<StringType>> bool MatchFrom(RegexMatchContext<T>& MatchContext, StringType&& String, ptrdiff_t Offset, std::basic_string<T>& OutSubstring) const = delete;
+		template<typename StringType, typename = OnlyTemporary<StringType>> bool MatchFrom(RegexMatchContext<T>& MatchContext, StringType&& String, ptrdiff_t Offset, RegexMatchResults<T>& OutResults) const = delete;
+		template<typename StringType, typename = OnlyTemporary<StringType>> bool MatchAll(RegexMatchContext<T>& MatchContext, StringType&& String, std::vector<std::basic_string<T>>& OutSubstrings) const = delete;
+		template<typename StringType, typename = OnlyTemporary<StringType>> bool MatchAll(RegexMatchContext<T>& MatchContext, StringType&& String, RegexMatchResults<T>& OutResults) const = delete;
+		template<typename StringType, typename = OnlyTemporary<StringType>> bool MatchAll(RegexMatchContext<T>& MatchContext, StringType&& String, std::vector<std::basic_string<T>>& OutSubstrings, unsigned int ThreadCount) const = delete;
+		template<typename StringType, typename = OnlyTemporary<StringType>> bool MatchAll(RegexMatchContext<T>& MatchContext, StringType&& String, RegexMatchResults<T>& OutResults, unsigned int ThreadCount) const = delete;
+
+		inline void ForgetInput(RegexMatchContext<T>& MatchContext, RegexMatchResults<T>& Results) const { ForgetInputInternal(Results, MatchContext); }
 	
 	private:
 	
 		friend class RegexAssembler<T>;
+		friend class RegexStreamScanner<T>;
+		friend class RegexSet<T>;
 		template<typename T> friend bool DrawRegex(Regex<T>& RegexGraph, const std::basic_string<T>& Filepath);
 
 		/*
@@ -393,7 +955,7 @@ namespace Evex
 			FocusNode->Ins = CollapsedChunk.Ins;
 			FocusNode->Outs = CollapsedChunk.Outs;
 	
-			RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(FocusNode);
+			RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Arena, FocusNode);
 			Chunks.insert(NewChunk);
 	
 			return GetLooseEnds(NewChunk);
@@ -413,7 +975,7 @@ namespace Evex
 				currFocus->Ins = CollapsedChunk.Ins;
 				currFocus->Outs = CollapsedChunk.Outs;
 	
-				RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(currFocus);
+				RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Arena, currFocus);
 				Chunks.insert(NewChunk);
 	
 				Out.push_back(GetLooseEnds(NewChunk));
@@ -422,12 +984,22 @@ namespace Evex
 			return Out;
 		}
 	
-		// Constructs the operation "ab"
+		// Joins the chunks involved in both sides, taking them from whichever holds more rather than copying. Both are left empty.
+		static inline std::unordered_set<RegexChunk<T>*> TakeChunksInvolved(RegexChunkLooseEnds<T>& lhs, RegexChunkLooseEnds<T>& rhs)
+		{
+			const bool RightLarger = lhs.ChunksInvolved.size() < rhs.ChunksInvolved.size();
+			std::unordered_set<RegexChunk<T>*> Out = std::move(RightLarger ? rhs.ChunksInvolved : lhs.ChunksInvolved);
+			std::unordered_set<RegexChunk<T>*>& Smaller = (RightLarger ? lhs.ChunksInvolved : rhs.ChunksInvolved);
+	
+			Out.insert(Smaller.begin(), Smaller.end());
+			Smaller.clear();
+			return Out;
+		}
+	
+		// Constructs the operation "ab". Both sides are consumed.
 		inline RegexChunkLooseEnds<T> Concat(RegexChunkLooseEnds<T>& lhs, RegexChunkLooseEnds<T>& rhs)
 		{
 			RegexChunkLooseEnds<T> Out;
-			Out.ChunksInvolved = lhs.ChunksInvolved;
-			Out.ChunksInvolved.insert(rhs.ChunksInvolved.begin(), rhs.ChunksInvolved.end());
 	
 			std::unordered_set<RegexChunk<T>*> LeftOuts = lhs.GetEndChunks();
 			std::unordered_set<RegexChunk<T>*> RightIns = rhs.GetStartChunks();
@@ -438,8 +1010,9 @@ namespace Evex
 			for (RegexNodeGhostOut<T>* currLeftOut : lhs.Outs)
 				currLeftOut->GhostNexts.insert(rhs.Ins.begin(), rhs.Ins.end());
 	
-			Out.Ins = lhs.Ins;
-			Out.Outs = rhs.Outs;
+			Out.ChunksInvolved = TakeChunksInvolved(lhs, rhs);
+			Out.Ins = std::move(lhs.Ins);
+			Out.Outs = std::move(rhs.Outs);
 	
 			return Out;
 		}
@@ -447,7 +1020,7 @@ namespace Evex
 		// Cosntructs the operation "a?"
 		inline RegexChunkLooseEnds<T> OccurNoneOrOnce(RegexChunkLooseEnds<T>& chunk, CollapsePacket& CloneMaps, bool Lazy = false)
 		{
-			RegexNoneOrMoreNode<T>* NewNoneOrOnce = new RegexNoneOrMoreNode<T>(true, Lazy);
+			RegexNoneOrMoreNode<T>* NewNoneOrOnce = Arena.New<RegexNoneOrMoreNode<T>>(true, Lazy);
 	
 			return AssembleGroup(chunk, NewNoneOrOnce, CloneMaps);
 		}
@@ -455,7 +1028,7 @@ namespace Evex
 		// Constructs the operation "a*"
 		inline RegexChunkLooseEnds<T> OccurNonePlus(RegexChunkLooseEnds<T>& chunk, CollapsePacket& CloneMaps, bool Lazy = false)
 		{
-			RegexNoneOrMoreNode<T>* NewNonePlus = new RegexNoneOrMoreNode<T>(false, Lazy);
+			RegexNoneOrMoreNode<T>* NewNonePlus = Arena.New<RegexNoneOrMoreNode<T>>(false, Lazy);
 	
 			return AssembleGroup(chunk, NewNonePlus, CloneMaps);
 		}
@@ -463,33 +1036,156 @@ namespace Evex
 		// Constructs the operation "a+"
 		inline RegexChunkLooseEnds<T> OccurOncePlus(RegexChunkLooseEnds<T>& chunk, CollapsePacket& CloneMaps, bool Lazy = false)
 		{
-			RegexLoopNode<T>* NewLoop = new RegexLoopNode<T>(nullptr, Lazy);
+			RegexLoopNode<T>* NewLoop = Arena.New<RegexLoopNode<T>>(nullptr, Lazy);
 	
 			return AssembleGroup(chunk, NewLoop, CloneMaps);
 		}
 	
-		// Constructs an alternation ("a|b") in NFA(!) format. Must be collapsed later on during group assembly or DFA finalization.
+		/*
+			Constructs an alternation ("a|b") in NFA(!) format. Must be collapsed later on during group assembly or DFA finalization.
+			Both sides are consumed.
+		*/
 		inline RegexChunkLooseEnds<T> Alternate(RegexChunkLooseEnds<T>& lhs, RegexChunkLooseEnds<T>& rhs)
 		{
 			RegexChunkLooseEnds<T> Out;
-			Out.ChunksInvolved = lhs.ChunksInvolved;
-			Out.ChunksInvolved.insert(rhs.ChunksInvolved.begin(), rhs.ChunksInvolved.end());
+			Out.ChunksInvolved = TakeChunksInvolved(lhs, rhs);
 	
-			Out.Ins = lhs.Ins;
+			Out.Ins = std::move(lhs.Ins);
 			Out.Ins.insert(rhs.Ins.begin(), rhs.Ins.end());
 	
-			Out.Outs = lhs.Outs;
+			Out.Outs = std::move(lhs.Outs);
 			Out.Outs.insert(rhs.Outs.begin(), rhs.Outs.end());
 	
 			return Out;
 		}
 	
+		// Insides of the groups flipped so far, by the ghost they were entered through before being flipped.
+		using ReversedGroupMap = std::unordered_map<RegexNodeGhostIn<T>*, RegexChunkLooseEnds<T>>;
+	
+		/*
+			Flips every edge of the given graph in place, so that it reads its input from end to beginning, as a lookbehind does.
+			Groups within are flipped and set to match in reverse too, their insides collapsed as any group's would be.
+			Insides shared between several groups are flipped only once. The given graph is consumed.
+		*/
+		RegexChunkLooseEnds<T> Reverse(RegexChunkLooseEnds<T>& chunk, ReversedGroupMap& ReversedGroups, CollapsePacket& CloneMaps)
+		{
+			// Every node, and what leads into each, gathered before any edge is torn down.
+			std::vector<RegexNode<T>*> GraphNodes;
+			std::unordered_map<RegexNode<T>*, std::unordered_set<RegexNode<T>*>> Predecessors;
+			std::unordered_set<RegexNode<T>*> Starts, Ends;
+			{
+				std::unordered_set<RegexNode<T>*> Seen;
+				for (RegexNodeGhostIn<T>* currIn : chunk.Ins)
+				{
+					Starts.insert(currIn->Nexts.begin(), currIn->Nexts.end());
+					AppendUnique(GraphNodes, currIn->Nexts, Seen);
+				}
+	
+				for (size_t i = 0; i < GraphNodes.size(); ++i)
+				{
+					RegexNode<T>* currNode = GraphNodes[i];
+	
+					std::unordered_set<RegexNode<T>*> Successors = currNode->Nexts;
+					for (RegexNodeGhostOut<T>* currOut : currNode->GhostNexts)
+					{
+						if (chunk.Outs.find(currOut) != chunk.Outs.end())
+							Ends.insert(currNode);
+	
+						for (RegexNodeGhostIn<T>* currIn : currOut->GhostNexts)
+							Successors.insert(currIn->Nexts.begin(), currIn->Nexts.end());
+					}
+	
+					for (RegexNode<T>* currSuccessor : Successors)
+						Predecessors[currSuccessor].insert(currNode);
+	
+					AppendUnique(GraphNodes, Successors, Seen);
+				}
+			}
+	
+			RegexChunkLooseEnds<T> Out;
+	
+			RegexChunk<T>* NewChunk = Arena.New<RegexChunk<T>>();
+			Chunks.insert(NewChunk);
+			Out.ChunksInvolved.insert(NewChunk);
+	
+			// Ghosts are held by value, so there must be room for all of them before any is pointed to.
+			NewChunk->Ins.reserve(GraphNodes.size() + 1);
+			NewChunk->Outs.reserve(GraphNodes.size() + 1);
+	
+			// What used to end the graph now starts it, and vice versa.
+			NewChunk->Ins.push_back(RegexNodeGhostIn<T>());
+			NewChunk->Adopt(NewChunk->Ins.back(), 0);
+			NewChunk->Ins.back().Nexts = Ends;
+			Out.Ins.insert(&NewChunk->Ins.back());
+	
+			NewChunk->Outs.push_back(RegexNodeGhostOut<T>());
+			NewChunk->Adopt(NewChunk->Outs.back(), 0);
+			Out.Outs.insert(&NewChunk->Outs.back());
+	
+			for (RegexNode<T>* currNode : GraphNodes)
+			{
+				NewChunk->Nodes.push_back(currNode);
+				NewChunk->Adopt(*currNode, int(NewChunk->Nodes.size() - 1));
+	
+				currNode->Nexts.clear();
+				currNode->GhostNexts.clear();
+	
+				if (Starts.find(currNode) != Starts.end())
+					currNode->GhostNexts.insert(&NewChunk->Outs[0]);
+	
+				// Each node leads on to what used to lead into it, through a ghost pair as Collapse expects.
+				auto foundPredecessors = Predecessors.find(currNode);
+				if (foundPredecessors != Predecessors.end())
+				{
+					NewChunk->Ins.push_back(RegexNodeGhostIn<T>());
+					NewChunk->Adopt(NewChunk->Ins.back(), int(NewChunk->Ins.size() - 1));
+					NewChunk->Ins.back().Nexts = std::move(foundPredecessors->second);
+	
+					NewChunk->Outs.push_back(RegexNodeGhostOut<T>());
+					NewChunk->Adopt(NewChunk->Outs.back(), int(NewChunk->Outs.size() - 1));
+					NewChunk->Outs.back().GhostNexts.insert(&NewChunk->Ins.back());
+	
+					currNode->GhostNexts.insert(&NewChunk->Outs.back());
+				}
+	
+				RegexGroupNode<T>* AsGroup = RegexNodeCast<RegexGroupNode<T>>(currNode);
+				if (AsGroup && AsGroup->CanIterateReverse() && !AsGroup->Ins.empty())
+				{
+					RegexNodeGhostIn<T>* GroupEntry = *AsGroup->Ins.begin();
+	
+					auto foundGroup = ReversedGroups.find(GroupEntry);
+					if (foundGroup == ReversedGroups.end())
+					{
+						RegexChunkLooseEnds<T> Insides;
+						Insides.ChunksInvolved.insert(AsGroup->Chunks.begin(), AsGroup->Chunks.end());
+						Insides.Ins = AsGroup->Ins;
+						Insides.Outs = AsGroup->Outs;
+	
+						RegexChunkLooseEnds<T> ReversedInsides = Reverse(Insides, ReversedGroups, CloneMaps);
+						foundGroup = ReversedGroups.emplace(GroupEntry, Collapse(ReversedInsides, CloneMaps)).first;
+						PruneIntermediaryGhosts(foundGroup->second);
+					}
+	
+					AsGroup->Chunks.assign(foundGroup->second.ChunksInvolved.begin(), foundGroup->second.ChunksInvolved.end());
+					AsGroup->Ins = foundGroup->second.Ins;
+					AsGroup->Outs = foundGroup->second.Outs;
+					AsGroup->IterateReverse = true;
+				}
+			}
+	
+			// drop all the old chunks. Their memory stays with the arena until the regex is destroyed.
+			for (RegexChunk<T>* currToDrop : chunk.ChunksInvolved)
+				Chunks.erase(currToDrop);
+	
+			return Out;
+		}
+	
 		// Handles remapping of referential nodes to their proper references during a collapse.
 		void TryFitCloneMap(RegexNode<T>* Node, RegexNode<T>* PriorNode, CollapsePacket& CloneMaps)
 		{
-			if (RegexBackreferenceNode<T>* AsBack = dynamic_cast<RegexBackreferenceNode<T>*>(Node))
+			if (RegexBackreferenceNode<T>* AsBack = RegexNodeCast<RegexBackreferenceNode<T>>(Node))
 			{
-				RegexBackreferenceNode<T>* PriorAsBack = dynamic_cast<RegexBackreferenceNode<T>*>(PriorNode);
+				RegexBackreferenceNode<T>* PriorAsBack = RegexNodeCast<RegexBackreferenceNode<T>>(PriorNode);
 	
 				auto foundNumbered = CloneMaps.Backs_Numbered.find(PriorAsBack);
 	
@@ -509,9 +1205,9 @@ namespace Evex
 					}
 				}
 			}
-			else if (RegexSubroutineNode<T>* AsSub = dynamic_cast<RegexSubroutineNode<T>*>(Node))
+			else if (RegexSubroutineNode<T>* AsSub = RegexNodeCast<RegexSubroutineNode<T>>(Node))
 			{
-				RegexSubroutineNode<T>* PriorAsSub = dynamic_cast<RegexSubroutineNode<T>*>(PriorNode);
+				RegexSubroutineNode<T>* PriorAsSub = RegexNodeCast<RegexSubroutineNode<T>>(PriorNode);
 	
 				auto foundNumbered = CloneMaps.Subs_Numbered.find(PriorAsSub);
 	
@@ -531,14 +1227,14 @@ namespace Evex
 					}
 				}
 			}
-			else if (RegexRecursionNode<T>* AsRec = dynamic_cast<RegexRecursionNode<T>*>(Node))
+			else if (RegexRecursionNode<T>* AsRec = RegexNodeCast<RegexRecursionNode<T>>(Node))
 			{
 				CloneMaps.Recursions.insert(AsRec);
-				CloneMaps.Recursions.erase(dynamic_cast<RegexRecursionNode<T>*>(PriorNode));
+				CloneMaps.Recursions.erase(RegexNodeCast<RegexRecursionNode<T>>(PriorNode));
 			}
-			else if (RegexCaptureNode<T>* AsCap = dynamic_cast<RegexCaptureNode<T>*>(Node))
+			else if (RegexCaptureNode<T>* AsCap = RegexNodeCast<RegexCaptureNode<T>>(Node))
 			{
-				RegexCaptureNode<T>* PriorAsCap = dynamic_cast<RegexCaptureNode<T>*>(PriorNode);
+				RegexCaptureNode<T>* PriorAsCap = RegexNodeCast<RegexCaptureNode<T>>(PriorNode);
 	
 				auto foundNumbered = CloneMaps.Caps_Numbered.find(PriorAsCap);
 	
@@ -565,11 +1261,12 @@ namespace Evex
 		{
 			RegexChunkLooseEnds<T> Out;
 	
-			RegexChunk<T>* NewChunk = new RegexChunk<T>();
+			RegexChunk<T>* NewChunk = Arena.New<RegexChunk<T>>();
 			Chunks.insert(NewChunk);
 			Out.ChunksInvolved.insert(NewChunk);
 	
 			NewChunk->Ins.push_back(RegexNodeGhostIn<T>());
+			NewChunk->Adopt(NewChunk->Ins.back(), 0);
 	
 			for (RegexNodeGhostIn<T>* currIn : chunk.Ins)
 				NewChunk->Ins.back().Incorporate(currIn);
@@ -581,34 +1278,45 @@ namespace Evex
 				[&NewChunk, &InsToInds, this, &CloneMaps](std::unordered_set<int>& CurrentIns, std::unordered_set<int>& NextNodes)
 				{
 					NextNodes.clear();
-					std::unordered_set<int> SeggedNexts;
+	
+					// Nodes made so far from this ghost's nexts, by signature. Only those sharing one can be similar.
+					std::unordered_multimap<size_t, int> SeggedNexts;
 					for (const int& currInd : CurrentIns)
 					{
 						RegexNodeGhostIn<T>* curr = &NewChunk->Ins[currInd];
+						SeggedNexts.reserve(curr->Nexts.size());
 						for (RegexNode<T>* currNext : curr->Nexts)
 						{
 							int FoundInd = -1;
-							for (const int& currCollapseInd : SeggedNexts)
+							const size_t Signature = currNext->Signature();
+							if (0 != Signature)
 							{
-								if (currNext->SimilarTo(NewChunk->Nodes[currCollapseInd]))
+								auto Candidates = SeggedNexts.equal_range(Signature);
+								for (auto currCandidate = Candidates.first; currCandidate != Candidates.second; ++currCandidate)
 								{
-									FoundInd = currCollapseInd;
-									break;
+									if (currNext->SimilarTo(NewChunk->Nodes[currCandidate->second]))
+									{
+										FoundInd = currCandidate->second;
+										break;
+									}
 								}
 							}
 	
 							if (FoundInd < 0)
 							{
-								NewChunk->Nodes.push_back(currNext->Clone());
+								NewChunk->Nodes.push_back(currNext->Clone(Arena));
 								TryFitCloneMap(NewChunk->Nodes.back(), currNext, CloneMaps);
-								FoundInd = NewChunk->Nodes.back()->Index = NewChunk->Nodes.size() - 1;
+								FoundInd = int(NewChunk->Nodes.size() - 1);
+								NewChunk->Adopt(*NewChunk->Nodes.back(), FoundInd);
+	
+								if (0 != Signature)
+									SeggedNexts.emplace(Signature, FoundInd);
 							}
 	
 							NewChunk->Nodes[FoundInd]->Incorporate(currNext);
 
 							InsToInds[currInd].insert(FoundInd);
 							NextNodes.insert(FoundInd);
-							SeggedNexts.insert(FoundInd);
 						}
 						curr->Nexts.clear();
 						SeggedNexts.clear();
@@ -633,7 +1341,8 @@ namespace Evex
 								if (EndInd < 0)
 								{
 									NewChunk->Outs.push_back(RegexNodeGhostOut<T>());
-									EndInd = NewChunk->Outs.back().Index = NewChunk->Outs.size() - 1;
+									EndInd = int(NewChunk->Outs.size() - 1);
+									NewChunk->Adopt(NewChunk->Outs.back(), EndInd);
 								}
 	
 								FoundInd = EndInd;
@@ -643,7 +1352,8 @@ namespace Evex
 								if (ConstructedInd < 0)
 								{
 									NewChunk->Outs.push_back(RegexNodeGhostOut<T>());
-									ConstructedInd = NewChunk->Outs.back().Index = NewChunk->Outs.size() - 1;
+									ConstructedInd = int(NewChunk->Outs.size() - 1);
+									NewChunk->Adopt(NewChunk->Outs.back(), ConstructedInd);
 								}
 	
 								FoundInd = ConstructedInd;
@@ -676,7 +1386,8 @@ namespace Evex
 							if (ConstructedInd < 0)
 							{
 								NewChunk->Ins.push_back(RegexNodeGhostIn<T>());
-								ConstructedInd = NewChunk->Ins.back().Index = NewChunk->Ins.size() - 1;
+								ConstructedInd = int(NewChunk->Ins.size() - 1);
+								NewChunk->Adopt(NewChunk->Ins.back(), ConstructedInd);
 							}
 	
 							FoundInd = ConstructedInd;
@@ -725,12 +1436,9 @@ namespace Evex
 			Out.Ins.insert(&NewChunk->Ins[0]);
 			Out.Outs.insert(&NewChunk->Outs[EndInd]);
 	
-			// delete all the old chunks
-			for (RegexChunk<T>* currToDel : chunk.ChunksInvolved)
-			{
-				Chunks.erase(Chunks.find(currToDel));
-				delete currToDel;
-			}
+			// drop all the old chunks. Their memory stays with the arena until the regex is destroyed.
+			for (RegexChunk<T>* currToDrop : chunk.ChunksInvolved)
+				Chunks.erase(Chunks.find(currToDrop));
 	
 			return Out;
 		}
@@ -741,9 +1449,9 @@ namespace Evex
 			if (Times < 2)
 				return chunk;
 	
-			Tickers.push_back(RegexTicker<T>(Times));
+			Tickers.push_back(RegexTicker<T>(Times, int(Tickers.size())));
 	
-			RegexLoopNode<T>* NewLoop = new RegexLoopNode<T>(&Tickers.back(), Lazy);
+			RegexLoopNode<T>* NewLoop = Arena.New<RegexLoopNode<T>>(&Tickers.back(), Lazy);
 	
 			return AssembleGroup(chunk, NewLoop, CloneMaps);
 		}
@@ -754,10 +1462,10 @@ namespace Evex
 			if (MinTimes < 2)
 				return OccurOncePlus(chunk, CloneMaps);
 	
-			Tickers.push_back(RegexTicker<T>(MinTimes - 1));
+			Tickers.push_back(RegexTicker<T>(MinTimes - 1, int(Tickers.size())));
 	
-			RegexLoopNode<T>* NewLoopA = new RegexLoopNode<T>(&Tickers.back());
-			RegexLoopNode<T>* NewLoopB = new RegexLoopNode<T>(nullptr, Lazy);
+			RegexLoopNode<T>* NewLoopA = Arena.New<RegexLoopNode<T>>(&Tickers.back());
+			RegexLoopNode<T>* NewLoopB = Arena.New<RegexLoopNode<T>>(nullptr, Lazy);
 	
 			std::vector<RegexChunkLooseEnds<T>> Sides = AssembleGroups(chunk, { NewLoopA, NewLoopB }, CloneMaps);
 	
@@ -774,11 +1482,11 @@ namespace Evex
 			if (MinTimes == MaxTimes)
 				return RepeatExact(chunk, MinTimes, CloneMaps);
 	
-			Tickers.push_back(RegexTicker<T>(MinTimes - 1));
-			Tickers.push_back(RegexTicker<T>((MinTimes - 1) - MaxTimes));
+			Tickers.push_back(RegexTicker<T>(MinTimes - 1, int(Tickers.size())));
+			Tickers.push_back(RegexTicker<T>((MinTimes - 1) - MaxTimes, int(Tickers.size())));
 	
-			RegexLoopNode<T>* NewLoopA = new RegexLoopNode<T>(&(*(Tickers.end() - 2)));
-			RegexLoopNode<T>* NewLoopB = new RegexLoopNode<T>(&Tickers.back(), Lazy);
+			RegexLoopNode<T>* NewLoopA = Arena.New<RegexLoopNode<T>>(&(*(Tickers.end() - 2)));
+			RegexLoopNode<T>* NewLoopB = Arena.New<RegexLoopNode<T>>(&Tickers.back(), Lazy);
 	
 			std::vector<RegexChunkLooseEnds<T>> Sides = AssembleGroups(chunk, { NewLoopA, NewLoopB }, CloneMaps);
 	
@@ -787,138 +1495,181 @@ namespace Evex
 
 	public:
 
-		// Retrieves a numbered capture. NOTE: Indices offset by 1! i.e. "\\1" or "\\k<1>" -> Captures[0]
-		inline bool GetCapture(int Index, std::basic_string<T>& OutCapture, bool& OutCaptureSuccess)
+		// Retrieves a numbered capture, as left by the last match made through the given context. NOTE: Indices offset by 1! i.e. "\\1" or "\\k<1>" -> Captures[0]
+		// Captures taken from the input point into it rather than holding copies, so it must still be alive to retrieve them, here and below.
+		inline bool GetCapture(const RegexMatchContext<T>& MatchContext, int Index, std::basic_string<T>& OutCapture, bool& OutCaptureSuccess) const
 		{
-			if (Index < 1 || Index > (int)Captures.size())
+			if (Index < 1 || Index > (int)Captures.size() || MatchContext.Program != this)
 				return false;
 	
-			RegexCapture<T>* Retrieved = dynamic_cast<RegexCapture<T>*>(Captures[Index - 1]);
+			const RegexCapture<T>* Retrieved = (Captures[Index - 1]->IsCollection ? nullptr : static_cast<const RegexCapture<T>*>(Captures[Index - 1]));
 	
 			if (Retrieved)
 			{
-				OutCapture = Retrieved->CapturedInputs;
-				OutCaptureSuccess = Retrieved->Succeeded;
+				OutCapture = Retrieved->GetCapture(MatchContext);
+				OutCaptureSuccess = Retrieved->GetState(MatchContext).Succeeded;
 				return true;
 			}
 	
 			return false;
 		}
 
-		// Retrieves a numbered capture collection. NOTE: Indices offset by 1! i.e. "\\1" or "\\k<1> -> Captures[0]
-		inline bool GetCaptureCollection(int Index, std::vector<std::basic_string<T>>& OutCaptures, bool& OutCaptureSuccess)
+		// Retrieves a numbered capture collection, as left by the last match made through the given context. NOTE: Indices offset by 1! i.e. "\\1" or "\\k<1> -> Captures[0]
+		inline bool GetCaptureCollection(const RegexMatchContext<T>& MatchContext, int Index, std::vector<std::basic_string<T>>& OutCaptures, bool& OutCaptureSuccess) const
 		{
-			if (Index < 1 || Index > Captures.size())
+			if (Index < 1 || Index > (int)Captures.size() || MatchContext.Program != this)
 				return false;
 	
-			RegexCaptureCollection<T>* Retrieved = dynamic_cast<RegexCaptureCollection<T>*>(Captures[Index - 1]);
+			const RegexCaptureCollection<T>* Retrieved = (Captures[Index - 1]->IsCollection ? static_cast<const RegexCaptureCollection<T>*>(Captures[Index - 1]) : nullptr);
 	
 			if (Retrieved)
 			{
-				OutCaptures = Retrieved->CapturedInputs;
-				OutCaptureSuccess = Retrieved->Succeeded;
+				OutCaptures.clear();
+				for (auto& currRange : Retrieved->GetState(MatchContext).Ranges)
+					OutCaptures.emplace_back(currRange.first, currRange.second);
+				OutCaptureSuccess = Retrieved->GetState(MatchContext).Succeeded;
 				return true;
 			}
 	
 			return false;
 		}
 
-		// Retrieves a named capture, i.e. "\\g<Name>" -> NamesToCaptures[Name]
-		inline bool GetCapture(std::basic_string<T> Name, std::basic_string<T>& OutCapture, bool& OutCaptureSuccess)
+		// Retrieves a named capture, as left by the last match made through the given context, i.e. "\\g<Name>" -> NamesToCaptures[Name]
+		inline bool GetCapture(const RegexMatchContext<T>& MatchContext, std::basic_string<T> Name, std::basic_string<T>& OutCapture, bool& OutCaptureSuccess) const
 		{
 			auto found = NamesToCaptures.find(Name);
 	
-			if (found == NamesToCaptures.end())
+			if (found == NamesToCaptures.end() || MatchContext.Program != this)
 				return false;
 	
-			RegexCapture<T>* Retrieved = dynamic_cast<RegexCapture<T>*>(found->second);
+			const RegexCapture<T>* Retrieved = (found->second->IsCollection ? nullptr : static_cast<const RegexCapture<T>*>(found->second));
 	
 			if (Retrieved)
 			{
-				OutCapture = Retrieved->CapturedInputs;
-				OutCaptureSuccess = Retrieved->Succeeded;
+				OutCapture = Retrieved->GetCapture(MatchContext);
+				OutCaptureSuccess = Retrieved->GetState(MatchContext).Succeeded;
 				return true;
 			}
 	
 			return false;
 		}
 
-		// Retrieves a named capture collection, i.e. "\\g<Name>" -> NamesToCaptures[Name]
-		inline bool GetCaptureCollection(std::basic_string<T> Name, std::vector<std::basic_string<T>>& OutCaptures, bool& OutCaptureSuccess)
+		// Retrieves a named capture collection, as left by the last match made through the given context, i.e. "\\g<Name>" -> NamesToCaptures[Name]
+		inline bool GetCaptureCollection(const RegexMatchContext<T>& MatchContext, std::basic_string<T> Name, std::vector<std::basic_string<T>>& OutCaptures, bool& OutCaptureSuccess) const
 		{
 			auto found = NamesToCaptures.find(Name);
 	
-			if (found == NamesToCaptures.end())
+			if (found == NamesToCaptures.end() || MatchContext.Program != this)
 				return false;
 	
-			RegexCaptureCollection<T>* Retrieved = dynamic_cast<RegexCaptureCollection<T>*>(found->second);
+			const RegexCaptureCollection<T>* Retrieved = (found->second->IsCollection ? static_cast<const RegexCaptureCollection<T>*>(found->second) : nullptr);
 	
 			if (Retrieved)
 			{
-				OutCaptures = Retrieved->CapturedInputs;
-				OutCaptureSuccess = Retrieved->Succeeded;
+				OutCaptures.clear();
+				for (auto& currRange : Retrieved->GetState(MatchContext).Ranges)
+					OutCaptures.emplace_back(currRange.first, currRange.second);
+				OutCaptureSuccess = Retrieved->GetState(MatchContext).Succeeded;
 				return true;
 			}
 	
 			return false;
 		}
+
+		// Retrieves a numbered capture. NOTE: Indices offset by 1! i.e. "\\1" or "\\k<1>" -> Captures[0]
+		inline bool GetCapture(int Index, std::basic_string<T>& OutCapture, bool& OutCaptureSuccess) const { return GetCapture(DefaultContext, Index, OutCapture, OutCaptureSuccess); }
+
+		// Retrieves a numbered capture collection. NOTE: Indices offset by 1! i.e. "\\1" or "\\k<1> -> Captures[0]
+		inline bool GetCaptureCollection(int Index, std::vector<std::basic_string<T>>& OutCaptures, bool& OutCaptureSuccess) const { return GetCaptureCollection(DefaultContext, Index, OutCaptures, OutCaptureSuccess); }
+
+		// Retrieves a named capture, i.e. "\\g<Name>" -> NamesToCaptures[Name]
+		inline bool GetCapture(std::basic_string<T> Name, std::basic_string<T>& OutCapture, bool& OutCaptureSuccess) const { return GetCapture(DefaultContext, Name, OutCapture, OutCaptureSuccess); }
+
+		// Retrieves a named capture collection, i.e. "\\g<Name>" -> NamesToCaptures[Name]
+		inline bool GetCaptureCollection(std::basic_string<T> Name, std::vector<std::basic_string<T>>& OutCaptures, bool& OutCaptureSuccess) const { return GetCaptureCollection(DefaultContext, Name, OutCaptures, OutCaptureSuccess); }
 	
-		// Pre-sets numbered captures. NOTE: Indices start at 1 for easier readability! i.e. 'index' 1 sets capture \1.
-		inline void PreSetCaptures(const std::vector<std::pair<int, std::basic_string<T>>>& IndicesAndValues)
+		// Pre-sets numbered captures within the given context. NOTE: Indices start at 1 for easier readability! i.e. 'index' 1 sets capture \1.
+		inline void PreSetCaptures(RegexMatchContext<T>& MatchContext, const std::vector<std::pair<int, std::basic_string<T>>>& IndicesAndValues) const
 		{
+			if (!IsValidForMatching())
+				return;
+
+			PrepareContext(MatchContext);
+
 			for (auto& currPair : IndicesAndValues)
 			{
 				if (currPair.first >= 1 && currPair.first <= int(Captures.size()))
-					Captures[currPair.first - 1]->SetCapture(currPair.second, true);
+					Captures[currPair.first - 1]->SetCapture(MatchContext, currPair.second, true);
 			}
 		}
 	
-		// Pre-sets named captures.
-		inline void PreSetCaptures(const std::vector<std::pair<std::basic_string<T>,std::basic_string<T>>>& NamesAndValues)
+		// Pre-sets named captures within the given context.
+		inline void PreSetCaptures(RegexMatchContext<T>& MatchContext, const std::vector<std::pair<std::basic_string<T>,std::basic_string<T>>>& NamesAndValues) const
 		{
+			if (!IsValidForMatching())
+				return;
+
+			PrepareContext(MatchContext);
+
 			for (auto& currPair : NamesAndValues)
 			{
 				auto found = NamesToCaptures.find(currPair.first);
 	
 				if (found != NamesToCaptures.end())
-					found->second->SetCapture(currPair.second, true);
+					found->second->SetCapture(MatchContext, currPair.second, true);
 			}
 		}
 	
-		// Resets numbered captures. NOTE: Indices start at 1 for easier readability! i.e. 'index' 1 sets capture \1.
-		inline void PreResetCaptures(const std::vector<int>& CaptureIndices)
+		// Resets numbered captures within the given context. NOTE: Indices start at 1 for easier readability! i.e. 'index' 1 sets capture \1.
+		inline void PreResetCaptures(RegexMatchContext<T>& MatchContext, const std::vector<int>& CaptureIndices) const
 		{
-			for (int& currInd : CaptureIndices)
+			if (!IsValidForMatching())
+				return;
+
+			PrepareContext(MatchContext);
+
+			for (const int& currInd : CaptureIndices)
 			{
 				if (currInd >= 1 && currInd <= int(Captures.size()))
-					Captures[currInd - 1]->Reset();
+					Captures[currInd - 1]->Reset(MatchContext);
 			}
 		}
 	
-		// Resets named captures.
-		inline void PreResetCaptures(const std::vector<std::basic_string<T>>& CaptureNames)
+		// Resets named captures within the given context.
+		inline void PreResetCaptures(RegexMatchContext<T>& MatchContext, const std::vector<std::basic_string<T>>& CaptureNames) const
 		{
-			for (std::basic_string<T>& currName : IndicesAndValues)
+			if (!IsValidForMatching())
+				return;
+
+			PrepareContext(MatchContext);
+
+			for (const std::basic_string<T>& currName : CaptureNames)
 			{
 				auto found = NamesToCaptures.find(currName);
 	
 				if (found != NamesToCaptures.end())
-					found->second->Reset();
+					found->second->Reset(MatchContext);
 			}
 		}
 	
+		// Pre-sets numbered captures. NOTE: Indices start at 1 for easier readability! i.e. 'index' 1 sets capture \1.
+		inline void PreSetCaptures(const std::vector<std::pair<int, std::basic_string<T>>>& IndicesAndValues) { PreSetCaptures(DefaultContext, IndicesAndValues); }
+	
+		// Pre-sets named captures.
+		inline void PreSetCaptures(const std::vector<std::pair<std::basic_string<T>,std::basic_string<T>>>& NamesAndValues) { PreSetCaptures(DefaultContext, NamesAndValues); }
+	
+		// Resets numbered captures. NOTE: Indices start at 1 for easier readability! i.e. 'index' 1 sets capture \1.
+		inline void PreResetCaptures(const std::vector<int>& CaptureIndices) { PreResetCaptures(DefaultContext, CaptureIndices); }
+	
+		// Resets named captures.
+		inline void PreResetCaptures(const std::vector<std::basic_string<T>>& CaptureNames) { PreResetCaptures(DefaultContext, CaptureNames); }
+	
 	private:
 	
-		// Gets the chunk within which a node resides
+		// Gets the chunk within which a node resides, or null if that chunk has since been dropped.
 		RegexChunk<T>* GetChunkOfNode(const RegexNodeBase<T>* Node)
 		{
-			for (RegexChunk<T>* CurrChunk : Chunks)
-			{
-				if (CurrChunk->ContainsNode(Node))
-					return CurrChunk;
-			}
-	
-			return nullptr;
+			return (Chunks.find(Node->Owner) != Chunks.end() ? Node->Owner : nullptr);
 		}
 	
 		// Reroutes around unnecessary ghosts, i.e. ones that don't signify an end or start, in order to boost performance.
@@ -965,6 +1716,507 @@ namespace Evex
 	
 			return;
 		}
+
+		// Appends any nodes from the given set which aren't already present in the given list.
+		static void AppendUnique(std::vector<RegexNode<T>*>& List, std::unordered_set<RegexNode<T>*>& ToAppend, std::unordered_set<RegexNode<T>*>& Seen)
+		{
+			for (RegexNode<T>* curr : ToAppend)
+			{
+				if (Seen.insert(curr).second)
+					List.push_back(curr);
+			}
+		}
+
+		/*
+			Lowers the finished (collapsed and pruned) node graph into StateTable.
+			States are numbered breadth-first from the regex's entry nodes, and every group
+			node is handed the table along with the context its insides are matched in.
+		*/
+		void BuildStateTable()
+		{
+			StateTable.Clear();
+
+			std::unordered_map<RegexNode<T>*, int> StateIds;
+			std::unordered_map<RegexNodeGhostOut<T>*, int> ExitIds;
+
+			auto GetState =
+				[this, &StateIds](RegexNode<T>* Node)
+				{
+					auto found = StateIds.find(Node);
+					if (found != StateIds.end())
+						return found->second;
+
+					int NewState = StateIds[Node] = StateTable.StateCount();
+					StateTable.States.push_back(Node);
+					Node->StateIndex = NewState;
+					return NewState;
+				};
+
+			auto GetExit =
+				[&ExitIds](RegexNodeGhostOut<T>* Out)
+				{
+					auto found = ExitIds.find(Out);
+					if (found != ExitIds.end())
+						return found->second;
+
+					int NewExit = int(ExitIds.size());
+					ExitIds[Out] = NewExit;
+					return NewExit;
+				};
+
+			auto AddContext =
+				[this, &GetState, &GetExit](std::unordered_set<RegexNodeGhostIn<T>*>& Ins, std::unordered_set<RegexNodeGhostOut<T>*>& Outs)
+				{
+					std::vector<RegexNode<T>*> Entries;
+					std::unordered_set<RegexNode<T>*> Seen;
+					for (RegexNodeGhostIn<T>* currIn : Ins)
+						AppendUnique(Entries, currIn->Nexts, Seen);
+
+					int NewContext = StateTable.ContextCount();
+
+					for (RegexNode<T>* currEntry : Entries)
+						StateTable.ContextEntries.push_back(GetState(currEntry));
+					StateTable.ContextEntryStarts.push_back(StateTable.ContextEntries.size());
+
+					for (RegexNodeGhostOut<T>* currOut : Outs)
+						StateTable.ContextExits.push_back(GetExit(currOut));
+					StateTable.ContextExitStarts.push_back(StateTable.ContextExits.size());
+
+					return NewContext;
+				};
+
+			auto AddChunkContext =
+				[&AddContext](RegexChunk<T>* Chunk)
+				{
+					std::unordered_set<RegexNodeGhostIn<T>*> ChunkIns;
+					std::unordered_set<RegexNodeGhostOut<T>*> ChunkOuts;
+					for (RegexNodeGhostIn<T>& currIn : Chunk->Ins) ChunkIns.insert(&currIn);
+					for (RegexNodeGhostOut<T>& currOut : Chunk->Outs) ChunkOuts.insert(&currOut);
+					return AddContext(ChunkIns, ChunkOuts);
+				};
+
+			// Context 0 is always the regex as a whole.
+			AddContext(StartNodes, EndNodes);
+
+			// Subroutines may call into captures that are otherwise unreachable.
+			for (RegexCaptureBase<T>* currCap : Captures)
+			{
+				if (currCap->InitialCapture)
+					GetState(currCap->InitialCapture);
+			}
+
+			for (RegexCaptureBase<T>* currSub : DefinedSubroutines)
+			{
+				if (currSub->InitialCapture)
+					GetState(currSub->InitialCapture);
+			}
+
+			for (int currState = 0; currState < StateTable.StateCount(); ++currState)
+			{
+				RegexNode<T>* Node = StateTable.States[currState];
+
+				std::vector<RegexNode<T>*> Successors;
+				{
+					std::unordered_set<RegexNode<T>*> Seen;
+					AppendUnique(Successors, Node->Nexts, Seen);
+					for (RegexNodeGhostOut<T>* currGhostNext : Node->GhostNexts)
+					{
+						for (RegexNodeGhostIn<T>* currThrough : currGhostNext->GhostNexts)
+							AppendUnique(Successors, currThrough->Nexts, Seen);
+					}
+				}
+
+				bool SelfLoop = false, SelfFirst = false;
+				RegexTicker<T>* LoopTicker = nullptr, *GateTicker = nullptr;
+
+				if (RegexLoopNode<T>* AsLoop = RegexNodeCast<RegexLoopNode<T>>(Node))
+				{
+					SelfLoop = true;
+					SelfFirst = !AsLoop->Lazy;
+					LoopTicker = AsLoop->BoundTicker;
+
+					if (LoopTicker && LoopTicker->IsMandatory())
+						GateTicker = LoopTicker;
+				}
+				else if (RegexNoneOrMoreNode<T>* AsNoneOrMore = RegexNodeCast<RegexNoneOrMoreNode<T>>(Node))
+				{
+					SelfLoop = !AsNoneOrMore->OnceOnly;
+					SelfFirst = !AsNoneOrMore->Lazy;
+				}
+
+				if (SelfLoop && SelfFirst)
+					StateTable.Edges.push_back(currState);
+				for (RegexNode<T>* currSuccessor : Successors)
+					StateTable.Edges.push_back(GetState(currSuccessor));
+				if (SelfLoop && !SelfFirst)
+					StateTable.Edges.push_back(currState);
+				StateTable.EdgeStarts.push_back(StateTable.Edges.size());
+
+				for (RegexNodeGhostOut<T>* currGhostNext : Node->GhostNexts)
+					StateTable.Exits.push_back(GetExit(currGhostNext));
+				StateTable.ExitStarts.push_back(StateTable.Exits.size());
+
+				StateTable.LoopTickers.push_back(LoopTicker);
+				StateTable.GateTickers.push_back(GateTicker);
+				StateTable.Selves.push_back(currState);
+
+				if (RegexConditionalNode<T>* AsConditional = RegexNodeCast<RegexConditionalNode<T>>(Node))
+				{
+					AsConditional->Table = &StateTable;
+					AsConditional->CondContext = AddChunkContext(AsConditional->Cond);
+					AsConditional->TrueContext = AddChunkContext(AsConditional->IfTrue);
+					if (AsConditional->IfFalse)
+						AsConditional->FalseContext = AddChunkContext(AsConditional->IfFalse);
+				}
+				else if (RegexGroupNode<T>* AsGroup = RegexNodeCast<RegexGroupNode<T>>(Node))
+				{
+					AsGroup->Table = &StateTable;
+					AsGroup->Context = AddContext(AsGroup->Ins, AsGroup->Outs);
+				}
+			}
+
+			StateTable.BuildAcceptance();
+	
+			// Give everything that keeps per-match state its place within a match context.
+			DepthSlotCount = 0;
+			CanMatchInParallel = true;
+			for (RegexNode<T>* currState : StateTable.States)
+			{
+				switch (currState->Kind)
+				{
+				case RegexNodeKind::Recursion:
+					static_cast<RegexRecursionNode<T>*>(currState)->DepthSlot = DepthSlotCount++;
+					break;
+	
+				case RegexNodeKind::Subroutine:
+					static_cast<RegexSubroutineNode<T>*>(currState)->DepthSlot = DepthSlotCount++;
+					break;
+	
+				case RegexNodeKind::AtBeginning:
+					CanMatchInParallel = CanMatchInParallel && !static_cast<RegexAtBeginningNode<T>*>(currState)->AtLastMatchEnd;
+					break;
+	
+				case RegexNodeKind::CodeHook:
+					CanMatchInParallel = false;
+					break;
+	
+				default:
+					break;
+				}
+			}
+
+			for (unsigned int i = 0; i < Captures.size(); ++i)
+				Captures[i]->Slot = int(i);
+
+			for (unsigned int i = 0; i < DefinedSubroutines.size(); ++i)
+				DefinedSubroutines[i]->Slot = int(Captures.size() + i);
+
+			// Classes are stored after any classes they're made from, so operands are always built first.
+			for (RegexCharacterClassBase<T>* currCharClass : CharacterClasses)
+				currCharClass->BuildBitmap();
+
+			for (RegexNode<T>* currState : StateTable.States)
+				currState->BuildBitmap();
+
+			BuildDfaCache();
+			BuildPrefilter();
+			BuildBitParallel();
+
+			NamesToGroups.clear();
+			for (auto& currName : NamesToCaptures)
+			{
+				auto found = std::find(Captures.begin(), Captures.end(), currName.second);
+				if (found != Captures.end())
+					NamesToGroups[currName.first] = int(found - Captures.begin()) + 1;
+			}
+		}
+
+		// A plain node's CanEnter only ever tests the current character against its bitmap.
+		static bool IsDfaCandidate(RegexNode<T>* Node)
+		{
+			return Node->HasBitmap && RegexNodeKind::Node == Node->Kind;
+		}
+
+		// Flags which frontiers of StateTable can have their transitions cached.
+		void BuildDfaCache()
+		{
+			std::vector<bool> Eligible(StateTable.StateCount() + 1, false);
+
+			auto AllCandidates =
+				[](const int* Begin, const int* End, const std::vector<RegexNode<T>*>& States)
+				{
+					for (const int* curr = Begin; curr != End; ++curr)
+					{
+						if (!IsDfaCandidate(States[*curr]))
+							return false;
+					}
+					return true;
+				};
+
+			const int* Begin = nullptr, *End = nullptr;
+			StateTable.GetEntries(0, Begin, End);
+			Eligible[0] = AllCandidates(Begin, End, StateTable.States);
+
+			for (int currState = 0; currState < StateTable.StateCount(); ++currState)
+			{
+				if (StateTable.GateTickers[currState])
+					continue;
+
+				Begin = StateTable.Edges.data() + StateTable.EdgeStarts[currState];
+				End = StateTable.Edges.data() + StateTable.EdgeStarts[currState + 1];
+				Eligible[currState + 1] = AllCandidates(Begin, End, StateTable.States);
+			}
+
+			AllFrontiersPlain = !StartsWithLineCheck && !EndsWithLineCheck;
+			for (bool currEligible : Eligible)
+				AllFrontiersPlain = AllFrontiersPlain && currEligible;
+
+			DfaEligible.swap(Eligible);
+		}
+
+		/*
+			Fills Prefilter from the start of StateTable.
+			The first-byte set needs every entry to be a plain node. The literal then follows lone plain
+			successors for as long as each takes exactly one byte and none of them can end the match.
+		*/
+		void BuildPrefilter()
+		{
+			Prefilter.Clear();
+
+			const int* Begin = nullptr, *End = nullptr;
+			StateTable.GetEntries(0, Begin, End);
+			if (Begin == End)
+				return;
+
+			for (const int* currEntry = Begin; currEntry != End; ++currEntry)
+			{
+				RegexNode<T>* Entry = StateTable.States[*currEntry];
+				if (!IsDfaCandidate(Entry))
+					return;
+
+				Prefilter.FirstBytes.Unite(Entry->Bitmap);
+			}
+			Prefilter.HasFirstBytes = !Prefilter.FirstBytes.IsFull();
+
+			const size_t MaxLiteralLength = 64;
+			while (Begin + 1 == End && Prefilter.Literal.size() < MaxLiteralLength)
+			{
+				RegexNode<T>* Node = StateTable.States[*Begin];
+				if (!IsDfaCandidate(Node))
+					break;
+
+				// The end of the input reads as a null character, so a null can't be required.
+				int OnlyByte = Node->Bitmap.SingleByte();
+				if (OnlyByte <= 0)
+					break;
+
+				Prefilter.Literal += T(OnlyByte);
+
+				if (StateTable.IsAccepting(*Begin, 0))
+					break;
+
+				// Plain nodes are never gated, so their successors are always the full edge list.
+				const int State = *Begin;
+				Begin = StateTable.Edges.data() + StateTable.EdgeStarts[State];
+				End = StateTable.Edges.data() + StateTable.EdgeStarts[State + 1];
+			}
+		}
+
+		/*
+			Fills BitParallel from StateTable, if every state reachable from its start is either a plain node or a loop
+			whose body is a single plain node, with at most BitParallel's maximum positions between them, and every
+			frontier's candidates take disjoint bytes. Nothing else is allowed in, as nothing else can be stepped a byte at a time.
+			Outside of loops the top level can't cycle, so each counted loop is entered once per walk and its ticker counts
+			up from nothing, as does the position expanded from it.
+		*/
+		void BuildBitParallel()
+		{
+			using MaskType = typename RegexBitParallel<T>::MaskType;
+
+			BitParallel.Clear();
+
+			if (sizeof(T) != 1 || StartsWithLineCheck || EndsWithLineCheck || !Captures.empty() || !DefinedSubroutines.empty())
+				return;
+
+			const int StateCount = StateTable.StateCount();
+
+			// The bytes each reachable state takes, and how many times in a row it can be entered (or 0 if without limit).
+			std::vector<const RegexByteBitmap*> StateBytes(StateCount, nullptr);
+			std::vector<int> Repeats(StateCount, 0);
+			std::vector<int> FirstPositions(StateCount, -1);
+			std::unordered_set<const RegexTicker<T>*> SeenTickers;
+
+			int PositionCount = 0;
+			std::vector<int> ToVisit;
+
+			const int* Begin = nullptr, *End = nullptr;
+			StateTable.GetEntries(0, Begin, End);
+			ToVisit.assign(Begin, End);
+
+			while (!ToVisit.empty())
+			{
+				const int State = ToVisit.back();
+				ToVisit.pop_back();
+
+				if (FirstPositions[State] >= 0 || StateBytes[State])
+					continue;
+
+				RegexNode<T>* Node = StateTable.States[State];
+				int StatePositions = 1;
+
+				if (IsDfaCandidate(Node))
+				{
+					StateBytes[State] = &Node->Bitmap;
+					Repeats[State] = 1;
+				}
+				else if (RegexLoopNode<T>* AsLoop = RegexNodeCast<RegexLoopNode<T>>(Node))
+				{
+					StateTable.GetEntries(AsLoop->Context, Begin, End);
+					if (Begin + 1 != End)
+						return;
+
+					const int Body = *Begin;
+					if (!IsDfaCandidate(StateTable.States[Body]) || StateTable.EdgeStarts[Body] != StateTable.EdgeStarts[Body + 1] || !StateTable.IsAccepting(Body, AsLoop->Context))
+						return;
+
+					StateBytes[State] = &StateTable.States[Body]->Bitmap;
+
+					if (AsLoop->BoundTicker)
+					{
+						// Tickers shared between clones would carry counts from one state over to another.
+						if (!SeenTickers.insert(AsLoop->BoundTicker).second)
+							return;
+
+						Repeats[State] = std::abs(AsLoop->BoundTicker->MaxTimes);
+						StatePositions = Repeats[State];
+					}
+				}
+				else
+					return;
+
+				FirstPositions[State] = PositionCount;
+				PositionCount += StatePositions;
+				if (PositionCount > RegexBitParallel<T>::MaxPositions)
+					return;
+
+				for (unsigned int i = StateTable.EdgeStarts[State]; i < StateTable.EdgeStarts[State + 1]; ++i)
+					ToVisit.push_back(StateTable.Edges[i]);
+			}
+
+			std::vector<MaskType> FollowMasks(PositionCount, 0);
+			BitParallel.PositionStates.assign(PositionCount, -1);
+
+			// Adds the position entered on a state to a frontier, failing if it shares a byte with an earlier candidate.
+			auto AddCandidate =
+				[&StateBytes](int State, int Position, MaskType& Frontier, RegexByteBitmap& FrontierBytes)
+				{
+					if (FrontierBytes.Overlaps(*StateBytes[State]))
+						return false;
+
+					FrontierBytes.Unite(*StateBytes[State]);
+					Frontier |= MaskType(1) << Position;
+					return true;
+				};
+
+			StateTable.GetEntries(0, Begin, End);
+			RegexByteBitmap InitialBytes;
+			for (const int* currEntry = Begin; currEntry != End; ++currEntry)
+			{
+				// Counted loops with no times left can never be entered.
+				if (0 == Repeats[*currEntry] && StateTable.LoopTickers[*currEntry])
+					continue;
+
+				if (!AddCandidate(*currEntry, FirstPositions[*currEntry], BitParallel.Initial, InitialBytes))
+					return;
+			}
+
+			for (int currState = 0; currState < StateCount; ++currState)
+			{
+				if (nullptr == StateBytes[currState])
+					continue;
+
+				const bool Counted = (nullptr != StateTable.LoopTickers[currState]);
+				const int Times = (Counted ? Repeats[currState] : 1);
+
+				for (int currTime = 0; currTime < Times; ++currTime)
+				{
+					const int Position = FirstPositions[currState] + currTime;
+					BitParallel.PositionStates[Position] = currState;
+	
+					// Entering the state again moves on to its next time, if it has any left.
+					const bool Exhausted = Counted && currTime + 1 >= Times;
+					const int Again = (Counted ? Position + 1 : Position);
+	
+					// A gated loop only ends in a match once it's gone through all its times.
+					if (StateTable.IsAccepting(currState, 0) && (nullptr == StateTable.GateTickers[currState] || Exhausted))
+						BitParallel.Accepting |= MaskType(1) << Position;
+
+					RegexByteBitmap FrontierBytes;
+					if (StateTable.GateTickers[currState] && !Exhausted)
+					{
+						AddCandidate(currState, Again, FollowMasks[Position], FrontierBytes);
+						continue;
+					}
+
+					for (unsigned int i = StateTable.EdgeStarts[currState]; i < StateTable.EdgeStarts[currState + 1]; ++i)
+					{
+						const int Next = StateTable.Edges[i];
+						bool Added = true;
+
+						if (Next == currState)
+						{
+							if (!Exhausted)
+								Added = AddCandidate(currState, Again, FollowMasks[Position], FrontierBytes);
+						}
+						else if (0 != Repeats[Next] || !StateTable.LoopTickers[Next])
+							Added = AddCandidate(Next, FirstPositions[Next], FollowMasks[Position], FrontierBytes);
+
+						if (!Added)
+							return;
+					}
+				}
+			}
+
+			// Nothing can turn it down from here on, so its tables are worth allocating.
+			BitParallel.Tables = std::make_unique<typename RegexBitParallel<T>::TableBlock>();
+			typename RegexBitParallel<T>::TableBlock& Tables = *BitParallel.Tables;
+	
+			for (int currPosition = 0; currPosition < PositionCount; ++currPosition)
+			{
+				const RegexByteBitmap& Bytes = *StateBytes[BitParallel.PositionStates[currPosition]];
+				for (int currByte = 0; currByte < 256; ++currByte)
+				{
+					if (Bytes.Test((unsigned char)currByte))
+						Tables.ByteMasks[currByte] |= MaskType(1) << currPosition;
+				}
+
+				for (int currGroupByte = 0; currGroupByte < 256; ++currGroupByte)
+				{
+					if (currGroupByte & (1 << (currPosition & 7)))
+						Tables.FollowTables[currPosition >> 3][currGroupByte] |= FollowMasks[currPosition];
+				}
+			}
+
+			for (int currByte = 0; currByte < 256; ++currByte)
+			{
+				for (int currPosition = 0; currPosition < PositionCount; ++currPosition)
+				{
+					if (0 != (FollowMasks[currPosition] & Tables.ByteMasks[currByte]))
+						Tables.LiveMasks[currByte] |= MaskType(1) << currPosition;
+				}
+			}
+
+			// Loops keep the plain prefilter from finding the bytes a match can start with, but the positions know them.
+			if (!Prefilter.IsActive())
+			{
+				for (int currByte = 0; currByte < 256; ++currByte)
+				{
+					if (0 != (BitParallel.Initial & Tables.ByteMasks[currByte]))
+						Prefilter.FirstBytes.Set((unsigned char)currByte);
+				}
+				Prefilter.HasFirstBytes = !Prefilter.FirstBytes.IsFull();
+			}
+		}
 	};
 	
 	/*
@@ -977,8 +2229,12 @@ namespace Evex
 		using HookFuncType = std::function<void(RegexRangeIterator<T>&)>;
 		using FuncMapType = std::unordered_map<std::basic_string<T>, HookFuncType>;
 	
-		static void AssembleAutomaton(std::vector<RegexInstruction<T>>& Instructions, Regex<T>& Automaton, FuncMapType* Funcs)
+		static void AssembleAutomaton(const RegexProgram<T>& Program, Regex<T>& Automaton, FuncMapType* Funcs)
 		{
+			// Everything below reads operands and pops chunks as the instruction types say, so check they hold first.
+			if (!Program.IsWellFormed(Automaton.CompileError))
+				return;
+	
 			std::vector<RegexChunkLooseEnds<T>> ChunkStack;
 	
 			std::unordered_map<RegexBackreferenceNode<T>*, int> ToConnect_Backs_Numbered;
@@ -1006,9 +2262,9 @@ namespace Evex
 			{
 				int SymbReserve = 0, CCReserve = 0, TickerReserve = 0;
 	
-				for (RegexInstruction<T>& currInstruction : Instructions)
+				for (const RegexInstruction& currInstruction : Program.Instructions)
 				{
-					RegexInstructionType& currType = currInstruction.InstructionType;
+					const RegexInstructionType& currType = currInstruction.InstructionType;
 	
 					if (currType == RegexInstructionType::MakeCharClassSymbol ||
 						currType == RegexInstructionType::MakeCharClassLigatureSymbol)
@@ -1028,130 +2284,125 @@ namespace Evex
 				Automaton.Tickers.reserve(TickerReserve);
 			}
 	
-			for (RegexInstruction<T>& currInstruction : Instructions)
+			for (const RegexInstruction& currInstruction : Program.Instructions)
 			{
-				std::vector<std::basic_string<T>>& Data = currInstruction.InstructionData;
+				const RegexOperand<T>* Data = Program.GetOperands(currInstruction);
+				const uint32_t DataCount = currInstruction.OperandCount;
 	
 				switch (currInstruction.InstructionType)
 				{
-				// std::string manual, std::string[] names (if empty then will just be reffed by index)
+				// bool manual, name[] names (if empty then will just be reffed by index)
 				case RegexInstructionType::MakeCapture:
-					Automaton.Captures.push_back(new RegexCapture<T>());
-					Automaton.Captures.back()->Manual = Data[0] == "t";
-					if (!Data.empty()) // named
+					Automaton.Captures.push_back(Automaton.Arena.New<RegexCapture<T>>());
+					Automaton.Captures.back()->Manual = Data[0].Bool;
+					for (uint32_t i = 1; i < DataCount; ++i) // named
 					{
-						for (unsigned int i = 1; i < Data.size(); ++i)
-						{
-							std::basic_string<T>& currName = Data[i];
-							if (Automaton.NamesToCaptures.find(currName) == Automaton.NamesToCaptures.end())
-								Automaton.NamesToCaptures[currName] = Automaton.Captures.back();
-						}
+						std::basic_string<T> currName(Program.GetName(Data[i]));
+						if (Automaton.NamesToCaptures.find(currName) == Automaton.NamesToCaptures.end())
+							Automaton.NamesToCaptures[currName] = Automaton.Captures.back();
 					}
 					break;
 	
-				// std::string manual, std::string[] names (if empty then will just be reffed by index)
+				// bool manual, name[] names (if empty then will just be reffed by index)
 				case RegexInstructionType::MakeCaptureCollection:
-					Automaton.Captures.push_back(new RegexCaptureCollection<T>());
-					Automaton.Captures.back()->Manual = Data[0] == "t";
-					if (!Data.empty()) // named
+					Automaton.Captures.push_back(Automaton.Arena.New<RegexCaptureCollection<T>>());
+					Automaton.Captures.back()->Manual = Data[0].Bool;
+					for (uint32_t i = 1; i < DataCount; ++i) // named
 					{
-						for (unsigned int i = 1; i < Data.size(); ++i)
-						{
-							std::basic_string<T>& currName = Data[i];
-							if (Automaton.NamesToCaptures.find(currName) == Automaton.NamesToCaptures.end())
-								Automaton.NamesToCaptures[currName] = Automaton.Captures.back();
-						}
+						std::basic_string<T> currName(Program.GetName(Data[i]));
+						if (Automaton.NamesToCaptures.find(currName) == Automaton.NamesToCaptures.end())
+							Automaton.NamesToCaptures[currName] = Automaton.Captures.back();
 					}
 					break;
 	
 	
-				// std::string minChar, std::string maxChar
+				// char minChar, char maxChar
 				case RegexInstructionType::MakeCharClassSymbol:
 					{
-						T& min = Data[0][0];
-						T& max = Data[1][0];
-						Automaton.CharClassSymbols.push_back(new RegexCharacterClassSymbol<T>(min, max));
+						T min = Data[0].Char;
+						T max = Data[1].Char;
+						Automaton.CharClassSymbols.push_back(Automaton.Arena.New<RegexCharacterClassSymbol<T>>(min, max));
 					}
 					break;
 	
-				// std::string[] charsInvolved
+				// char[] charsInvolved
 				case RegexInstructionType::MakeCharClassLigatureSymbol:
 					{
 						std::vector<T> ligChars;
-						for (std::basic_string<T>& currChar : Data)
-							ligChars.push_back(currChar[0]);
-						Automaton.CharClassSymbols.push_back(new RegexCharacterClassSymbol<T>(ligChars));
+						for (uint32_t i = 0; i < DataCount; ++i)
+							ligChars.push_back(Data[i].Char);
+						Automaton.CharClassSymbols.push_back(Automaton.Arena.New<RegexCharacterClassSymbol<T>>(ligChars));
 					}
 					break;
 	
 	
-				// std::string negated, std::string caseinsensitive, std::string[] inds
+				// bool negated, bool caseinsensitive, int[] inds
 				case RegexInstructionType::MakeLiteralCharClass:
 					{
-						bool Neg = Data[0] == "t";
+						bool Neg = Data[0].Bool;
 						std::vector<RegexCharacterClassSymbol<T>*> Symbs;
-						for (unsigned int i = 2; i < Data.size(); ++i)
-							Symbs.push_back(Automaton.CharClassSymbols[std::stoi(Data[i])]);
+						for (uint32_t i = 2; i < DataCount; ++i)
+							Symbs.push_back(Automaton.CharClassSymbols[Data[i].Int]);
 	
-						Automaton.CharacterClasses.push_back(new RegexCharacterClass<T>(Symbs, Neg, Data[1] == "t"));
+						Automaton.CharacterClasses.push_back(Automaton.Arena.New<RegexCharacterClass<T>>(Symbs, Neg, Data[1].Bool));
 					}
 					break;
 	
 	
-				// std::string lhsInd, std::string rhsInd
+				// int lhsInd, int rhsInd
 				case RegexInstructionType::MakeUnitedCharClass:
 					{
-						RegexCharacterClassBase<T>* lhs = Automaton.CharacterClasses[std::stoi(Data[0])];
-						RegexCharacterClassBase<T>* rhs = Automaton.CharacterClasses[std::stoi(Data[1])];
-						Automaton.CharacterClasses.push_back(new RegexUnionCharacterClass<T>(lhs, rhs));
+						RegexCharacterClassBase<T>* lhs = Automaton.CharacterClasses[Data[0].Int];
+						RegexCharacterClassBase<T>* rhs = Automaton.CharacterClasses[Data[1].Int];
+						Automaton.CharacterClasses.push_back(Automaton.Arena.New<RegexUnionCharacterClass<T>>(lhs, rhs));
 					}
 					break;
 	
-				// std::string lhsInd, std::string rhsInd
+				// int lhsInd, int rhsInd
 				case RegexInstructionType::MakeSubtractedCharClass:
 					{
-						RegexCharacterClassBase<T>* lhs = Automaton.CharacterClasses[std::stoi(Data[0])];
-						RegexCharacterClassBase<T>* rhs = Automaton.CharacterClasses[std::stoi(Data[1])];
-						Automaton.CharacterClasses.push_back(new RegexSubtractCharacterClass<T>(lhs, rhs));
+						RegexCharacterClassBase<T>* lhs = Automaton.CharacterClasses[Data[0].Int];
+						RegexCharacterClassBase<T>* rhs = Automaton.CharacterClasses[Data[1].Int];
+						Automaton.CharacterClasses.push_back(Automaton.Arena.New<RegexSubtractCharacterClass<T>>(lhs, rhs));
 					}
 					break;
 	
-				// std::string lhsInd, std::string rhsInd
+				// int lhsInd, int rhsInd
 				case RegexInstructionType::MakeIntersectedCharClass:
 					{
-						RegexCharacterClassBase<T>* lhs = Automaton.CharacterClasses[std::stoi(Data[0])];
-						RegexCharacterClassBase<T>* rhs = Automaton.CharacterClasses[std::stoi(Data[1])];
-						Automaton.CharacterClasses.push_back(new RegexIntersectCharacterClass<T>(lhs, rhs));
+						RegexCharacterClassBase<T>* lhs = Automaton.CharacterClasses[Data[0].Int];
+						RegexCharacterClassBase<T>* rhs = Automaton.CharacterClasses[Data[1].Int];
+						Automaton.CharacterClasses.push_back(Automaton.Arena.New<RegexIntersectCharacterClass<T>>(lhs, rhs));
 					}
 					break;
 	
 	
-				// std::string[] characterclassindices
+				// int[] characterclassindices
 				case RegexInstructionType::Literal:
 					{
 						std::unordered_set<RegexCharacterClassBase<T>*> CCs;
-						for (std::basic_string<T>& currCC : Data)
-							CCs.insert(Automaton.CharacterClasses[std::stoi(currCC)]);
+						for (uint32_t i = 0; i < DataCount; ++i)
+							CCs.insert(Automaton.CharacterClasses[Data[i].Int]);
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Literal(CCs);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Literal(Automaton.Arena, CCs);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 					}
 					break;
 	
-				// std::string IsExclusive, std::string IsLastMatchEnd, std::string LineCharsInd
+				// bool IsExclusive, bool IsLastMatchEnd, int LineCharsInd
 				case RegexInstructionType::StartCheck:
 					{
-						bool Exclusive = Data[0] == "t";
-						bool LastMatchEnd = Data[1] == "t";
-						RegexCharacterClassBase<T>* LineChars = Automaton.CharacterClasses[std::stoi(Data[2])];
+						bool Exclusive = Data[0].Bool;
+						bool LastMatchEnd = Data[1].Bool;
+						RegexCharacterClassBase<T>* LineChars = Automaton.CharacterClasses[Data[2].Int];
 	
-						RegexAtBeginningNode<T>* NewNode = new RegexAtBeginningNode<T>(LineChars, Exclusive);
+						RegexAtBeginningNode<T>* NewNode = Automaton.Arena.New<RegexAtBeginningNode<T>>(LineChars, Exclusive);
 	
 						if (LastMatchEnd)
-							NewNode->LastMatchEnd = &Automaton.LastMatchEnd;
+							NewNode->AtLastMatchEnd = true;
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(NewNode);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Automaton.Arena, NewNode);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 	
@@ -1159,16 +2410,16 @@ namespace Evex
 					}
 					break;
 	
-				// std::string IsExclusive, std::string BeforeLastNewline, std::string LineCharsInd
+				// bool IsExclusive, bool BeforeLastNewline, int LineCharsInd
 				case RegexInstructionType::EndCheck:
 					{
-						bool Exclusive = Data[0] == "t";
-						bool BeforeLastNL = Data[1] == "t";
-						RegexCharacterClassBase<T>* LineChars = Automaton.CharacterClasses[std::stoi(Data[2])];
+						bool Exclusive = Data[0].Bool;
+						bool BeforeLastNL = Data[1].Bool;
+						RegexCharacterClassBase<T>* LineChars = Automaton.CharacterClasses[Data[2].Int];
 	
-						RegexAtEndNode<T>* NewNode = new RegexAtEndNode<T>(LineChars, Exclusive, BeforeLastNL);
+						RegexAtEndNode<T>* NewNode = Automaton.Arena.New<RegexAtEndNode<T>>(LineChars, Exclusive, BeforeLastNL);
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(NewNode);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Automaton.Arena, NewNode);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 	
@@ -1177,100 +2428,105 @@ namespace Evex
 					break;
 	
 	
-				// std::string negated, std::string WordCharsInd
+				// bool negated, int WordCharsInd
 				case RegexInstructionType::WordBoundary:
 					{
-						bool Neg = Data[0] == "t";
-						RegexCharacterClassBase<T>* WordChars = Automaton.CharacterClasses[std::stoi(Data[1])];
+						bool Neg = Data[0].Bool;
+						RegexCharacterClassBase<T>* WordChars = Automaton.CharacterClasses[Data[1].Int];
 	
-						RegexWordBoundaryNode<T>* NewNode = new RegexWordBoundaryNode<T>(WordChars, Neg);
+						RegexWordBoundaryNode<T>* NewNode = Automaton.Arena.New<RegexWordBoundaryNode<T>>(WordChars, Neg);
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(NewNode);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Automaton.Arena, NewNode);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 	
-						if (&*(Instructions.end() - 1) == &currInstruction || &*(Instructions.end() - 2) == &currInstruction)
+						if (&*(Program.Instructions.end() - 1) == &currInstruction || &*(Program.Instructions.end() - 2) == &currInstruction)
 							Automaton.EndsWithLineCheck = true;
 					}
 					break;
 	
 	
-				// std::string capturenumber
+				// int capturenumber
 				case RegexInstructionType::Backref_Numbered:
 					{
-						RegexBackreferenceNode<T>* NewNode = new RegexBackreferenceNode<T>(Data[0]);
+						std::basic_string<T> Name = NumberedName(Data[0].Int);
+						RegexBackreferenceNode<T>* NewNode = Automaton.Arena.New<RegexBackreferenceNode<T>>(Name);
 	
-						ToConnect_Backs_Numbered[NewNode] = std::stoi(Data[0]);
+						ToConnect_Backs_Numbered[NewNode] = Data[0].Int;
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(NewNode);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Automaton.Arena, NewNode);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 					}
 					break;
 	
-				// std::string capturename
+				// name capturename
 				case RegexInstructionType::Backref_Named:
 					{
-						RegexBackreferenceNode<T>* NewNode = new RegexBackreferenceNode<T>(Data[0]);
+						std::basic_string<T> Name(Program.GetName(Data[0]));
+						RegexBackreferenceNode<T>* NewNode = Automaton.Arena.New<RegexBackreferenceNode<T>>(Name);
 	
-						ToConnect_Backs_Named[NewNode] = Data[0];
+						ToConnect_Backs_Named[NewNode] = Name;
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(NewNode);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Automaton.Arena, NewNode);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 					}
 					break;
 	
 	
-				// std::string capturenumber, std::string maxdepth
+				// int capturenumber, int maxdepth
 				case RegexInstructionType::Subroutine_Numbered:
 					{
-						RegexSubroutineNode<T>* NewNode = new RegexSubroutineNode<T>(Data[0], std::stoi(Data[1]));
+						std::basic_string<T> Name = NumberedName(Data[0].Int);
+						RegexSubroutineNode<T>* NewNode = Automaton.Arena.New<RegexSubroutineNode<T>>(Name, Data[1].Int);
 	
-						ToConnect_Subs_Numbered[NewNode] = std::stoi(Data[0]);
+						ToConnect_Subs_Numbered[NewNode] = Data[0].Int;
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(NewNode);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Automaton.Arena, NewNode);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 					}
 					break;
 	
-				// std::string capturename, std::string maxdepth
+				// name capturename, int maxdepth
 				case RegexInstructionType::Subroutine_Named:
 					{
-						RegexSubroutineNode<T>* NewNode = new RegexSubroutineNode<T>(Data[0], std::stoi(Data[1]));
+						std::basic_string<T> Name(Program.GetName(Data[0]));
+						RegexSubroutineNode<T>* NewNode = Automaton.Arena.New<RegexSubroutineNode<T>>(Name, Data[1].Int);
 	
-						ToConnect_Subs_Named[NewNode] = Data[0];
+						ToConnect_Subs_Named[NewNode] = Name;
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(NewNode);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Automaton.Arena, NewNode);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 					}
 					break;
 	
 	
-				// std::string maxdepth, std::string Lazy
+				// int maxdepth, bool Lazy
 				case RegexInstructionType::Recursion:
 					{
-						RegexRecursionNode<T>* NewNode = new RegexRecursionNode<T>(std::stoi(Data[0]));
-						NewNode->LazyGroup = Data[1] == "t";
+						RegexRecursionNode<T>* NewNode = Automaton.Arena.New<RegexRecursionNode<T>>(Data[0].Int);
+						NewNode->LazyGroup = Data[1].Bool;
 	
 						RecursionNodes.insert(NewNode);
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(NewNode);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Automaton.Arena, NewNode);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 					}
 					break;
 	
 	
-				// std::string index, std::string Lazy. Pop one off stack, make group, put back in.
+				// int index, bool Lazy. Pop one off stack, make group, put back in.
 				case RegexInstructionType::CaptureGroup_Numbered:
 					{
-						RegexCaptureNode<T>* NewNode = new RegexCaptureNode<T>(Data[0]);
-						NewNode->LazyGroup = Data[1] == "t";
+						std::basic_string<T> Name = NumberedName(Data[0].Int);
+						RegexCaptureNode<T>* NewNode = Automaton.Arena.New<RegexCaptureNode<T>>(Name);
+						NewNode->LazyGroup = Data[1].Bool;
 	
-						ToConnect_Caps_Numbered[NewNode] = std::stoi(Data[0]);
+						ToConnect_Caps_Numbered[NewNode] = Data[0].Int;
 	
 						RegexChunkLooseEnds<T> CaptureChunk = ChunkStack.back();
 						ChunkStack.pop_back();
@@ -1279,13 +2535,14 @@ namespace Evex
 					}
 					break;
 	
-				// std::string name, std::string Lazy. Pop one off stack, make group, put back in.
+				// name name, bool Lazy. Pop one off stack, make group, put back in.
 				case RegexInstructionType::CaptureGroup_Named:
 					{
-						RegexCaptureNode<T>* NewNode = new RegexCaptureNode<T>(Data[0]);
-						NewNode->LazyGroup = Data[1] == "t";
+						std::basic_string<T> Name(Program.GetName(Data[0]));
+						RegexCaptureNode<T>* NewNode = Automaton.Arena.New<RegexCaptureNode<T>>(Name);
+						NewNode->LazyGroup = Data[1].Bool;
 	
-						ToConnect_Caps_Named[NewNode] = Data[0];
+						ToConnect_Caps_Named[NewNode] = Name;
 	
 						RegexChunkLooseEnds<T> CaptureChunk = ChunkStack.back();
 						ChunkStack.pop_back();
@@ -1295,11 +2552,11 @@ namespace Evex
 					break;
 	
 	
-				// std::string Lazy. Pop one off stack, make group, put back in.
+				// bool Lazy. Pop one off stack, make group, put back in.
 				case RegexInstructionType::NonCaptureGroup:
 					{
-						RegexGroupNode<T>* NewNode = new RegexGroupNode<T>();
-						NewNode->LazyGroup = Data[0] == "t";
+						RegexGroupNode<T>* NewNode = Automaton.Arena.New<RegexGroupNode<T>>();
+						NewNode->LazyGroup = Data[0].Bool;
 	
 						RegexChunkLooseEnds<T> GroupChunk = ChunkStack.back();
 						ChunkStack.pop_back();
@@ -1309,11 +2566,11 @@ namespace Evex
 					break;
 	
 	
-				// std::string negated, std::string lazy. pop one off stack, make lookahead, put back in.
+				// bool negated, bool lazy. pop one off stack, make lookahead, put back in.
 				case RegexInstructionType::LookAhead:
 					{
-						RegexLookAheadNode<T>* NewNode = new RegexLookAheadNode<T>(Data[0] == "t");
-						NewNode->LazyGroup = Data[1] == "t";
+						RegexLookAheadNode<T>* NewNode = Automaton.Arena.New<RegexLookAheadNode<T>>(Data[0].Bool);
+						NewNode->LazyGroup = Data[1].Bool;
 	
 						RegexChunkLooseEnds<T> GroupChunk = ChunkStack.back();
 						ChunkStack.pop_back();
@@ -1322,61 +2579,67 @@ namespace Evex
 					}
 					break;
 	
-				// std::string negated, std::string lazy. pop one off stack, make lookbehind, put back in.
+				// bool negated, bool lazy. pop one off stack, make lookbehind, put back in.
+				// The group is translated as written, and flipped here to be matched from end to beginning.
 				case RegexInstructionType::LookBehind:
 					{
-						RegexLookBehindNode<T>* NewNode = new RegexLookBehindNode<T>(Data[0] == "t");
-						NewNode->LazyGroup = Data[1] == "t";
+						RegexLookBehindNode<T>* NewNode = Automaton.Arena.New<RegexLookBehindNode<T>>(Data[0].Bool);
+						NewNode->LazyGroup = Data[1].Bool;
 	
 						RegexChunkLooseEnds<T> GroupChunk = ChunkStack.back();
 						ChunkStack.pop_back();
 	
-						ChunkStack.push_back(Automaton.AssembleGroup(GroupChunk, NewNode, packet));
+						typename Regex<T>::ReversedGroupMap ReversedGroups;
+						RegexChunkLooseEnds<T> ReversedChunk = Automaton.Reverse(GroupChunk, ReversedGroups, packet);
+	
+						ChunkStack.push_back(Automaton.AssembleGroup(ReversedChunk, NewNode, packet));
 					}
 					break;
 	
 	
-				// std::string name. pops one off the stack, and that's it. i.e. makes a chunk only accessible via subroutine call.
+				// name name. pops one off the stack, and that's it. i.e. makes a chunk only accessible via subroutine call.
 				case RegexInstructionType::DefineAsSubroutine:
 					{
 						RegexChunkLooseEnds<T> Popped = ChunkStack.back();
 						ChunkStack.pop_back();
 	
-						Automaton.DefinedSubroutines.push_back(new RegexCapture<T>());
+						Automaton.DefinedSubroutines.push_back(Automaton.Arena.New<RegexCapture<T>>());
 	
 						Automaton.DefinedSubroutines.back()->InitialCapture = (*Popped.ChunksInvolved.begin())->Nodes[0];
 	
-						Automaton.NamesToCaptures[currInstruction.InstructionData[0]] = Automaton.DefinedSubroutines.back();
+						Automaton.NamesToCaptures[std::basic_string<T>(Program.GetName(Data[0]))] = Automaton.DefinedSubroutines.back();
 					}
 					break;
 	
 	
-				// std::string funcname
+				// name funcname
 				case RegexInstructionType::CodeHook:
 					{
+						std::basic_string<T> Name(Program.GetName(Data[0]));
+	
 						HookFuncType FoundFunc = nullptr;
 						if (Funcs)
 						{
-							auto found = Funcs->find(Data[0]);
+							auto found = Funcs->find(Name);
 							if (found != Funcs->end())
 								FoundFunc = found->second;
 						}
 	
-						RegexCodeHookNode<T>* NewNode = new RegexCodeHookNode<T>(Data[0], FoundFunc);
+						RegexCodeHookNode<T>* NewNode = Automaton.Arena.New<RegexCodeHookNode<T>>(Name, FoundFunc);
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(NewNode);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Automaton.Arena, NewNode);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 					}
 					break;
 	
 	
-				// std::string NumConds, std::string Lazy. pop NumConds + 1, i.e. 2 or 3, off the top, create a conditional with them, place back in
+				// int NumConds, bool Lazy. pop NumConds + 1, i.e. 2 or 3, off the top, create a conditional with them, place back in
 				case RegexInstructionType::Conditional:
 					{
 						RegexChunk<T>* Cond = nullptr, *Then = nullptr, *Else = nullptr;
 	
-						if (Data[0] == "2")
+						if (Data[0].Int == 2)
 						{
 							Else = *ChunkStack.back().ChunksInvolved.begin();
 							ChunkStack.pop_back();
@@ -1393,10 +2656,10 @@ namespace Evex
 							ChunkStack.pop_back();
 						}
 	
-						RegexConditionalNode<T>* NewNode = new RegexConditionalNode<T>(Cond, Then, Else);
-						NewNode->LazyGroup = Data[1] == "t";
+						RegexConditionalNode<T>* NewNode = Automaton.Arena.New<RegexConditionalNode<T>>(Cond, Then, Else);
+						NewNode->LazyGroup = Data[1].Bool;
 	
-						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(NewNode);
+						RegexChunk<T>* NewChunk = RegexChunk<T>::Wrap(Automaton.Arena, NewNode);
 						ChunkStack.push_back(Automaton.GetLooseEnds(NewChunk));
 						Automaton.Chunks.insert(NewChunk);
 					}
@@ -1460,21 +2723,21 @@ namespace Evex
 					}
 					break;
 	
-				// std::string type, std::string mintimes, std::string maxtimes. pop one off stack, make the respective repeat, put back in
+				// int type (RegexRepeatType), int mintimes, int maxtimes. pop one off stack, make the respective repeat, put back in
 				case RegexInstructionType::Repeat:
 					{
 						RegexChunkLooseEnds<T> Popped = ChunkStack.back();
 						ChunkStack.pop_back();
 	
-						if (Data[0] == "Exact")
-							ChunkStack.push_back(Automaton.RepeatExact(Popped, std::stoi(Data[1]), packet));
-						else if (Data[0] == "Min")
-							ChunkStack.push_back(Automaton.RepeatMin(Popped, std::stoi(Data[1]), packet));
-						else if (Data[0] == "MinMax")
-							ChunkStack.push_back(Automaton.RepeatMinMax(Popped, std::stoi(Data[1]), std::stoi(Data[2]), packet));
+						if (Data[0].Int == int(RegexRepeatType::Exact))
+							ChunkStack.push_back(Automaton.RepeatExact(Popped, Data[1].Int, packet));
+						else if (Data[0].Int == int(RegexRepeatType::Min))
+							ChunkStack.push_back(Automaton.RepeatMin(Popped, Data[1].Int, packet));
+						else if (Data[0].Int == int(RegexRepeatType::MinMax))
+							ChunkStack.push_back(Automaton.RepeatMinMax(Popped, Data[1].Int, Data[2].Int, packet));
 						else
 						{
-							Automaton.CompileError = "Regex Compile Error: \'" + Data[0] + "\'"
+							Automaton.CompileError = "Regex Compile Error: \'" + std::to_string(Data[0].Int) + "\'"
 								" is not a valid type of repeat.";
 							return;
 						}
@@ -1486,15 +2749,15 @@ namespace Evex
 						RegexChunkLooseEnds<T> Popped = ChunkStack.back();
 						ChunkStack.pop_back();
 	
-						if (Data[0] == "Exact")
-							ChunkStack.push_back(Automaton.RepeatExact(Popped, std::stoi(Data[1]), packet, true));
-						else if (Data[0] == "Min")
-							ChunkStack.push_back(Automaton.RepeatMin(Popped, std::stoi(Data[1]), packet, true));
-						else if (Data[0] == "MinMax")
-							ChunkStack.push_back(Automaton.RepeatMinMax(Popped, std::stoi(Data[1]), std::stoi(Data[2]), packet, true));
+						if (Data[0].Int == int(RegexRepeatType::Exact))
+							ChunkStack.push_back(Automaton.RepeatExact(Popped, Data[1].Int, packet, true));
+						else if (Data[0].Int == int(RegexRepeatType::Min))
+							ChunkStack.push_back(Automaton.RepeatMin(Popped, Data[1].Int, packet, true));
+						else if (Data[0].Int == int(RegexRepeatType::MinMax))
+							ChunkStack.push_back(Automaton.RepeatMinMax(Popped, Data[1].Int, Data[2].Int, packet, true));
 						else
 						{
-							Automaton.CompileError = "Regex Compile Error: \'" + Data[0] + "\'"
+							Automaton.CompileError = "Regex Compile Error: \'" + std::to_string(Data[0].Int) + "\'"
 								" is not a valid type of repeat.";
 							return;
 						}
@@ -1504,9 +2767,9 @@ namespace Evex
 				// pop two off the top, concat them together, place back in.
 				case RegexInstructionType::Concat:
 					{
-						RegexChunkLooseEnds<T> rhs = ChunkStack.back();
+						RegexChunkLooseEnds<T> rhs = std::move(ChunkStack.back());
 						ChunkStack.pop_back();
-						RegexChunkLooseEnds<T> lhs = ChunkStack.back();
+						RegexChunkLooseEnds<T> lhs = std::move(ChunkStack.back());
 						ChunkStack.pop_back();
 	
 						ChunkStack.push_back(Automaton.Concat(lhs, rhs));
@@ -1516,9 +2779,9 @@ namespace Evex
 				// pop two off the top, alt them together, place back in.
 				case RegexInstructionType::Alternate:
 					{
-						RegexChunkLooseEnds<T> rhs = ChunkStack.back();
+						RegexChunkLooseEnds<T> rhs = std::move(ChunkStack.back());
 						ChunkStack.pop_back();
-						RegexChunkLooseEnds<T> lhs = ChunkStack.back();
+						RegexChunkLooseEnds<T> lhs = std::move(ChunkStack.back());
 						ChunkStack.pop_back();
 	
 						ChunkStack.push_back(Automaton.Alternate(lhs, rhs));
@@ -1530,12 +2793,6 @@ namespace Evex
 					return;
 				}
 			}
-	
-			if (ChunkStack.size() < 1)
-			{
-				Automaton.CompileError = "Regex Compile Error: No nodes constructed from given regex.";
-				return;
-			}
 
 
 			for(auto& curr : ToConnect_Backs_Numbered)
@@ -1601,14 +2858,22 @@ namespace Evex
 			Automaton.StartNodes = Final.Ins;
 			Automaton.EndNodes = Final.Outs;
 		}
+	
+	private:
+		// Numbered captures, backreferences and subroutines are named after their number.
+		static std::basic_string<T> NumberedName(int Number)
+		{
+			std::string Digits = std::to_string(Number);
+			return std::basic_string<T>(Digits.begin(), Digits.end());
+		}
 	};
 	
 	template<typename T>
 	template<typename TranslatorType, typename AssemblerType>
-	Regex<T>::Regex(std::basic_string<T> c, FuncMapType* Funcs, std::vector<RegexInstruction<T>>* OutInstructions,
+	Regex<T>::Regex(std::basic_string<T> c, FuncMapType* Funcs, RegexProgram<T>* OutInstructions,
 		int MaxNestingDepth, RegexRangeIterator<T>* PresetLastMatchEnd)
 	{
-		std::vector<RegexInstruction<T>> PostfixInstructions = TranslatorType::Translate(c, CompileError, MaxNestingDepth);
+		RegexProgram<T> PostfixInstructions = TranslatorType::Translate(c, CompileError, MaxNestingDepth);
 	
 		if (CompileError.empty())
 		{
@@ -1617,17 +2882,23 @@ namespace Evex
 		
 			AssemblerType::AssembleAutomaton(PostfixInstructions, *this, Funcs);
 		}
+
+		if (CompileError.empty())
+		{
+			BuildStateTable();
+			PrepareContext(DefaultContext);
+		}
 	
 		// Since we're done constructing, we don't need this data anymore
 		for (RegexChunk<T>* currChunk : Chunks)
 			currChunk->ConnectedTos.clear();
 	
 		if (PresetLastMatchEnd)
-			LastMatchEnd = *PresetLastMatchEnd;
+			DefaultContext.LastMatchEnd = *PresetLastMatchEnd;
 	}
 	
 	template<typename T>
-	Regex<T>::Regex(std::vector<RegexInstruction<T>>& Instructions, FuncMapType* Funcs)
+	Regex<T>::Regex(const RegexProgram<T>& Instructions, FuncMapType* Funcs)
 	{
 		if (Instructions.empty())
 		{
@@ -1636,6 +2907,12 @@ namespace Evex
 		}
 	
 		RegexAssembler<T>::AssembleAutomaton(Instructions, *this, Funcs);
+
+		if (CompileError.empty())
+		{
+			BuildStateTable();
+			PrepareContext(DefaultContext);
+		}
 	
 		// Since we're done constructing, we don't need this data anymore
 		for (RegexChunk<T>* currChunk : Chunks)
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+
+
+namespace Evex
+{
+	/*
+		Monotonic arena backing everything a Regex builds its automaton out of: nodes, chunks, captures,
+		character classes and their symbols.
+
+		Storage is carved out of large blocks, each twice the size of the last up to MaxBlockSize, and is never
+		given back one object at a time. Objects that need destroying are threaded onto a list as they're made,
+		and are destroyed newest first when the arena is released, after which every block is freed in one go.
+	*/
+	class RegexArena
+	{
+	public:
+		// Size of the first block, and the size blocks stop growing at, in bytes.
+		static constexpr size_t InitialBlockSize = 1 << 12;
+		static constexpr size_t MaxBlockSize = 1 << 16;
+
+		RegexArena() {}
+		~RegexArena() { Release(); }
+
+		RegexArena(const RegexArena&) = delete;
+		RegexArena& operator=(const RegexArena&) = delete;
+
+		// Constructs a U in the arena. It lives until the arena is released.
+		template<typename U, typename... Args>
+		U* New(Args&&... args)
+		{
+			if constexpr (std::is_trivially_destructible<U>::value)
+				return new (Allocate(sizeof(U), alignof(U))) U(std::forward<Args>(args)...);
+			else
+			{
+				// Only linked in once the object is fully constructed, so a throwing constructor leaves nothing to destroy.
+				Cleanup* Record = new (Allocate(sizeof(Cleanup), alignof(Cleanup))) Cleanup();
+				U* Out = new (Allocate(sizeof(U), alignof(U))) U(std::forward<Args>(args)...);
+
+				Record->Object = Out;
+				Record->Destroy = &DestroyAs<U>;
+				Record->Next = Cleanups;
+				Cleanups = Record;
+
+				return Out;
+			}
+		}
+
+		// Raw storage of the given size and alignment.
+		void* Allocate(size_t Size, size_t Align)
+		{
+			uintptr_t Aligned = (Cursor + Align - 1) & ~uintptr_t(Align - 1);
+			if (nullptr == Blocks || Aligned + Size > Limit)
+			{
+				NewBlock(Size + Align);
+				Aligned = (Cursor + Align - 1) & ~uintptr_t(Align - 1);
+			}
+
+			Cursor = Aligned + Size;
+			return reinterpret_cast<void*>(Aligned);
+		}
+
+		// Destroys everything made in the arena and frees every block.
+		void Release()
+		{
+			for (Cleanup* currCleanup = Cleanups; nullptr != currCleanup; currCleanup = currCleanup->Next)
+				currCleanup->Destroy(currCleanup->Object);
+			Cleanups = nullptr;
+
+			while (nullptr != Blocks)
+			{
+				Block* Prev = Blocks->Prev;
+				::operator delete(Blocks);
+				Blocks = Prev;
+			}
+
+			Cursor = Limit = 0;
+			NextBlockSize = InitialBlockSize;
+			BytesReserved = 0;
+		}
+
+		// Bytes taken from the system so far, including what's yet to be handed out.
+		inline size_t GetBytesReserved() const { return BytesReserved; }
+
+	private:
+		struct Block
+		{
+			Block* Prev;
+			size_t Size;
+		};
+
+		struct Cleanup
+		{
+			Cleanup* Next = nullptr;
+			void* Object = nullptr;
+			void (*Destroy)(void*) = nullptr;
+		};
+
+		template<typename U>
+		static void DestroyAs(void* Object) { static_cast<U*>(Object)->~U(); }
+
+		Block* Blocks = nullptr;
+		Cleanup* Cleanups = nullptr;
+
+		// Next free byte of the newest block, and the end of it.
+		uintptr_t Cursor = 0, Limit = 0;
+
+		size_t NextBlockSize = InitialBlockSize;
+		size_t BytesReserved = 0;
+
+		void NewBlock(size_t MinSize)
+		{
+			size_t Size = std::max(NextBlockSize, MinSize);
+			NextBlockSize = std::min(NextBlockSize * 2, MaxBlockSize);
+
+			Block* Added = static_cast<Block*>(::operator new(sizeof(Block) + Size));
+			Added->Prev = Blocks;
+			Added->Size = Size;
+			Blocks = Added;
+
+			Cursor = reinterpret_cast<uintptr_t>(Added + 1);
+			Limit = Cursor + Size;
+			BytesReserved += sizeof(Block) + Size;
+		}
+	};
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "EvexRangeIterator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace Evex
+{
+	/*
+		Word-sized stand-in for the state table of small single-byte regexes, built by Regex::BuildBitParallel.
+
+		Each position is a state as entered for the n-th time in a row, so counted loops need no tickers. Every
+		frontier's candidates take disjoint sets of bytes, so the state the matcher picks on a byte is the only one
+		it could pick, and any number of walks can be stepped at once as a set of positions packed into one word:
+		the positions that follow any of them, masked down to those taking the byte.
+		Follow sets are looked up 8 positions at a time, so a step costs the same however many walks are in flight.
+	*/
+	template<typename T>
+	struct RegexBitParallel
+	{
+		using MaskType = uint64_t;
+
+		static const int MaxPositions = 64;
+
+		// Per-byte tables, some 20KB of them, so they're only allocated once the engine is turned on.
+		struct TableBlock
+		{
+			// Positions taking each byte.
+			MaskType ByteMasks[256] = {};
+
+			// Positions from which some candidate takes each byte.
+			MaskType LiveMasks[256] = {};
+
+			// Union of the candidates of every position set in each byte of a position mask, by which byte.
+			MaskType FollowTables[MaxPositions / 8][256] = {};
+		};
+
+		// Positions the matcher can enter first, and those in which it ends with a match.
+		MaskType Initial = 0;
+		MaskType Accepting = 0;
+
+		// Null unless the engine is on.
+		std::unique_ptr<TableBlock> Tables;
+
+		// Index into the state table of each position.
+		std::vector<int> PositionStates;
+
+		inline bool IsActive() const { return nullptr != Tables; }
+
+		void Clear()
+		{
+			Initial = 0;
+			Accepting = 0;
+			Tables.reset();
+			PositionStates.clear();
+		}
+
+		// Bytes allocated beyond the struct itself.
+		inline size_t MemoryUsage() const { return (Tables ? sizeof(TableBlock) : 0) + PositionStates.capacity() * sizeof(int); }
+
+		inline MaskType Follow(MaskType Positions) const
+		{
+			MaskType Out = 0;
+			for (int currByte = 0; currByte < MaxPositions / 8 && 0 != Positions; ++currByte, Positions >>= 8)
+				Out |= Tables->FollowTables[currByte][Positions & 0xFF];
+			return Out;
+		}
+
+		/*
+			Walks from Iter onward as Regex::RunInternal would, leaving Iter where the walk stopped.
+			Returns the state table index of the last state entered, or -1 if none could be.
+			OutAccepting is set to whether the walk ended in an accepting position.
+		*/
+		int Run(RegexRangeIterator<T>& Iter, bool& OutAccepting) const
+		{
+			MaskType Current = 0;
+			while (!Iter.IsEnd())
+			{
+				MaskType Next = (0 == Current ? Initial : Follow(Current)) & Tables->ByteMasks[(unsigned char)*Iter];
+				if (0 == Next)
+					break;
+
+				Current = Next;
+				++Iter;
+			}
+
+			OutAccepting = (0 != (Current & Accepting));
+
+			if (0 == Current)
+				return -1;
+
+			int Position = 0;
+			while (0 == (Current & (MaskType(1) << Position)))
+				++Position;
+
+			return PositionStates[Position];
+		}
+
+		/*
+			Scans from From onward with a walk starting at every offset, to find where the next match could start.
+			Returns an offset no match starting at or after From can start before, or -1 if none can start at all.
+			OutLiveUntil is set to the offset a walk was first seen to end in a match. Every offset up to it is worth
+			trying, as any of them may be where that walk began.
+		*/
+		ptrdiff_t NextPossibleStart(const T* Data, ptrdiff_t Length, ptrdiff_t From, ptrdiff_t& OutLiveUntil) const
+		{
+			// Offset from which every walk still in flight has been running, as there were none just before it.
+			ptrdiff_t LiveFrom = From;
+
+			MaskType Current = 0;
+			for (ptrdiff_t currPos = From; currPos < Length; ++currPos)
+			{
+				const unsigned char Byte = (unsigned char)Data[currPos];
+
+				// Walks with no candidate for this byte finish here, and match if they're in an accepting position.
+				if (0 != (Current & ~Tables->LiveMasks[Byte] & Accepting))
+				{
+					OutLiveUntil = currPos;
+					return LiveFrom;
+				}
+
+				Current = (Follow(Current) | Initial) & Tables->ByteMasks[Byte];
+
+				if (0 == Current)
+					LiveFrom = currPos + 1;
+			}
+
+			if (0 != (Current & Accepting))
+			{
+				OutLiveUntil = Length;
+				return LiveFrom;
+			}
+
+			return -1;
+		}
+	};
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Evex.h"
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+
+
+namespace Evex
+{
+	/*
+		Thread-safe cache of compiled regexes, keyed by pattern text, nesting depth limit and hook map.
+		Hook maps are told apart by address, so a map must outlive every regex compiled with it.
+
+		Handles are shared and read-only, so a regex stays alive for as long as anything holds it, even once
+		evicted. They can be matched against from any number of threads at once, each through its own
+		RegexMatchContext, via the context-taking overloads.
+
+		Entries are spread over shards by the hash of their key, each with its own lock and its own share of
+		the byte budget, and each evicting its least recently used entries once over its share.
+		Patterns that fail to compile are cached as well, so bad configuration isn't recompiled every time.
+	*/
+	template<typename T>
+	class RegexCache
+	{
+	public:
+		using FuncMapType = typename Regex<T>::FuncMapType;
+		using HandleType = std::shared_ptr<const Regex<T>>;
+
+		// Default byte budget across all shards.
+		static const size_t DefaultMemoryLimit = size_t(1) << 26;
+
+		static const int ShardCount = 16;
+		static const int DefaultMaxNestingDepth = 100;
+
+		explicit RegexCache(size_t inMemoryLimit = DefaultMemoryLimit) { SetMemoryLimit(inMemoryLimit); }
+
+		RegexCache(const RegexCache&) = delete;
+		RegexCache& operator=(const RegexCache&) = delete;
+
+		// Cache shared by the whole process.
+		static RegexCache& Global()
+		{
+			static RegexCache Instance;
+			return Instance;
+		}
+
+		// Returns the regex for the given pattern, compiling it if it isn't cached already.
+		HandleType Get(const std::basic_string<T>& Pattern, FuncMapType* Funcs = nullptr, int MaxNestingDepth = DefaultMaxNestingDepth)
+		{
+			KeyType Key{ Pattern, MaxNestingDepth, Funcs };
+			const size_t Hash = KeyHash()(Key);
+			Shard& TargetShard = Shards[Hash % ShardCount];
+
+			{
+				std::lock_guard<std::mutex> Lock(TargetShard.Mutex);
+
+				auto found = TargetShard.Entries.find(Key);
+				if (found != TargetShard.Entries.end())
+				{
+					// Move to the front, as the most recently used.
+					TargetShard.Order.splice(TargetShard.Order.begin(), TargetShard.Order, found->second);
+					++TargetShard.Hits;
+					return found->second->Handle;
+				}
+
+				++TargetShard.Misses;
+			}
+
+			// Compiled outside the lock, so lookups of other patterns in the same shard aren't held up.
+			HandleType Compiled = std::make_shared<const Regex<T>>(Pattern, Funcs, nullptr, MaxNestingDepth);
+			const size_t Bytes = Compiled->GetMemoryUsage() + sizeof(Entry) + Pattern.capacity() * sizeof(T);
+
+			std::lock_guard<std::mutex> Lock(TargetShard.Mutex);
+
+			// Someone else may have compiled the same pattern in the meantime, in which case theirs is kept.
+			auto found = TargetShard.Entries.find(Key);
+			if (found != TargetShard.Entries.end())
+			{
+				TargetShard.Order.splice(TargetShard.Order.begin(), TargetShard.Order, found->second);
+				return found->second->Handle;
+			}
+
+			TargetShard.Order.push_front(Entry{ Key, Compiled, Bytes });
+			TargetShard.Entries[Key] = TargetShard.Order.begin();
+			TargetShard.Bytes += Bytes;
+
+			Evict(TargetShard, ShardLimit);
+
+			return Compiled;
+		}
+
+		// Caps the bytes held by the cache, evicting as needed to fit.
+		void SetMemoryLimit(size_t Bytes)
+		{
+			MemoryLimit = Bytes;
+			ShardLimit = Bytes / ShardCount;
+
+			for (Shard& currShard : Shards)
+			{
+				std::lock_guard<std::mutex> Lock(currShard.Mutex);
+				Evict(currShard, Bytes / ShardCount);
+			}
+		}
+
+		size_t GetMemoryLimit() const { return MemoryLimit; }
+
+		// Drops every entry. Handles already given out stay valid.
+		void Clear()
+		{
+			for (Shard& currShard : Shards)
+			{
+				std::lock_guard<std::mutex> Lock(currShard.Mutex);
+				Evict(currShard, 0);
+			}
+		}
+
+		// Bytes held by the cache, entries, hits and misses, summed over every shard.
+		size_t GetMemoryUsage() const { return Sum([](const Shard& s) { return s.Bytes; }); }
+		size_t GetEntryCount() const { return Sum([](const Shard& s) { return s.Entries.size(); }); }
+		size_t GetHitCount() const { return Sum([](const Shard& s) { return s.Hits; }); }
+		size_t GetMissCount() const { return Sum([](const Shard& s) { return s.Misses; }); }
+
+	private:
+		struct KeyType
+		{
+			std::basic_string<T> Pattern;
+			int MaxNestingDepth;
+			FuncMapType* Funcs;
+
+			bool operator==(const KeyType& o) const { return MaxNestingDepth == o.MaxNestingDepth && Funcs == o.Funcs && Pattern == o.Pattern; }
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const KeyType& Key) const
+			{
+				size_t Out = std::hash<std::basic_string<T>>()(Key.Pattern);
+				Out ^= std::hash<int>()(Key.MaxNestingDepth) + 0x9e3779b9 + (Out << 6) + (Out >> 2);
+				Out ^= std::hash<FuncMapType*>()(Key.Funcs) + 0x9e3779b9 + (Out << 6) + (Out >> 2);
+				return Out;
+			}
+		};
+
+		struct Entry
+		{
+			KeyType Key;
+			HandleType Handle;
+			size_t Bytes;
+		};
+
+		struct Shard
+		{
+			mutable std::mutex Mutex;
+
+			// Most recently used first.
+			std::list<Entry> Order;
+			std::unordered_map<KeyType, typename std::list<Entry>::iterator, KeyHash> Entries;
+
+			size_t Bytes = 0;
+			size_t Hits = 0, Misses = 0;
+		};
+
+		Shard Shards[ShardCount];
+
+		std::atomic<size_t> MemoryLimit{ DefaultMemoryLimit };
+		std::atomic<size_t> ShardLimit{ DefaultMemoryLimit / ShardCount };
+
+		// Evicts the shard's least recently used entries until it's within the given number of bytes. The shard must be locked.
+		static void Evict(Shard& TargetShard, size_t Limit)
+		{
+			while (TargetShard.Bytes > Limit && !TargetShard.Order.empty())
+			{
+				Entry& Victim = TargetShard.Order.back();
+				TargetShard.Bytes -= Victim.Bytes;
+				TargetShard.Entries.erase(Victim.Key);
+				TargetShard.Order.pop_back();
+			}
+		}
+
+		template<typename FuncType>
+		size_t Sum(FuncType Func) const
+		{
+			size_t Out = 0;
+			for (const Shard& currShard : Shards)
+			{
+				std::lock_guard<std::mutex> Lock(currShard.Mutex);
+				Out += Func(currShard);
+			}
+			return Out;
+		}
+	};
+}
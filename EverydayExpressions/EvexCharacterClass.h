@@ -3,10 +3,51 @@
 #include "EvexRangeIterator.h"
 
 #include <vector>
+#include <cctype>
+#include <cstdint>
 
 
 namespace Evex
 {
+	/*
+		Set of 256 bits, one per possible byte value.
+		Used to reduce character class tests on single-byte regexes to a single lookup.
+	*/
+	struct RegexByteBitmap
+	{
+		uint64_t Bits[4] = { 0, 0, 0, 0 };
+
+		inline bool Test(unsigned char c) const { return 0 != (Bits[c >> 6] & (uint64_t(1) << (c & 63))); }
+		inline void Set(unsigned char c) { Bits[c >> 6] |= (uint64_t(1) << (c & 63)); }
+
+		inline void SetAll() { Bits[0] = Bits[1] = Bits[2] = Bits[3] = ~uint64_t(0); }
+
+		inline void Intersect(const RegexByteBitmap& o) { for (int i = 0; i < 4; ++i) Bits[i] &= o.Bits[i]; }
+		inline void Unite(const RegexByteBitmap& o) { for (int i = 0; i < 4; ++i) Bits[i] |= o.Bits[i]; }
+		inline void Subtract(const RegexByteBitmap& o) { for (int i = 0; i < 4; ++i) Bits[i] &= ~o.Bits[i]; }
+		inline void Invert() { for (int i = 0; i < 4; ++i) Bits[i] = ~Bits[i]; }
+
+		inline bool IsFull() const { return !~(Bits[0] & Bits[1] & Bits[2] & Bits[3]); }
+
+		inline bool Overlaps(const RegexByteBitmap& o) const { return 0 != ((Bits[0] & o.Bits[0]) | (Bits[1] & o.Bits[1]) | (Bits[2] & o.Bits[2]) | (Bits[3] & o.Bits[3])); }
+
+		// Gets the only byte present, or -1 if there isn't exactly one.
+		int SingleByte() const
+		{
+			int Found = -1;
+			for (int currByte = 0; currByte < 256; ++currByte)
+			{
+				if (Test((unsigned char)currByte))
+				{
+					if (Found >= 0)
+						return -1;
+					Found = currByte;
+				}
+			}
+			return Found;
+		}
+	};
+
 	template<typename T>
 	struct RegexCharacterClassSymbol
 	{
@@ -47,6 +88,23 @@ namespace Evex
 			}
 		}
 
+		// Sets every byte this symbol matches. Returns false for ligatures, which can't be represented per-byte.
+		bool FillBitmap(RegexByteBitmap& Out, bool CaseInsensitive)
+		{
+			if (Ligature)
+				return false;
+
+			for (int currByte = 0; currByte < 256; ++currByte)
+			{
+				T c = T(currByte);
+				if (CaseInsensitive ? (LowerByte(Characters[0]) <= LowerByte(c) && LowerByte(c) <= LowerByte(Characters[1]))
+									: (Characters[0] <= c && c <= Characters[1]))
+					Out.Set((unsigned char)currByte);
+			}
+
+			return true;
+		}
+
 		std::basic_string<T> Written()
 		{
 			std::basic_ostringstream<T> oss;
@@ -65,6 +123,10 @@ namespace Evex
 
 			return oss.str();
 		}
+
+	private:
+		// tolower which is safe to call on bytes above 127 where T is a signed char.
+		static inline T LowerByte(const T& c) { return T(tolower((unsigned char)c)); }
 	};
 
 	template<typename T>
@@ -75,9 +137,39 @@ namespace Evex
 
 		bool Negate = false;
 
+		// Byte lookup equivalent of this class. Only ever present on single-byte regexes.
+		bool HasBitmap = false;
+		RegexByteBitmap Bitmap;
+
 		// Is the given input present within this character class?
 		inline virtual bool Matches(IterType& Input) = 0;
 
+		// Computes Bitmap, if T is a single byte and the class contains no ligatures.
+		void BuildBitmap()
+		{
+			if (!HasBitmap && sizeof(T) == 1)
+			{
+				Bitmap = RegexByteBitmap();
+				HasBitmap = FillBitmap(Bitmap);
+			}
+		}
+
+		// Writes the set of bytes this class matches into the given bitmap. Returns false if that isn't possible.
+		virtual bool FillBitmap(RegexByteBitmap& Out) = 0;
+
+	protected:
+		// Shared by the binary classes; combines the bitmaps of both operands with the given operation.
+		static bool FillBitmapFrom(RegexCharacterClassBase* l, RegexCharacterClassBase* r, RegexByteBitmap& Out, void (RegexByteBitmap::*Combine)(const RegexByteBitmap&))
+		{
+			RegexByteBitmap rBits;
+			if (!l->FillBitmap(Out) || !r->FillBitmap(rBits))
+				return false;
+
+			(Out.*Combine)(rBits);
+			return true;
+		}
+
+	public:
 		// Outputs the written character class form of the given character class (without brackets!)
 		virtual StringType WrittenForm() = 0;
 	};
@@ -96,6 +188,9 @@ namespace Evex
 
 		inline bool Matches(IterType& Input) final
 		{
+			if (HasBitmap)
+				return Bitmap.Test((unsigned char)*Input);
+
 			bool Success = false;
 			for (RegexCharacterClassSymbol<T>* currSymb : Symbols)
 			{
@@ -108,6 +203,20 @@ namespace Evex
 			return (Negate ? !Success : Success);
 		}
 
+		bool FillBitmap(RegexByteBitmap& Out) final
+		{
+			for (RegexCharacterClassSymbol<T>* currSymb : Symbols)
+			{
+				if (!currSymb->FillBitmap(Out, CaseInsensitive))
+					return false;
+			}
+
+			if (Negate)
+				Out.Invert();
+
+			return true;
+		}
+
 		virtual StringType WrittenForm()
 		{
 			StringType out = (Negate ? "^" : "");
@@ -123,7 +232,8 @@ namespace Evex
 		RegexCharacterClassBase<T>* lhs = nullptr, *rhs = nullptr;
 
 		RegexSubtractCharacterClass(RegexCharacterClassBase<T>* l, RegexCharacterClassBase<T>* r) : lhs(l), rhs(r) {}
-		inline bool Matches(IterType& Input) final { return lhs->Matches(Input) && !rhs->Matches(Input); }
+		inline bool Matches(IterType& Input) final { return (HasBitmap ? Bitmap.Test((unsigned char)*Input) : lhs->Matches(Input) && !rhs->Matches(Input)); }
+		bool FillBitmap(RegexByteBitmap& Out) final { return FillBitmapFrom(lhs, rhs, Out, &RegexByteBitmap::Subtract); }
 		virtual StringType WrittenForm() { return (lhs->Negate ? "^" : "") + lhs->WrittenForm() + "-[" + rhs->WrittenForm() + "]"; }
 	};
 
@@ -133,7 +243,8 @@ namespace Evex
 		RegexCharacterClassBase<T>* lhs = nullptr, *rhs = nullptr;
 
 		RegexIntersectCharacterClass(RegexCharacterClassBase<T>* l, RegexCharacterClassBase<T>* r) : lhs(l), rhs(r) {}
-		inline bool Matches(IterType& Input) final { return lhs->Matches(Input) && rhs->Matches(Input); }
+		inline bool Matches(IterType& Input) final { return (HasBitmap ? Bitmap.Test((unsigned char)*Input) : lhs->Matches(Input) && rhs->Matches(Input)); }
+		bool FillBitmap(RegexByteBitmap& Out) final { return FillBitmapFrom(lhs, rhs, Out, &RegexByteBitmap::Intersect); }
 		virtual StringType WrittenForm() { return (lhs->Negate ? "^" : "") + lhs->WrittenForm() + "&&[" + rhs->WrittenForm() + "]"; }
 	};
 
@@ -143,7 +254,8 @@ namespace Evex
 		RegexCharacterClassBase<T>* lhs = nullptr, *rhs = nullptr;
 
 		RegexUnionCharacterClass(RegexCharacterClassBase<T>* l, RegexCharacterClassBase<T>* r) : lhs(l), rhs(r) {}
-		inline bool Matches(IterType& Input) final { return lhs->Matches(Input) || rhs->Matches(Input); }
+		inline bool Matches(IterType& Input) final { return (HasBitmap ? Bitmap.Test((unsigned char)*Input) : lhs->Matches(Input) || rhs->Matches(Input)); }
+		bool FillBitmap(RegexByteBitmap& Out) final { return FillBitmapFrom(lhs, rhs, Out, &RegexByteBitmap::Unite); }
 		virtual StringType WrittenForm() { return (lhs->Negate ? "^" : "") + lhs->WrittenForm() + "[" + rhs->WrittenForm() + "]"; }
 	};
 }
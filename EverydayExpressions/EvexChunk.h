@@ -1,10 +1,54 @@
 #pragma once
 
 #include "EvexNode.h"
+#include "EvexStateTable.h"
 
 
 namespace Evex
 {
+	/*
+		Adds a group node to the chain of groups enclosing a sub-match, for as long as it's in scope.
+		Chains are appended to in place rather than copied, and a fresh chain is borrowed from the match
+		context's pool when there's none to carry on from, or when asked for one.
+	*/
+	template<typename T>
+	struct RegexOutersScope
+	{
+		RegexMatchContext<T>& MatchContext;
+		std::vector<const RegexNode<T>*>* Chain;
+		bool Borrowed;
+
+		RegexOutersScope(RegexMatchContext<T>& inMatchContext, std::vector<const RegexNode<T>*>* Outers, const RegexNode<T>* Node)
+			: MatchContext(inMatchContext), Chain(Outers), Borrowed(nullptr == Outers)
+		{
+			if (Borrowed)
+			{
+				if (MatchContext.OuterChainsInUse == MatchContext.OuterChains.size())
+					MatchContext.OuterChains.emplace_back();
+				Chain = &MatchContext.OuterChains[MatchContext.OuterChainsInUse++];
+				Chain->clear();
+			}
+
+			if (Node)
+				Chain->push_back(Node);
+		}
+
+		RegexOutersScope(const RegexOutersScope&) = delete;
+		RegexOutersScope& operator=(const RegexOutersScope&) = delete;
+
+		~RegexOutersScope()
+		{
+			if (Borrowed)
+				--MatchContext.OuterChainsInUse;
+			else
+				Chain->pop_back();
+		}
+	};
+
+	/*
+		A piece of the automaton under construction. Chunks and their nodes are made in their regex's
+		arena and never freed individually, so dropping a chunk doesn't free its nodes either.
+	*/
 	template<typename T>
 	struct RegexChunk
 	{
@@ -12,68 +56,73 @@ namespace Evex
 		std::vector<RegexNodeGhostIn<T>> Ins;
 		std::vector<RegexNodeGhostOut<T>> Outs;
 
-		~RegexChunk() { for (RegexNode<T>* curr : Nodes) delete curr; }
-
 		std::unordered_set<RegexChunk*> ConnectedTos;
 
 		using IterType = RegexRangeIterator<T>;
 		static bool Match(const IterType& Input,
-			std::unordered_set<RegexNodeGhostIn<T>*>& Ins,
-			std::unordered_set<RegexNodeGhostOut<T>*> Outs,
+			const RegexStateTable<T>& Table,
+			int Context,
+			RegexMatchContext<T>& MatchContext,
 			bool Lazy,
 			IterType& OutMatchEnd,
-			std::vector<RegexNode<T>*>* Outers = nullptr,
+			std::vector<const RegexNode<T>*>* Outers = nullptr,
 			bool IterateReverse = false)
 		{
 			OutMatchEnd = Input;
 			
-			std::unordered_map<RegexLoopNode<T>*, int> StoredTimes;
+			// Tickers looped on within this sub-match start over, and get their times back once it's done.
+			std::vector<std::pair<int, int>>& StoredTimes = MatchContext.StoredTickerTimes;
+			const size_t StoredBase = StoredTimes.size();
 
-			std::vector<RegexNode<T>*> CurrentNexts;
+			const int* CurrNextsBegin = nullptr, *CurrNextsEnd = nullptr;
+			Table.GetEntries(Context, CurrNextsBegin, CurrNextsEnd);
 
-			for (RegexNodeGhostIn<T>* currIn : Ins)
-			{
-				std::vector<RegexNode<T>*> NextReals = currIn->GetNexts();
-				CurrentNexts.insert(CurrentNexts.end(), NextReals.begin(), NextReals.end());
-			}
-
-			RegexNode<T>* CurrNode = nullptr;
+			int CurrState = -1;
 			IterType LastMatch = OutMatchEnd;
-			while (CurrentNexts.size() > 0 && !(IterateReverse ? OutMatchEnd.IsPreBegin() : OutMatchEnd.IsEnd()))
+
+			// Whether the last state entered took no input, having stepped back to give way to what follows it.
+			bool GaveWay = false;
+			while (CurrNextsBegin != CurrNextsEnd && !(IterateReverse ? OutMatchEnd.IsPreBegin() : OutMatchEnd.IsEnd()))
 			{
-				bool NewNodeFound = false;
-				for (RegexNode<T>* currNext : CurrentNexts)
+				const T* EnteredAt = OutMatchEnd;
+
+				int NextState = -1;
+				for (const int* currNext = CurrNextsBegin; currNext != CurrNextsEnd; ++currNext)
 				{
-					RegexLoopNode<T>* AsLoop = dynamic_cast<RegexLoopNode<T>*>(currNext);
-					if (AsLoop && AsLoop->BoundTicker && StoredTimes.find(AsLoop) == StoredTimes.end())
+					// Entering it again at the same place would only give way again, e.g. a star looping on itself.
+					if (GaveWay && *currNext == CurrState)
+						continue;
+
+					RegexTicker<T>* LoopTicker = Table.LoopTickers[*currNext];
+					if (LoopTicker && !IsTickerStored(StoredTimes, StoredBase, LoopTicker->Slot))
 					{
-						StoredTimes[AsLoop] = AsLoop->BoundTicker->CurrTimes;
-						AsLoop->BoundTicker->Reset();
+						StoredTimes.emplace_back(LoopTicker->Slot, MatchContext.TickerTimes[LoopTicker->Slot]);
+						LoopTicker->Reset(MatchContext);
 					}
 
-					if (currNext->CanEnter(OutMatchEnd, Outers))
+					if (RegexEnterNode(Table.States[*currNext], OutMatchEnd, MatchContext, Outers))
 					{
-						CurrNode = currNext;
-						NewNodeFound = true;
+						NextState = *currNext;
 						break;
 					}
 				}
 
-				if (!NewNodeFound)
+				if (NextState < 0)
 					break;
 
-				CurrentNexts = CurrNode->GetNexts();
+				CurrState = NextState;
+				GaveWay = (IterateReverse ? EnteredAt < OutMatchEnd : OutMatchEnd < EnteredAt);
+				Table.GetSuccessors(CurrState, MatchContext, CurrNextsBegin, CurrNextsEnd);
 
-				for (RegexNodeGhostOut<T>* currGhost : CurrNode->GhostNexts)
+				if (Table.IsAccepting(CurrState, Context, MatchContext))
 				{
-					if (Outs.find(currGhost) != Outs.end())
+					if (Lazy)
 					{
-						if (Lazy)
-							return true;
-						else
-							LastMatch = OutMatchEnd;
-						break;
+						StoredTimes.resize(StoredBase);
+						return true;
 					}
+					else
+						LastMatch = OutMatchEnd;
 				}
 
 				if (IterateReverse)
@@ -87,17 +136,15 @@ namespace Evex
 			else
 				--OutMatchEnd;
 
-			for (auto& currPair : StoredTimes)
-				currPair.first->BoundTicker->CurrTimes = currPair.second;
+			// Checked before the tickers get their times back, as the last state's gate may be one of them.
+			const bool Accepted = CurrState >= 0 && Table.IsAccepting(CurrState, Context, MatchContext);
 
-			if (CurrNode)
-			{
-				for (RegexNodeGhostOut<T>* CurrOut : CurrNode->GhostNexts)
-				{
-					if (Outs.find(CurrOut) != Outs.end())
-						return true;
-				}
-			}
+			for (size_t i = StoredBase; i < StoredTimes.size(); ++i)
+				MatchContext.TickerTimes[StoredTimes[i].first] = StoredTimes[i].second;
+			StoredTimes.resize(StoredBase);
+
+			if (Accepted)
+				return true;
 
 			if (LastMatch != Input)
 			{
@@ -108,6 +155,18 @@ namespace Evex
 			return false;
 		}
 
+		// Whether the ticker in the given slot was already set aside by the sub-match whose entries start at Base.
+		static inline bool IsTickerStored(const std::vector<std::pair<int, int>>& StoredTimes, size_t Base, int Slot)
+		{
+			for (size_t i = Base; i < StoredTimes.size(); ++i)
+			{
+				if (StoredTimes[i].first == Slot)
+					return true;
+			}
+
+			return false;
+		}
+
 		using StringType = std::basic_string<T>;
 		static void Draw(std::unordered_set<RegexNodeGhostIn<T>*>& Ins,
 			std::unordered_map<StringType, int>& TypeNumbers,
@@ -157,34 +216,39 @@ namespace Evex
 			OutStr += Indent + "}\n";
 		}
 
-		bool ContainsNode(const RegexNodeBase<T>* Node)
-		{
-			if (const RegexNode<T>* AsNode = dynamic_cast<const RegexNode<T>*>(Node))
-				return Node->Index >= 0 && Node->Index < Nodes.size() && Nodes[Node->Index] == AsNode;
-			else if (const RegexNodeGhostIn<T>* AsGhostIn = dynamic_cast<const RegexNodeGhostIn<T>*>(Node))
-				return Node->Index >= 0 && Node->Index < Ins.size() && &Ins[Node->Index] == AsGhostIn;
-			else if (const RegexNodeGhostOut<T>* AsGhostOut = dynamic_cast<const RegexNodeGhostOut<T>*>(Node))
-				return Node->Index >= 0 && Node->Index < Outs.size() && &Outs[Node->Index] == AsGhostOut;
+		inline bool ContainsNode(const RegexNodeBase<T>* Node) const { return this == Node->Owner; }
 
-			return false;
+		// Places a node or ghost at the given index of this chunk.
+		inline void Adopt(RegexNodeBase<T>& Node, unsigned int Index)
+		{
+			Node.Index = Index;
+			Node.Owner = this;
 		}
 
-		RegexChunk* Clone()
+		RegexChunk* Clone(RegexArena& Arena)
 		{
-			RegexChunk* Out = new RegexChunk();
+			RegexChunk* Out = Arena.New<RegexChunk>();
 			Out->Ins = Ins;
 			Out->Outs = Outs;
 			for (RegexNode<T>* currNode : Nodes)
-				Out->Nodes.push_back(currNode->Clone());
+				Out->Nodes.push_back(currNode->Clone(Arena));
+
+			for (unsigned int i = 0; i < Out->Nodes.size(); ++i)
+				Out->Adopt(*Out->Nodes[i], i);
+			for (unsigned int i = 0; i < Out->Ins.size(); ++i)
+				Out->Adopt(Out->Ins[i], i);
+			for (unsigned int i = 0; i < Out->Outs.size(); ++i)
+				Out->Adopt(Out->Outs[i], i);
+
 			return Out;
 		}
 
 		// "a", "a-z", ".", etc.
-		static inline RegexChunk* Literal(const std::unordered_set<RegexCharacterClassBase<T>*>& CharClasses)
+		static inline RegexChunk* Literal(RegexArena& Arena, const std::unordered_set<RegexCharacterClassBase<T>*>& CharClasses)
 		{
-			RegexChunk* Out = new RegexChunk();
+			RegexChunk* Out = Arena.New<RegexChunk>();
 
-			Out->Nodes.push_back(new RegexNode<T>(CharClasses));
+			Out->Nodes.push_back(Arena.New<RegexNode<T>>(CharClasses));
 
 			Out->Ins.push_back(RegexNodeGhostIn<T>());
 			Out->Outs.push_back(RegexNodeGhostOut<T>());
@@ -192,17 +256,17 @@ namespace Evex
 			Out->Ins[0].Nexts.insert(Out->Nodes[0]);
 			Out->Nodes[0]->GhostNexts.insert(&Out->Outs[0]);
 
-			Out->Nodes[0]->Index = 0;
-			Out->Ins[0].Index = 0;
-			Out->Outs[0].Index = 0;
+			Out->Adopt(*Out->Nodes[0], 0);
+			Out->Adopt(Out->Ins[0], 0);
+			Out->Adopt(Out->Outs[0], 0);
 
 			return Out;
 		}
 
 		// wrapping a lone node, usually a group node, with a chunk
-		static inline RegexChunk* Wrap(RegexNode<T>* Node)
+		static inline RegexChunk* Wrap(RegexArena& Arena, RegexNode<T>* Node)
 		{
-			RegexChunk* Out = new RegexChunk();
+			RegexChunk* Out = Arena.New<RegexChunk>();
 
 			Out->Nodes.push_back(Node);
 			Out->Ins.push_back(RegexNodeGhostIn<T>());
@@ -211,9 +275,9 @@ namespace Evex
 			Out->Ins[0].Nexts.insert(Out->Nodes[0]);
 			Out->Nodes[0]->GhostNexts.insert(&Out->Outs[0]);
 
-			Out->Nodes[0]->Index = 0;
-			Out->Ins[0].Index = 0;
-			Out->Outs[0].Index = 0;
+			Out->Adopt(*Out->Nodes[0], 0);
+			Out->Adopt(Out->Ins[0], 0);
+			Out->Adopt(Out->Outs[0], 0);
 
 			return Out;
 		}
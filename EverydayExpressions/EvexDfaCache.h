@@ -0,0 +1,119 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+
+namespace Evex
+{
+	/*
+		Lazily filled byte transition cache for the purely regular parts of an automaton.
+
+		Each row stands for one frontier, i.e. the ordered candidate list the matcher picks from,
+		and holds the state entered from it for every possible input byte. Rows are only handed
+		out for frontiers made entirely of plain nodes, since only those give the same answer for
+		the same byte every time.
+
+		Row memory is capped; once the cap is reached, the least recently filled row is evicted.
+	*/
+	class RegexDfaCache
+	{
+	public:
+		enum : int
+		{
+			// Transition not computed yet.
+			Unknown = -2,
+
+			// No candidate accepts the byte.
+			Dead = -1
+		};
+
+		// Default cap on cached row memory, in bytes.
+		static const size_t DefaultMemoryLimit = 1 << 21;
+
+		// Sets up the cache for the given number of rows, of which only those flagged may be cached.
+		void Reset(const std::vector<bool>& inEligible)
+		{
+			Eligible = inEligible;
+			RowSlots.assign(Eligible.size(), -1);
+			SlotRows.clear();
+			Entries.clear();
+			NextVictim = 0;
+		}
+
+		// Drops every cached transition, keeping which rows are eligible.
+		void Flush()
+		{
+			RowSlots.assign(Eligible.size(), -1);
+			SlotRows.clear();
+			Entries.clear();
+			NextVictim = 0;
+		}
+
+		void SetMemoryLimit(size_t Bytes)
+		{
+			MemoryLimit = Bytes;
+			Flush();
+		}
+
+		size_t GetMemoryLimit() const { return MemoryLimit; }
+
+		inline bool IsEligible(int Row) const { return Eligible[Row]; }
+
+		// Gets the 256 transitions of the given row, allocating (and possibly evicting) if needed. Returns nullptr if ineligible.
+		inline int* GetRow(int Row)
+		{
+			if (!Eligible[Row])
+				return nullptr;
+
+			int Slot = RowSlots[Row];
+			if (Slot < 0)
+				Slot = AllocateSlot(Row);
+
+			return Entries.data() + (size_t(Slot) << 8);
+		}
+
+	private:
+		std::vector<bool> Eligible;
+
+		// Slot each row is cached in (or -1), and the row occupying each slot.
+		std::vector<int> RowSlots;
+		std::vector<int> SlotRows;
+
+		// 256 entries per slot.
+		std::vector<int> Entries;
+
+		size_t MemoryLimit = DefaultMemoryLimit;
+
+		// Slots are evicted in the order they were filled.
+		int NextVictim = 0;
+
+		int AllocateSlot(int Row)
+		{
+			const size_t SlotBytes = 256 * sizeof(int);
+			size_t MaxSlots = MemoryLimit / SlotBytes;
+			if (MaxSlots < 1)
+				MaxSlots = 1;
+
+			int Slot;
+			if (SlotRows.size() < MaxSlots)
+			{
+				Slot = int(SlotRows.size());
+				SlotRows.push_back(Row);
+				Entries.resize(Entries.size() + 256);
+			}
+			else
+			{
+				Slot = NextVictim;
+				NextVictim = int((NextVictim + 1) % SlotRows.size());
+
+				RowSlots[SlotRows[Slot]] = -1;
+				SlotRows[Slot] = Row;
+			}
+
+			RowSlots[Row] = Slot;
+			std::fill(Entries.begin() + (size_t(Slot) << 8), Entries.begin() + (size_t(Slot + 1) << 8), Unknown);
+			return Slot;
+		}
+	};
+}
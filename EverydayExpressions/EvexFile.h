@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Evex.h"
+
+#include <string>
+#include <string_view>
+#include <limits>
+
+// Last, as it brings in the platform's file mapping headers. See the note there.
+#include "EvexMappedFile.h"
+
+
+namespace Evex
+{
+	/*
+		Matching against files mapped into memory rather than read into a string first. Kept apart from Evex.h so
+		only those who include this take on the platform headers it needs.
+		Offsets are from the start of the file, counted in T's.
+	*/
+
+	// A mapped file's contents as a string of T's.
+	template<typename T>
+	std::basic_string_view<T> MappedFileView(const RegexMappedFile& File)
+	{
+		const size_t Length = File.GetSize() / sizeof(T);
+
+		// Match offsets are ptrdiff_t's, which only fall short of a mapping's size on 32-bit builds.
+		if (Length > size_t(std::numeric_limits<ptrdiff_t>::max()))
+			throw RegexFileException("File is too large to match as a single input. Scan it with a RegexStreamScanner instead.");
+
+		return std::basic_string_view<T>(reinterpret_cast<const T*>(File.GetData()), Length);
+	}
+
+	// MatchAll over a file mapped with a RegexMappedFile of your own, so the results' views stay usable as long as it's kept mapped.
+	template<typename T>
+	bool MatchAllInFile(RegexMatchContext<T>& MatchContext, const Regex<T>& Pattern, const RegexMappedFile& File, RegexMatchResults<T>& OutResults, unsigned int ThreadCount = 1)
+	{
+		return Pattern.MatchAll(MatchContext, MappedFileView<T>(File), OutResults, ThreadCount);
+	}
+
+	/*
+		MatchAll over the file at the given path. The file is unmapped before returning, so views of the results are empty;
+		map it with a RegexMappedFile of your own to keep them usable. Throws a RegexFileException if the file can't be mapped.
+	*/
+	template<typename T>
+	bool MatchAllInFile(RegexMatchContext<T>& MatchContext, const Regex<T>& Pattern, const std::string& Path, RegexMatchResults<T>& OutResults, unsigned int ThreadCount = 1)
+	{
+		bool Success = false;
+		{
+			RegexMappedFile File(Path);
+			Success = MatchAllInFile(MatchContext, Pattern, File, OutResults, ThreadCount);
+		}
+
+		Pattern.ForgetInput(MatchContext, OutResults);
+		return Success;
+	}
+
+	// As above, matching through the regex's own context.
+	template<typename T>
+	bool MatchAllInFile(Regex<T>& Pattern, const RegexMappedFile& File, RegexMatchResults<T>& OutResults, unsigned int ThreadCount = 1)
+	{
+		return Pattern.MatchAll(MappedFileView<T>(File), OutResults, ThreadCount);
+	}
+
+	template<typename T>
+	bool MatchAllInFile(Regex<T>& Pattern, const std::string& Path, RegexMatchResults<T>& OutResults, unsigned int ThreadCount = 1)
+	{
+		bool Success = false;
+		{
+			RegexMappedFile File(Path);
+			Success = MatchAllInFile(Pattern, File, OutResults, ThreadCount);
+		}
+
+		Pattern.ForgetInput(OutResults);
+		return Success;
+	}
+}
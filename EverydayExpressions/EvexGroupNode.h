@@ -19,29 +19,52 @@ namespace Evex
 		std::unordered_set<RegexNodeGhostOut<T>*> Outs;
 	
 		bool LazyGroup = false;
+
+		// The flattened automaton this group's insides are matched against, and which of its contexts they occupy.
+		const RegexStateTable<T>* Table = nullptr;
+		int Context = -1;
+	
+		// Whether this group's insides are matched from end to beginning, as they are within a lookbehind.
+		bool IterateReverse = false;
+	
+		RegexGroupNode() : RegexNode<T>(RegexNodeKind::Group) {}
+		explicit RegexGroupNode(RegexNodeKind inKind) : RegexNode<T>(inKind) {}
 	
-		inline virtual RegexNode* Clone()
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::Group <= inKind && inKind <= RegexNodeKind::Conditional; }
+	
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexGroupNode* Out = new RegexGroupNode();
+			RegexGroupNode* Out = Arena.New<RegexGroupNode>();
 			Out->Chunks = Chunks;
 			Out->Ins = Ins;
 			Out->Outs = Outs;
 			Out->LazyGroup = LazyGroup;
+			Out->IterateReverse = IterateReverse;
 			return Out;
 		}
 	
+		// Whether this group's insides can be flipped to match from end to beginning. Not so for groups which look elsewhere.
+		inline virtual bool CanIterateReverse() const { return true; }
+	
+		// Undoes the step taken past this node once it's entered, for when it took no input.
+		inline void StepBack(IterType& Input) const
+		{
+			if (IterateReverse)
+				++Input;
+			else
+				--Input;
+		}
+	
 		// Groups should never be similar to other groups.
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const { return false; }
+		inline size_t Signature() const final { return 0; }
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr)
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const
 		{
 			IterType Copy;
 	
-			std::vector<RegexNode<T>*> AppendOuters;
-			if (nullptr != Outers)
-				AppendOuters = *Outers;
-			AppendOuters.push_back(this);
-			if (RegexChunk<T>::Match(Input, Ins, Outs, LazyGroup, Copy, &AppendOuters))
+			RegexOutersScope<T> AppendOuters(MatchContext, Outers, this);
+			if (RegexChunk<T>::Match(Input, *Table, Context, MatchContext, LazyGroup, Copy, AppendOuters.Chain, IterateReverse))
 			{
 				Input = Copy;
 				return true;
@@ -85,10 +108,13 @@ namespace Evex
 	{
 		bool Negative = false;
 	
-		RegexLookAheadNode(bool Negate) : Negative(Negate) {}
-		inline virtual RegexNode* Clone()
+		RegexLookAheadNode(bool Negate) : RegexGroupNode<T>(RegexNodeKind::LookAhead), Negative(Negate) {}
+	
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::LookAhead == inKind; }
+	
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexLookAheadNode* Out = new RegexLookAheadNode(Negative);
+			RegexLookAheadNode* Out = Arena.New<RegexLookAheadNode>(Negative);
 			Out->Chunks = Chunks;
 			Out->Ins = Ins;
 			Out->Outs = Outs;
@@ -99,11 +125,13 @@ namespace Evex
 		// lookaheads should never be similar to other lookaheads
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return false; }
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline bool CanIterateReverse() const final { return false; }
+	
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
 			IterType Copy;
 	
-			bool Success = RegexChunk<T>::Match(Input, Ins, Outs, LazyGroup, Copy);
+			bool Success = RegexChunk<T>::Match(Input, *Table, Context, MatchContext, LazyGroup, Copy);
 	
 			return (Negative ? !Success : Success);
 		}
@@ -142,11 +170,13 @@ namespace Evex
 	{
 		bool Negative = false;
 	
-		RegexLookBehindNode(bool Negate) : Negative(Negate) {}
+		RegexLookBehindNode(bool Negate) : RegexGroupNode<T>(RegexNodeKind::LookBehind), Negative(Negate) {}
 	
-		inline virtual RegexNode* Clone()
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::LookBehind == inKind; }
+	
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexLookBehindNode* Out = new RegexLookBehindNode(Negative);
+			RegexLookBehindNode* Out = Arena.New<RegexLookBehindNode>(Negative);
 			Out->Chunks = Chunks;
 			Out->Ins = Ins;
 			Out->Outs = Outs;
@@ -157,13 +187,16 @@ namespace Evex
 		// lookbehinds should never be similar to other lookbehinds
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return false; }
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline bool CanIterateReverse() const final { return false; }
+	
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
 			IterType InputBackOne = Input, Copy;
 			--InputBackOne;
 	
-			std::vector<RegexNode<T>*> DummyOuters;
-			bool Success = RegexChunk<T>::Match(InputBackOne, Ins, Outs, LazyGroup, Copy, &DummyOuters, true);
+			// Nothing outside is looked at from within, so the chain of enclosing groups starts afresh.
+			RegexOutersScope<T> OwnOuters(MatchContext, nullptr, nullptr);
+			bool Success = RegexChunk<T>::Match(InputBackOne, *Table, Context, MatchContext, LazyGroup, Copy, OwnOuters.Chain, true);
 	
 			Success = (Negative ? !Success : Success);
 	
@@ -200,59 +233,114 @@ namespace Evex
 	
 	// Basic Capture-based nodes, i.e. Capture Group and Backreference.
 	
+	/*
+		Describes a capture. What the capture holds during a match is kept in a RegexCaptureState
+		within the match context, at Slot.
+	*/
 	template<typename T>
 	struct RegexCaptureBase
 	{
+		// Index of this capture's state within a match context.
+		int Slot = -1;
 
 		// The initial value for LastCapture. Always equals the first node which touches the group.
 		RegexNode<T>* InitialCapture = nullptr;
 
-		// The last group that set this capture. Used exclusively by subroutine nodes.
-		RegexNode<T>* LastCapture = nullptr;
-	
-		// Indicates whether the capture was successful, i.e. that it was both reached and written to.
-		bool Succeeded = false;
-
 		// Indicates that this capture is to be set by the user. Used in pre-match reset functionality within Evex::Regex.
 		bool Manual = false;
+
+		// Whether this keeps every range captured, i.e. is a RegexCaptureCollection, rather than only the latest.
+		const bool IsCollection = false;
+
+		explicit RegexCaptureBase(bool Collection) : IsCollection(Collection) {}
+
+		inline RegexCaptureState<T>& GetState(RegexMatchContext<T>& MatchContext) const { return MatchContext.Captures[Slot]; }
+		inline const RegexCaptureState<T>& GetState(const RegexMatchContext<T>& MatchContext) const { return MatchContext.Captures[Slot]; }
 	
-		virtual std::basic_string<T> GetCapture() const = 0;
-		virtual void SetCapture(std::basic_string<T> NewCapture, bool Reset = false) = 0;
-		virtual void Reset() { LastCapture = InitialCapture; }
+		// Gets the latest captured range, if any. It points either into the matched input or at a pre-set value held by the state.
+		bool GetCaptureRange(const RegexMatchContext<T>& MatchContext, const T*& OutBegin, const T*& OutEnd) const
+		{
+			const RegexCaptureState<T>& State = GetState(MatchContext);
+			if (State.Ranges.empty())
+				return false;
+
+			OutBegin = State.Ranges.back().first;
+			OutEnd = State.Ranges.back().second;
+			return true;
+		}
+
+		// Records a range of the matched input as captured, without copying it.
+		virtual void SetCaptureRange(RegexCaptureState<T>& State, const T* Begin, const T* End) const = 0;
+
+		std::basic_string<T> GetCapture(const RegexMatchContext<T>& MatchContext) const
+		{
+			const T* Begin = nullptr, *End = nullptr;
+			return (GetCaptureRange(MatchContext, Begin, End) ? std::basic_string<T>(Begin, End) : std::basic_string<T>());
+		}
+
+		// Stores a copy of the given value as captured. Used for pre-set captures, which don't come from the input.
+		virtual void SetCapture(RegexMatchContext<T>& MatchContext, std::basic_string<T> NewCapture, bool Reset = false) const = 0;
+
+		void Reset(RegexMatchContext<T>& MatchContext) const
+		{
+			RegexCaptureState<T>& State = GetState(MatchContext);
+			State.Ranges.clear();
+			State.PresetInputs.clear();
+			State.LastCapture = InitialCapture;
+			State.Succeeded = false;
+		}
 	};
 	
+	/*
+		Since the line of nodes this produces will only ever be a straight line,
+		we can save a little bit of space by having the captured range also be
+		the (pretend) node list we traverse when within a backreference.
+	*/
 	template<typename T>
 	struct RegexCapture : public RegexCaptureBase<T>
 	{
-		/*
-			Since the line of nodes this produces will only ever be a straight line,
-			we can save a little bit of space by having the captured inputs also be
-			the (pretend) node list we traverse when within a backreference.
-		*/
-		std::basic_string<T> CapturedInputs;
-	
-		std::basic_string<T> GetCapture() const final { return CapturedInputs; }
-		void SetCapture(std::basic_string<T> NewCapture, bool Reset = false) final { CapturedInputs = NewCapture; Succeeded = true; }
-		void Reset() final { RegexCaptureBase<T>::Reset(); CapturedInputs.clear(); }
+		RegexCapture() : RegexCaptureBase<T>(false) {}
+
+		// Only the latest range is ever kept.
+		void SetCaptureRange(RegexCaptureState<T>& State, const T* Begin, const T* End) const final
+		{
+			State.Ranges.assign(1, std::make_pair(Begin, End));
+			State.Succeeded = true;
+		}
+
+		void SetCapture(RegexMatchContext<T>& MatchContext, std::basic_string<T> NewCapture, bool Reset = false) const final
+		{
+			RegexCaptureState<T>& State = GetState(MatchContext);
+			State.PresetInputs.clear();
+			State.PresetInputs.push_back(NewCapture);
+			SetCaptureRange(State, State.PresetInputs.back().data(), State.PresetInputs.back().data() + State.PresetInputs.back().size());
+		}
 	};
 	
+	// NOTE: GetCaptureRange gets only the latest(!) capture in a capture collection.
 	template<typename T>
 	struct RegexCaptureCollection : public RegexCaptureBase<T>
 	{
-		std::vector<std::basic_string<T>> CapturedInputs;
-	
-		// NOTE: gets only the latest(!) capture in a capture collection.
-		std::basic_string<T> GetCapture() const final { return (CapturedInputs.empty() ? "" : CapturedInputs.back()); }
-		void SetCapture(std::basic_string<T> NewCapture, bool Reset = false) final
+		RegexCaptureCollection() : RegexCaptureBase<T>(true) {}
+
+		void SetCaptureRange(RegexCaptureState<T>& State, const T* Begin, const T* End) const final
+		{
+			State.Ranges.emplace_back(Begin, End);
+			State.Succeeded = true;
+		}
+
+		void SetCapture(RegexMatchContext<T>& MatchContext, std::basic_string<T> NewCapture, bool Reset = false) const final
 		{
+			RegexCaptureState<T>& State = GetState(MatchContext);
 			if (Reset)
-				CapturedInputs.clear();
-	
-			CapturedInputs.push_back(NewCapture);
+			{
+				State.Ranges.clear();
+				State.PresetInputs.clear();
+			}
 	
-			Succeeded = true;
+			State.PresetInputs.push_back(NewCapture);
+			SetCaptureRange(State, State.PresetInputs.back().data(), State.PresetInputs.back().data() + State.PresetInputs.back().size());
 		}
-		void Reset() final { RegexCaptureBase<T>::Reset(); CapturedInputs.clear(); }
 	};
 	
 	/*
@@ -266,48 +354,58 @@ namespace Evex
 		std::basic_string<T> CaptureName;
 		RegexCaptureBase<T>* BoundCapture = nullptr;
 	
-		RegexCaptureNode(std::basic_string<T>& CapName) : CaptureName(CapName) {}
+		RegexCaptureNode(std::basic_string<T>& CapName) : RegexGroupNode<T>(RegexNodeKind::Capture), CaptureName(CapName) {}
+	
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::Capture == inKind; }
 	
-		inline virtual RegexNode* Clone()
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexCaptureNode* Out = new RegexCaptureNode(CaptureName);
+			RegexCaptureNode* Out = Arena.New<RegexCaptureNode>(CaptureName);
 			Out->BoundCapture = BoundCapture;
 			Out->Chunks = Chunks;
 			Out->Ins = Ins;
 			Out->Outs = Outs;
 			Out->LazyGroup = LazyGroup;
+			Out->IterateReverse = IterateReverse;
 			return Out;
 		}
 	
 		// Captures should never be similar to other captures.
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return false; }
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
 			if (BoundCapture)
 			{
-				BoundCapture->Succeeded = false;
+				RegexCaptureState<T>& CapState = BoundCapture->GetState(MatchContext);
+				CapState.Succeeded = false;
 	
 				IterType Copy;
 	
-				std::vector<RegexNode<T>*> AppendOuters;
-				if (nullptr != Outers)
-					AppendOuters = *Outers;
-				AppendOuters.push_back(this);
-				if (RegexChunk<T>::Match(Input, Ins, Outs, LazyGroup, Copy, &AppendOuters))
+				RegexOutersScope<T> AppendOuters(MatchContext, Outers, this);
+				if (RegexChunk<T>::Match(Input, *Table, Context, MatchContext, LazyGroup, Copy, AppendOuters.Chain, IterateReverse))
 				{
-					std::basic_string<T> NewCappedInputs;
-					for (IterType iter = Input; iter < Copy; ++iter)
-						NewCappedInputs += *iter;
+					const bool ZeroWidth = (IterateReverse ? Input < Copy : Copy < Input);
 	
-					if (!Copy.IsEnd() && Copy >= Input)
-						NewCappedInputs += *Copy;
+					// Copy sits on the last character taken, unless the match was zero-width or ran up to the end.
+					// Matched in reverse, the last character taken is the first of the capture.
+					const T* CapBegin = nullptr, *CapEnd = nullptr;
+					if (IterateReverse)
+					{
+						CapEnd = (const T*)Input + 1;
+						CapBegin = (ZeroWidth ? CapEnd : (const T*)Copy);
+					}
+					else
+					{
+						CapBegin = Input;
+						CapEnd = (ZeroWidth ? CapBegin : (Copy.IsEnd() ? (const T*)Copy : (const T*)Copy + 1));
+					}
 	
-					BoundCapture->SetCapture(NewCappedInputs);
-					BoundCapture->LastCapture = this;
+					BoundCapture->SetCaptureRange(CapState, CapBegin, CapEnd);
+					CapState.LastCapture = this;
 	
-					if (Copy < Input) // zero-width match
-						--Input;
+					if (ZeroWidth)
+						StepBack(Input);
 					else
 						Input = Copy;
 	
@@ -353,18 +451,20 @@ namespace Evex
 		std::basic_string<T> CaptureName;
 		const RegexCaptureBase<T>* BoundCapture = nullptr;
 	
-		RegexBackreferenceNode(std::basic_string<T>& CapName) : CaptureName(CapName) {}
+		RegexBackreferenceNode(std::basic_string<T>& CapName) : RegexNode<T>(RegexNodeKind::Backreference), CaptureName(CapName) {}
+	
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::Backreference == inKind; }
 	
-		inline virtual RegexNode* Clone()
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexBackreferenceNode* Out = new RegexBackreferenceNode(CaptureName);
+			RegexBackreferenceNode* Out = Arena.New<RegexBackreferenceNode>(CaptureName);
 			Out->BoundCapture = BoundCapture;
 			return Out;
 		}
 	
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final
 		{
-			const RegexBackreferenceNode* AsBackrefNode = dynamic_cast<const RegexBackreferenceNode*>(o);
+			const RegexBackreferenceNode* AsBackrefNode = RegexNodeCast<const RegexBackreferenceNode>(o);
 	
 			if (AsBackrefNode)
 				return CaptureName == AsBackrefNode->CaptureName;
@@ -372,16 +472,19 @@ namespace Evex
 			return false;
 		}
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline size_t Signature() const final { return RegexNode<T>::MakeSignature(RegexSignatureKind::Backreference, std::hash<StringType>()(CaptureName)); }
+	
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
-			if (BoundCapture && BoundCapture->Succeeded)
+			if (BoundCapture && BoundCapture->GetState(MatchContext).Succeeded)
 			{
 				IterType Copy = Input;
 	
-				std::basic_string<T> CappedInputs = BoundCapture->GetCapture();
-				for (const T& currCapturedInput : CappedInputs)
+				const T* CapBegin = nullptr, *CapEnd = nullptr;
+				BoundCapture->GetCaptureRange(MatchContext, CapBegin, CapEnd);
+				for (const T* currCapturedInput = CapBegin; currCapturedInput != CapEnd; ++currCapturedInput)
 				{
-					if (Copy.IsEnd() || *Copy != currCapturedInput)
+					if (Copy.IsEnd() || *Copy != *currCapturedInput)
 						return false;
 					++Copy;
 				}
@@ -430,43 +533,46 @@ namespace Evex
 		bool OnceOnly = true;
 		bool Lazy = false;
 	
-		RegexNoneOrMoreNode(bool Once, bool Reluctant = false) : OnceOnly(Once), Lazy(Reluctant) {}
+		RegexNoneOrMoreNode(bool Once, bool Reluctant = false) : RegexGroupNode<T>(RegexNodeKind::NoneOrMore), OnceOnly(Once), Lazy(Reluctant) {}
+	
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::NoneOrMore == inKind; }
 	
-		inline virtual RegexNode* Clone()
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexNoneOrMoreNode* Out = new RegexNoneOrMoreNode(OnceOnly, Lazy);
+			RegexNoneOrMoreNode* Out = Arena.New<RegexNoneOrMoreNode>(OnceOnly, Lazy);
 			Out->Chunks = Chunks;
 			Out->Ins = Ins;
 			Out->Outs = Outs;
+			Out->IterateReverse = IterateReverse;
 			return Out;
 		}
 	
 		// None-Or-Mores should never be similar to each other.
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return false; }
 	
-		void TryAnyTakers(IterType& Input, std::vector<RegexNode<T>*>* Outers)
+		// Looks for a node after this one to take Input instead, stepping back if one does. Returns whether one did.
+		bool TryAnyTakers(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers) const
 		{
 			IterType FinalCopy = Input;
 	
-			std::vector<RegexNode<T>*> NextCandidates;
-			if (nullptr != Outers)
-				NextCandidates = *Outers;
-			NextCandidates.push_back(this);
+			RegexOutersScope<T> NextCandidates(MatchContext, Outers, this);
 	
 			bool AnyTakers = false;
-			for (int i = NextCandidates.size() - 1; i >= 0 && !AnyTakers; --i)
+			for (int i = NextCandidates.Chain->size() - 1; i >= 0 && !AnyTakers; --i)
 			{
-				std::vector<RegexNode<T>*> RetrievedNexts = NextCandidates[i]->GetNexts();
+				const int* NextsBegin = nullptr, *NextsEnd = nullptr;
+				Table->GetSuccessors((*NextCandidates.Chain)[i]->StateIndex, MatchContext, NextsBegin, NextsEnd);
 	
-				for (RegexNode<T>* currNext : RetrievedNexts)
+				for (const int* currNextState = NextsBegin; currNextState != NextsEnd; ++currNextState)
 				{
+					const RegexNode<T>* currNext = Table->States[*currNextState];
 					if (currNext != this)
 					{
-						AnyTakers = currNext->CanEnter(FinalCopy, &NextCandidates);
+						AnyTakers = RegexEnterNode(currNext, FinalCopy, MatchContext, NextCandidates.Chain);
 	
 						if (AnyTakers)
 						{
-							--Input;
+							StepBack(Input);
 							break;
 						}
 	
@@ -474,41 +580,43 @@ namespace Evex
 					}
 				}
 			}
+	
+			return AnyTakers;
 		}
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
 			IterType Copy;
-			std::vector<RegexNode<T>*> AppendOuters;
-			if (nullptr != Outers)
-				AppendOuters = *Outers;
-			AppendOuters.push_back(this);
-			if (RegexChunk<T>::Match(Input, Ins, Outs, false, Copy, &AppendOuters))
+			bool Matched = false;
 			{
-				if (Lazy)
-					TryAnyTakers(Input, Outers);
-				else
-					Input = Copy;
+				// Dropped again before looking for takers, which add this node to the chain themselves.
+				RegexOutersScope<T> AppendOuters(MatchContext, Outers, this);
+				Matched = RegexChunk<T>::Match(Input, *Table, Context, MatchContext, false, Copy, AppendOuters.Chain, IterateReverse);
 			}
-			else
-				TryAnyTakers(Input, Outers);
 	
-			return true;
-		}
+			if (Matched && !Lazy)
+			{
+				Input = Copy;
+				return true;
+			}
 	
-		inline std::vector<RegexNode<T>*> GetNexts() final
-		{
-			std::vector<RegexNode<T>*> OtherNexts = RegexNode<T>::GetNexts();
+			if (TryAnyTakers(Input, MatchContext, Outers))
+				return true;
 	
-			if (!OnceOnly)
+			// With nothing to give way to, taking nothing only does if nothing has to follow.
+			if (Table->IsAcceptingAny(StateIndex))
 			{
-				if (Lazy)
-					OtherNexts.insert(OtherNexts.end(), this);
-				else
-					OtherNexts.insert(OtherNexts.begin(), this);
+				StepBack(Input);
+				return true;
+			}
+	
+			if (Matched)
+			{
+				Input = Copy;
+				return true;
 			}
 	
-			return OtherNexts;
+			return false;
 		}
 	
 		StringType Draw(std::unordered_map<StringType, int>& TypeNumbers,
@@ -551,17 +659,19 @@ namespace Evex
 	{
 		// Positive times indicate mandatory loops, negative times indicate skippable loops.
 		const int MaxTimes = 0;
-		int CurrTimes = 0;
+
+		// Index of this ticker's remaining times within a match context.
+		const int Slot = -1;
 	
-		RegexTicker(int Max) : MaxTimes(Max), CurrTimes(Max) {}
+		RegexTicker(int Max, int inSlot) : MaxTimes(Max), Slot(inSlot) {}
 	
-		inline bool IsExhausted() { return CurrTimes == 0; }
+		inline bool IsExhausted(const RegexMatchContext<T>& MatchContext) const { return MatchContext.TickerTimes[Slot] == 0; }
 	
-		inline bool IsMandatory() { return MaxTimes > 0; }
+		inline bool IsMandatory() const { return MaxTimes > 0; }
 	
-		inline void Tick() { (MaxTimes > 0 ? --CurrTimes : ++CurrTimes); }
+		inline void Tick(RegexMatchContext<T>& MatchContext) const { int& CurrTimes = MatchContext.TickerTimes[Slot]; (MaxTimes > 0 ? --CurrTimes : ++CurrTimes); }
 	
-		inline void Reset() { CurrTimes = MaxTimes; }
+		inline void Reset(RegexMatchContext<T>& MatchContext) const { MatchContext.TickerTimes[Slot] = MaxTimes; }
 	};
 	
 	/*
@@ -574,34 +684,34 @@ namespace Evex
 		RegexTicker<T>* BoundTicker = nullptr;
 		bool Lazy = false;
 	
-		RegexLoopNode(RegexTicker<T>* Ticker, bool Reluctant = false) : BoundTicker(Ticker), Lazy(Reluctant) {}
+		RegexLoopNode(RegexTicker<T>* Ticker, bool Reluctant = false) : RegexGroupNode<T>(RegexNodeKind::Loop), BoundTicker(Ticker), Lazy(Reluctant) {}
 	
-		inline virtual RegexNode* Clone()
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::Loop == inKind; }
+	
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexLoopNode* Out = new RegexLoopNode(BoundTicker, Lazy);
+			RegexLoopNode* Out = Arena.New<RegexLoopNode>(BoundTicker, Lazy);
 			Out->Chunks = Chunks;
 			Out->Ins = Ins;
 			Out->Outs = Outs;
+			Out->IterateReverse = IterateReverse;
 			return Out;
 		}
 	
 		// loops should never be similar to each other.
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return false; }
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
-			if (nullptr == BoundTicker || !BoundTicker->IsExhausted())
+			if (nullptr == BoundTicker || !BoundTicker->IsExhausted(MatchContext))
 			{
 				IterType Copy;
 	
-				std::vector<RegexNode<T>*> AppendOuters;
-				if (nullptr != Outers)
-					AppendOuters = *Outers;
-				AppendOuters.push_back(this);
-				if (RegexChunk<T>::Match(Input, Ins, Outs, false, Copy, &AppendOuters))
+				RegexOutersScope<T> AppendOuters(MatchContext, Outers, this);
+				if (RegexChunk<T>::Match(Input, *Table, Context, MatchContext, false, Copy, AppendOuters.Chain, IterateReverse))
 				{
 					if (BoundTicker)
-						BoundTicker->Tick();
+						BoundTicker->Tick(MatchContext);
 					Input = Copy;
 					return true;
 				}
@@ -610,21 +720,6 @@ namespace Evex
 			return false;
 		}
 	
-		inline std::vector<RegexNode<T>*> GetNexts() final
-		{
-			std::vector<RegexNode<T>*> OtherNexts = RegexNode<T>::GetNexts();
-	
-			if (BoundTicker && !BoundTicker->IsExhausted() && BoundTicker->IsMandatory())
-				return{ this };
-	
-			if (Lazy)
-				OtherNexts.insert(OtherNexts.end(), this);
-			else
-				OtherNexts.insert(OtherNexts.begin(), this);
-	
-			return OtherNexts;
-		}
-	
 		StringType Draw(std::unordered_map<StringType, int>& TypeNumbers,
 						 StringType& OutStr,
 						 const std::unordered_set<RegexNodeBase<T>*> Ends,
@@ -683,13 +778,17 @@ namespace Evex
 	struct RegexRecursionNode : public RegexGroupNode<T>
 	{
 		const int MaxDepth = 0;
-		int CurrDepth = 0;
+
+		// Index of this node's current depth within a match context. Assigned once assembly has finished.
+		int DepthSlot = -1;
+	
+		RegexRecursionNode(int maxDepth) : RegexGroupNode<T>(RegexNodeKind::Recursion), MaxDepth(maxDepth) {}
 	
-		RegexRecursionNode(int maxDepth) : MaxDepth(maxDepth) {}
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::Recursion == inKind; }
 	
-		inline virtual RegexNode* Clone()
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexRecursionNode* Out = new RegexRecursionNode(MaxDepth);
+			RegexRecursionNode* Out = Arena.New<RegexRecursionNode>(MaxDepth);
 			Out->Chunks = Chunks;
 			Out->Ins = Ins;
 			Out->Outs = Outs;
@@ -700,18 +799,19 @@ namespace Evex
 		// Recursion nodes should never be similar to each other.
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return false; }
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		// The automaton recursed into is shared by the whole regex, so it can't be flipped.
+		inline bool CanIterateReverse() const final { return false; }
+	
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
 			IterType Copy;
 	
+			int& CurrDepth = MatchContext.Depths[DepthSlot];
 			int KeptDepth = CurrDepth++;
 			if (KeptDepth < MaxDepth)
 			{
-				std::vector<RegexNode<T>*> AppendOuters;
-				if (nullptr != Outers)
-					AppendOuters = *Outers;
-				AppendOuters.push_back(this);
-				if (RegexChunk<T>::Match(Input, Ins, Outs, LazyGroup, Copy, &AppendOuters))
+				RegexOutersScope<T> AppendOuters(MatchContext, Outers, this);
+				if (RegexChunk<T>::Match(Input, *Table, Context, MatchContext, LazyGroup, Copy, AppendOuters.Chain))
 				{
 					Input = Copy;
 					return true;
@@ -755,23 +855,27 @@ namespace Evex
 	struct RegexSubroutineNode : public RegexNode<T>
 	{
 		const int MaxDepth = 0;
-		int CurrDepth = 0;
+
+		// Index of this node's current depth within a match context. Assigned once assembly has finished.
+		int DepthSlot = -1;
 	
 		std::basic_string<T> CaptureName;
 		const RegexCaptureBase<T>* BoundCapture = nullptr;
 	
-		RegexSubroutineNode(std::basic_string<T>& CapName, int maxDepth) : CaptureName(CapName), MaxDepth(maxDepth) {}
+		RegexSubroutineNode(std::basic_string<T>& CapName, int maxDepth) : RegexNode<T>(RegexNodeKind::Subroutine), CaptureName(CapName), MaxDepth(maxDepth) {}
 	
-		inline virtual RegexNode* Clone()
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::Subroutine == inKind; }
+	
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexSubroutineNode* Out = new RegexSubroutineNode(CaptureName, MaxDepth);
+			RegexSubroutineNode* Out = Arena.New<RegexSubroutineNode>(CaptureName, MaxDepth);
 			Out->BoundCapture = BoundCapture;
 			return Out;
 		}
 	
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final
 		{
-			const RegexSubroutineNode* AsSubroutineNode = dynamic_cast<const RegexSubroutineNode*>(o);
+			const RegexSubroutineNode* AsSubroutineNode = RegexNodeCast<const RegexSubroutineNode>(o);
 	
 			if (AsSubroutineNode)
 				return CaptureName == AsSubroutineNode->CaptureName;
@@ -779,23 +883,24 @@ namespace Evex
 			return false;
 		}
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline size_t Signature() const final { return RegexNode<T>::MakeSignature(RegexSignatureKind::Subroutine, std::hash<StringType>()(CaptureName)); }
+	
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
-			if (BoundCapture && BoundCapture->LastCapture)
+			// Before the group is first entered this is whatever the capture started out with, which needn't be a group.
+			const RegexGroupNode<T>* AsGroup =
+				RegexNodeCast<const RegexGroupNode<T>>(BoundCapture ? BoundCapture->GetState(MatchContext).LastCapture : nullptr);
+			if (AsGroup)
 			{
+				int& CurrDepth = MatchContext.Depths[DepthSlot];
 				int KeptDepth = CurrDepth++;
 				if (KeptDepth < MaxDepth)
 				{
 					IterType Copy;
 
-					std::vector<RegexNode<T>*> AppendOuters;
-					if (nullptr != Outers)
-						AppendOuters = *Outers;
-					AppendOuters.push_back(this);
+					RegexOutersScope<T> AppendOuters(MatchContext, Outers, this);
 
-					RegexGroupNode<T>* AsGroup = dynamic_cast<RegexGroupNode<T>*>(BoundCapture->LastCapture);
-
-					if (RegexChunk<T>::Match(Input, AsGroup->Ins, AsGroup->Outs, AsGroup->LazyGroup, Copy, &AppendOuters))
+					if (RegexChunk<T>::Match(Input, *AsGroup->Table, AsGroup->Context, MatchContext, AsGroup->LazyGroup, Copy, AppendOuters.Chain))
 					{
 						Input = Copy;
 						KeptDepth = 0;
@@ -848,29 +953,32 @@ namespace Evex
 		bool ExclusivelyBeginning = false;
 	
 		// If ExclusivelyBeginning is true and this is set, represents "\G"
-		IterType* LastMatchEnd = nullptr;
+		bool AtLastMatchEnd = false;
 	
 		RegexAtBeginningNode(RegexCharacterClassBase<T>* LineChars, bool Exclusive)
-			: RegexNode<T>({ LineChars }), ExclusivelyBeginning(Exclusive) {}
+			: RegexNode<T>(RegexNodeKind::AtBeginning, { LineChars }), ExclusivelyBeginning(Exclusive) {}
+	
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::AtBeginning == inKind; }
 	
-		inline virtual RegexNode* Clone()
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexAtBeginningNode* Out = new RegexAtBeginningNode(*Comparators.begin(), ExclusivelyBeginning);
-			Out->LastMatchEnd = LastMatchEnd;
+			RegexAtBeginningNode* Out = Arena.New<RegexAtBeginningNode>(*Comparators.begin(), ExclusivelyBeginning);
+			Out->AtLastMatchEnd = AtLastMatchEnd;
 			return Out;
 		}
 	
 		// There should never be another AtBeginning node in the first place, so it should never be similar to anything.
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return false; }
+		inline size_t Signature() const final { return 0; }
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
 			IterType Copy = Input;
 	
-			if (ExclusivelyBeginning && LastMatchEnd)
-				return Input.IsBegin() || --Copy == *LastMatchEnd;
+			if (ExclusivelyBeginning && AtLastMatchEnd)
+				return Input.IsBegin() || --Copy == MatchContext.LastMatchEnd;
 	
-			return Input.IsBegin() || (!ExclusivelyBeginning && RegexNode<T>::CanEnter(--Copy));
+			return Input.IsBegin() || (!ExclusivelyBeginning && RegexNode<T>::CanEnter(--Copy, MatchContext));
 		}
 	
 		StringType Draw(std::unordered_map<StringType, int>& TypeNumbers,
@@ -907,18 +1015,21 @@ namespace Evex
 		bool LastNewline = false;
 	
 		RegexAtEndNode(RegexCharacterClassBase<T>* LineChars, bool Exclusive, bool LastNL)
-			: RegexNode<T>({ LineChars }), ExclusivelyEnd(Exclusive), LastNewline(LastNL) {}
+			: RegexNode<T>(RegexNodeKind::AtEnd, { LineChars }), ExclusivelyEnd(Exclusive), LastNewline(LastNL) {}
 	
-		inline virtual RegexNode* Clone()
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::AtEnd == inKind; }
+	
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexAtEndNode* Out = new RegexAtEndNode(*Comparators.begin(), ExclusivelyEnd, LastNewline);
+			RegexAtEndNode* Out = Arena.New<RegexAtEndNode>(*Comparators.begin(), ExclusivelyEnd, LastNewline);
 			return Out;
 		}
 	
 		// There should never be another AtEnd node in the first place, so it should never be similar to anything.
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return false; }
+		inline size_t Signature() const final { return 0; }
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
 			IterType Copy = Input;
 	
@@ -929,19 +1040,19 @@ namespace Evex
 				while (TrueEnd != Input)
 				{
 					--TrueEnd;
-					if (!RegexNode<T>::CanEnter(TrueEnd))
+					if (!RegexNode<T>::CanEnter(TrueEnd, MatchContext))
 					{
 						++TrueEnd;
 						break;
 					}
 				}
 	
-				if (TrueEnd == Input && RegexNode<T>::CanEnter(TrueEnd))
+				if (TrueEnd == Input && RegexNode<T>::CanEnter(TrueEnd, MatchContext))
 					Success = true;
 			}
 	
 			if (!Success)
-				Success = Input == TrueEnd || (!ExclusivelyEnd && RegexNode<T>::CanEnter(Copy));
+				Success = Input == TrueEnd || (!ExclusivelyEnd && RegexNode<T>::CanEnter(Copy, MatchContext));
 	
 			return Success;
 		}
@@ -978,17 +1089,19 @@ namespace Evex
 		bool Negated = false;
 	
 		RegexWordBoundaryNode(RegexCharacterClassBase<T>* wordChars, bool Negate)
-			: RegexNode<T>({ wordChars }), Negated(Negate) {}
+			: RegexNode<T>(RegexNodeKind::WordBoundary, { wordChars }), Negated(Negate) {}
+	
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::WordBoundary == inKind; }
 	
-		inline virtual RegexNode* Clone()
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexWordBoundaryNode* Out = new RegexWordBoundaryNode(*Comparators.begin(), Negated);
+			RegexWordBoundaryNode* Out = Arena.New<RegexWordBoundaryNode>(*Comparators.begin(), Negated);
 			return Out;
 		}
 	
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final
 		{
-			const RegexWordBoundaryNode* AsWB = dynamic_cast<const RegexWordBoundaryNode*>(o);
+			const RegexWordBoundaryNode* AsWB = RegexNodeCast<const RegexWordBoundaryNode>(o);
 	
 			if (AsWB)
 				return AsWB->Negated == Negated;
@@ -996,7 +1109,9 @@ namespace Evex
 			return false;
 		}
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline size_t Signature() const final { return RegexNode<T>::MakeSignature(RegexSignatureKind::WordBoundary, size_t(Negated)); }
+	
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
 			IterType Copy = Input;
 			bool Success = Copy.IsBegin() || Copy.IsEnd() || (++Copy).IsEnd();
@@ -1004,10 +1119,10 @@ namespace Evex
 			if (!Success)
 			{
 				Copy = Input;
-				if (RegexNode<T>::CanEnter(Input))
-					Success = !(RegexNode<T>::CanEnter(--Copy) || RegexNode<T>::CanEnter(++(++Copy)));
+				if (RegexNode<T>::CanEnter(Input, MatchContext))
+					Success = !(RegexNode<T>::CanEnter(--Copy, MatchContext) || RegexNode<T>::CanEnter(++(++Copy), MatchContext));
 				else
-					Success = (RegexNode<T>::CanEnter(--Copy) || RegexNode<T>::CanEnter(++(++Copy)));
+					Success = (RegexNode<T>::CanEnter(--Copy, MatchContext) || RegexNode<T>::CanEnter(++(++Copy), MatchContext));
 			}
 			else if (Input.IsBegin())
 				--Input;
@@ -1052,12 +1167,17 @@ namespace Evex
 	struct RegexConditionalNode : public RegexGroupNode<T>
 	{
 		RegexChunk<T>* Cond, *IfTrue, *IfFalse;
+
+		// Contexts of Cond, IfTrue, and IfFalse within Table.
+		int CondContext = -1, TrueContext = -1, FalseContext = -1;
 	
-		RegexConditionalNode(RegexChunk<T>* c, RegexChunk<T>* t, RegexChunk<T>* f) : Cond(c), IfTrue(t), IfFalse(f) {}
+		RegexConditionalNode(RegexChunk<T>* c, RegexChunk<T>* t, RegexChunk<T>* f) : RegexGroupNode<T>(RegexNodeKind::Conditional), Cond(c), IfTrue(t), IfFalse(f) {}
 	
-		inline virtual RegexNode* Clone()
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::Conditional == inKind; }
+	
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexConditionalNode* Out = new RegexConditionalNode(Cond, IfTrue, IfFalse);
+			RegexConditionalNode* Out = Arena.New<RegexConditionalNode>(Cond, IfTrue, IfFalse);
 			Out->Chunks = Chunks;
 			Out->Ins = Ins;
 			Out->Outs = Outs;
@@ -1068,12 +1188,15 @@ namespace Evex
 		// conditionals should not be similar to each other
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return false; }
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		// Conditionals keep their insides in Cond, IfTrue and IfFalse rather than Ins and Outs.
+		inline bool CanIterateReverse() const final { return false; }
+	
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
 			const RegexCaptureBase<T>* Cap = nullptr;
 			if (!Cond->Nodes.empty() && Cond->Nodes.size() < 2)
 			{
-				RegexBackreferenceNode<T>* AsBackref = dynamic_cast<RegexBackreferenceNode<T>*>(Cond->Nodes[0]);
+				RegexBackreferenceNode<T>* AsBackref = RegexNodeCast<RegexBackreferenceNode<T>>(Cond->Nodes[0]);
 	
 				if (AsBackref)
 					Cap = AsBackref->BoundCapture;
@@ -1081,23 +1204,11 @@ namespace Evex
 	
 			IterType Copy;
 	
-			std::vector<RegexNode<T>*> AppendOuters;
-			if (nullptr != Outers)
-				AppendOuters = *Outers;
-			AppendOuters.push_back(this);
+			RegexOutersScope<T> AppendOuters(MatchContext, Outers, this);
 	
-			std::unordered_set<RegexNodeGhostIn<T>*> currIns;
-			std::unordered_set<RegexNodeGhostOut<T>*> currOuts;
-	
-			for (RegexNodeGhostIn<T>& currIn : Cond->Ins) currIns.insert(&currIn);
-			for (RegexNodeGhostOut<T>& currOut : Cond->Outs) currOuts.insert(&currOut);
-			if ((Cap ? Cap->Succeeded : RegexChunk<T>::Match(Input, currIns, currOuts, LazyGroup, Copy, &AppendOuters)))
+			if ((Cap ? Cap->GetState(MatchContext).Succeeded : RegexChunk<T>::Match(Input, *Table, CondContext, MatchContext, LazyGroup, Copy, AppendOuters.Chain)))
 			{
-				currIns.clear();
-				currOuts.clear();
-				for (RegexNodeGhostIn<T>& currIn : IfTrue->Ins) currIns.insert(&currIn);
-				for (RegexNodeGhostOut<T>& currOut : IfTrue->Outs) currOuts.insert(&currOut);
-				if (RegexChunk<T>::Match(Input, currIns, currOuts, LazyGroup, Copy, &AppendOuters))
+				if (RegexChunk<T>::Match(Input, *Table, TrueContext, MatchContext, LazyGroup, Copy, AppendOuters.Chain))
 				{
 					Input = Copy;
 					return true;
@@ -1105,11 +1216,7 @@ namespace Evex
 			}
 			else if (nullptr != IfFalse)
 			{
-				currIns.clear();
-				currOuts.clear();
-				for (RegexNodeGhostIn<T>& currIn : IfFalse->Ins) currIns.insert(&currIn);
-				for (RegexNodeGhostOut<T>& currOut : IfFalse->Outs) currOuts.insert(&currOut);
-				if (RegexChunk<T>::Match(Input, currIns, currOuts, LazyGroup, Copy, &AppendOuters))
+				if (RegexChunk<T>::Match(Input, *Table, FalseContext, MatchContext, LazyGroup, Copy, AppendOuters.Chain))
 				{
 					Input = Copy;
 					return true;
@@ -1162,17 +1269,19 @@ namespace Evex
 		std::basic_string<T> HookedName;
 		FuncType Hooked;
 	
-		RegexCodeHookNode(std::basic_string<T> name, FuncType func) : HookedName(name), Hooked(func) {}
+		RegexCodeHookNode(std::basic_string<T> name, FuncType func) : RegexNode<T>(RegexNodeKind::CodeHook), HookedName(name), Hooked(func) {}
+	
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::CodeHook == inKind; }
 	
-		inline virtual RegexNode* Clone()
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexCodeHookNode* Out = new RegexCodeHookNode(HookedName, Hooked);
+			RegexCodeHookNode* Out = Arena.New<RegexCodeHookNode>(HookedName, Hooked);
 			return Out;
 		}
 	
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const final
 		{
-			const RegexCodeHookNode* AsHookNode = dynamic_cast<const RegexCodeHookNode*>(o);
+			const RegexCodeHookNode* AsHookNode = RegexNodeCast<const RegexCodeHookNode>(o);
 	
 			if (AsHookNode)
 				return HookedName == AsHookNode->HookedName;
@@ -1180,7 +1289,9 @@ namespace Evex
 			return false;
 		}
 	
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final
+		inline size_t Signature() const final { return RegexNode<T>::MakeSignature(RegexSignatureKind::CodeHook, std::hash<StringType>()(HookedName)); }
+	
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final
 		{
 			if (Hooked)
 				Hooked(Input);
@@ -1209,4 +1320,66 @@ namespace Evex
 			return MyName;
 		}
 	};
+	
+	/*
+		Calls straight into the CanEnter of whichever kind of node is given, so that matching loops make no virtual
+		calls and need no RTTI. Ghosts are never states, so are never entered.
+	*/
+	template<typename T>
+	inline bool RegexEnterNode(const RegexNode<T>* Node,
+		RegexRangeIterator<T>& Input,
+		RegexMatchContext<T>& MatchContext,
+		std::vector<const RegexNode<T>*>* Outers)
+	{
+		switch (Node->Kind)
+		{
+		case RegexNodeKind::Node:
+			return static_cast<const RegexNode<T>*>(Node)->RegexNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::Backreference:
+			return static_cast<const RegexBackreferenceNode<T>*>(Node)->RegexBackreferenceNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::Subroutine:
+			return static_cast<const RegexSubroutineNode<T>*>(Node)->RegexSubroutineNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::AtBeginning:
+			return static_cast<const RegexAtBeginningNode<T>*>(Node)->RegexAtBeginningNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::AtEnd:
+			return static_cast<const RegexAtEndNode<T>*>(Node)->RegexAtEndNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::WordBoundary:
+			return static_cast<const RegexWordBoundaryNode<T>*>(Node)->RegexWordBoundaryNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::CodeHook:
+			return static_cast<const RegexCodeHookNode<T>*>(Node)->RegexCodeHookNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::Group:
+			return static_cast<const RegexGroupNode<T>*>(Node)->RegexGroupNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::LookAhead:
+			return static_cast<const RegexLookAheadNode<T>*>(Node)->RegexLookAheadNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::LookBehind:
+			return static_cast<const RegexLookBehindNode<T>*>(Node)->RegexLookBehindNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::Capture:
+			return static_cast<const RegexCaptureNode<T>*>(Node)->RegexCaptureNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::NoneOrMore:
+			return static_cast<const RegexNoneOrMoreNode<T>*>(Node)->RegexNoneOrMoreNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::Loop:
+			return static_cast<const RegexLoopNode<T>*>(Node)->RegexLoopNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::Recursion:
+			return static_cast<const RegexRecursionNode<T>*>(Node)->RegexRecursionNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		case RegexNodeKind::Conditional:
+			return static_cast<const RegexConditionalNode<T>*>(Node)->RegexConditionalNode<T>::CanEnter(Input, MatchContext, Outers);
+	
+		default:
+			return false;
+		}
+	}
 }
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <string>
+#include <exception>
+
+// <windows.h> comes in as the includer has it configured. Without NOMINMAX its min and max macros break std::min and std::max,
+// so include this after any other Evex headers, as EvexFile.h does.
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+namespace Evex
+{
+	class RegexFileException : public std::exception
+	{
+	private:
+		std::string msg;
+	public:
+		explicit RegexFileException(const std::string& inMsg) : msg(inMsg) {}
+		virtual const char* what() const throw() { return msg.c_str(); }
+	};
+
+	/*
+		A file mapped read-only into memory, so it can be matched against in place rather than read into a string first.
+		The OS is told it'll be read front to back, so it can read ahead and drop pages already passed.
+		Throws a RegexFileException if the file can't be opened or mapped.
+	*/
+	class RegexMappedFile
+	{
+	public:
+		explicit RegexMappedFile(const std::string& Path)
+		{
+#ifdef _WIN32
+			File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (INVALID_HANDLE_VALUE == File)
+				throw RegexFileException("Could not open file \"" + Path + "\".");
+
+			LARGE_INTEGER FileSize;
+			if (!GetFileSizeEx(File, &FileSize))
+			{
+				Close();
+				throw RegexFileException("Could not get the size of file \"" + Path + "\".");
+			}
+			Size = size_t(FileSize.QuadPart);
+
+			// Empty files can't be mapped, but there's nothing to map anyway.
+			if (0 == Size)
+				return;
+
+			Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (nullptr != Mapping)
+				Data = static_cast<const char*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+			File = open(Path.c_str(), O_RDONLY);
+			if (File < 0)
+				throw RegexFileException("Could not open file \"" + Path + "\".");
+
+			struct stat FileStat;
+			if (fstat(File, &FileStat) < 0)
+			{
+				Close();
+				throw RegexFileException("Could not get the size of file \"" + Path + "\".");
+			}
+			Size = size_t(FileStat.st_size);
+
+			// Empty files can't be mapped, but there's nothing to map anyway.
+			if (0 == Size)
+				return;
+
+			void* Mapped = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, File, 0);
+			if (MAP_FAILED != Mapped)
+			{
+				madvise(Mapped, Size, MADV_SEQUENTIAL);
+				Data = static_cast<const char*>(Mapped);
+			}
+#endif
+
+			if (nullptr == Data)
+			{
+				Close();
+				throw RegexFileException("Could not map file \"" + Path + "\".");
+			}
+		}
+
+		~RegexMappedFile() { Close(); }
+
+		RegexMappedFile(const RegexMappedFile&) = delete;
+		RegexMappedFile& operator=(const RegexMappedFile&) = delete;
+
+		// Start of the file's contents. Null if the file is empty.
+		inline const char* GetData() const { return Data; }
+
+		// Size of the file, in bytes.
+		inline size_t GetSize() const { return Size; }
+
+	private:
+		const char* Data = nullptr;
+		size_t Size = 0;
+
+#ifdef _WIN32
+		HANDLE File = INVALID_HANDLE_VALUE;
+		HANDLE Mapping = nullptr;
+#else
+		int File = -1;
+#endif
+
+		void Close()
+		{
+#ifdef _WIN32
+			if (nullptr != Data)
+				UnmapViewOfFile(Data);
+			if (nullptr != Mapping)
+				CloseHandle(Mapping);
+			if (INVALID_HANDLE_VALUE != File)
+				CloseHandle(File);
+
+			Mapping = nullptr;
+			File = INVALID_HANDLE_VALUE;
+#else
+			if (nullptr != Data)
+				munmap(const_cast<char*>(Data), Size);
+			if (File >= 0)
+				close(File);
+
+			File = -1;
+#endif
+
+			Data = nullptr;
+			Size = 0;
+		}
+	};
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "EvexRangeIterator.h"
+#include "EvexDfaCache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+
+
+namespace Evex
+{
+	template<typename T> struct RegexNode;
+	template<typename T> class Regex;
+
+	/*
+		What a single capture holds during a match.
+		Ranges point either into the matched input or into PresetInputs. A plain capture only
+		ever holds its latest range, while a capture collection keeps every one.
+	*/
+	template<typename T>
+	struct RegexCaptureState
+	{
+		std::vector<std::pair<const T*, const T*>> Ranges;
+
+		// Backing storage for pre-set captures. A deque, so that earlier values never move.
+		std::deque<std::basic_string<T>> PresetInputs;
+
+		// The last group that set this capture. Used exclusively by subroutine nodes.
+		const RegexNode<T>* LastCapture = nullptr;
+
+		// Indicates whether the capture was successful, i.e. that it was both reached and written to.
+		bool Succeeded = false;
+
+		RegexCaptureState() {}
+		RegexCaptureState(RegexCaptureState&&) = default;
+		RegexCaptureState& operator=(RegexCaptureState&&) = default;
+
+		// Copies point their pre-set ranges at their own PresetInputs, not the original's.
+		RegexCaptureState(const RegexCaptureState& o) : Ranges(o.Ranges), PresetInputs(o.PresetInputs), LastCapture(o.LastCapture), Succeeded(o.Succeeded) { RebasePresets(o); }
+
+		RegexCaptureState& operator=(const RegexCaptureState& o)
+		{
+			if (this != &o)
+			{
+				Ranges = o.Ranges;
+				PresetInputs = o.PresetInputs;
+				LastCapture = o.LastCapture;
+				Succeeded = o.Succeeded;
+				RebasePresets(o);
+			}
+
+			return *this;
+		}
+
+		// Drops every range that points into the matched input, leaving only pre-set ones. Used once the input is gone.
+		void DropInputRanges()
+		{
+			Ranges.erase(std::remove_if(Ranges.begin(), Ranges.end(),
+				[this](const std::pair<const T*, const T*>& Range) { return PresetIndexOf(Range) < 0; }),
+				Ranges.end());
+
+			if (Ranges.empty())
+				Succeeded = false;
+		}
+
+	private:
+		// Index of the pre-set input the given range lies within, or -1 if it's from the matched input.
+		int PresetIndexOf(const std::pair<const T*, const T*>& Range) const
+		{
+			for (size_t i = 0; i < PresetInputs.size(); ++i)
+			{
+				const T* Preset = PresetInputs[i].data();
+				if (Preset <= Range.first && Range.second <= Preset + PresetInputs[i].size())
+					return int(i);
+			}
+
+			return -1;
+		}
+
+		void RebasePresets(const RegexCaptureState& o)
+		{
+			for (std::pair<const T*, const T*>& currRange : Ranges)
+			{
+				const int i = o.PresetIndexOf(currRange);
+				if (i >= 0)
+				{
+					const T* From = o.PresetInputs[i].data();
+					const T* To = PresetInputs[i].data();
+					currRange = { To + (currRange.first - From), To + (currRange.second - From) };
+				}
+			}
+		}
+	};
+
+	// A walk from one start offset, as run side by side with others by MatchAll's single-pass scan.
+	struct RegexSearchWalk
+	{
+		ptrdiff_t Start;
+		int State;
+		bool Finished, Matched;
+		ptrdiff_t End;
+	};
+
+	/*
+		Everything that changes while matching, kept apart from the compiled regex.
+		Once compiled, a Regex is never written to by its context-taking match functions, so any
+		number of threads may match against it at once as long as each has a context of its own.
+		A context is set up for whichever regex it's first used with, and is cheapest when reused
+		for many matches, since its buffers and cached transitions are kept between them.
+	*/
+	template<typename T>
+	struct RegexMatchContext
+	{
+		// Remaining times of each ticker, by RegexTicker::Slot.
+		std::vector<int> TickerTimes;
+
+		// State of each capture, by RegexCaptureBase::Slot.
+		std::vector<RegexCaptureState<T>> Captures;
+
+		// Current depth of each recursion and subroutine node, by their DepthSlot.
+		std::vector<int> Depths;
+
+		// End of the last match, for exclusive use by "\\G"
+		RegexRangeIterator<T> LastMatchEnd;
+
+		std::vector<std::string> RuntimeErrors;
+
+		// Transitions of the regex's plain frontiers, filled in as matching comes across them.
+		RegexDfaCache DfaCache;
+
+		// Scratch space for MatchAll's single-pass scan. A RegexStreamScanner carries the walks from one piece of its stream to the next.
+		std::vector<RegexSearchWalk> Walks, NextWalks;
+		std::vector<ptrdiff_t> StateStamps;
+
+		// Scratch for the sub-matches run by group nodes, kept so that they allocate nothing once warmed up.
+		// Tickers set aside by every sub-match in progress, by slot, with the times to give back to each once it's done.
+		std::vector<std::pair<int, int>> StoredTickerTimes;
+
+		// Chains of the group nodes enclosing a sub-match, for those which don't carry on from one in progress. A deque, so that chains in use never move.
+		std::deque<std::vector<const RegexNode<T>*>> OuterChains;
+		size_t OuterChainsInUse = 0;
+
+		// The regex this context is currently set up for.
+		const Regex<T>* Program = nullptr;
+	};
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+
+namespace Evex
+{
+	template<typename T> class Regex;
+
+	/*
+		View of a single match, as offsets into the matched input.
+		Group 0 is the whole match, and groups 1 onward are the regex's numbered captures.
+		Nothing is copied out of the input, so it must outlive any views taken from here.
+	*/
+	template<typename T>
+	class RegexMatchResult
+	{
+	public:
+		using StringViewType = std::basic_string_view<T>;
+		using NameMapType = std::unordered_map<std::basic_string<T>, int>;
+
+		RegexMatchResult() {}
+		RegexMatchResult(const T* inSubject, const ptrdiff_t* inOffsets, int inGroupCount, const NameMapType* inNames)
+			: Subject(inSubject), Offsets(inOffsets), GroupCount(inGroupCount), Names(inNames) {}
+
+		// Number of groups, including the whole match as group 0.
+		inline int GetGroupCount() const { return GroupCount; }
+
+		// Did the given group take part in the match?
+		inline bool HasGroup(int Group) const { return Group >= 0 && Group < GroupCount && Offsets[Group * 2] >= 0; }
+
+		// Offsets into the input. Both are -1 if the group didn't take part in the match.
+		inline ptrdiff_t Begin(int Group = 0) const { return Offsets[Group * 2]; }
+		inline ptrdiff_t End(int Group = 0) const { return Offsets[Group * 2 + 1]; }
+		inline ptrdiff_t Length(int Group = 0) const { return End(Group) - Begin(Group); }
+
+		// Gets the given group as a span of the input, or an empty view if it didn't take part or the input is gone.
+		inline StringViewType View(int Group = 0) const
+		{
+			return (nullptr != Subject && HasGroup(Group) ? StringViewType(Subject + Begin(Group), size_t(Length(Group))) : StringViewType());
+		}
+
+		// Gets the group number of a named capture, or -1 if there's no capture by that name.
+		inline int GroupIndex(const std::basic_string<T>& Name) const
+		{
+			if (nullptr == Names)
+				return -1;
+
+			auto found = Names->find(Name);
+			return (found == Names->end() ? -1 : found->second);
+		}
+
+		inline bool HasGroup(const std::basic_string<T>& Name) const { return HasGroup(GroupIndex(Name)); }
+		inline StringViewType View(const std::basic_string<T>& Name) const { return View(GroupIndex(Name)); }
+
+	private:
+		const T* Subject = nullptr;
+		const ptrdiff_t* Offsets = nullptr;
+		int GroupCount = 0;
+		const NameMapType* Names = nullptr;
+	};
+
+	/*
+		Every match found within one input, with the offsets of all of them kept in a single array.
+	*/
+	template<typename T>
+	class RegexMatchResults
+	{
+	public:
+		using NameMapType = typename RegexMatchResult<T>::NameMapType;
+
+		inline size_t size() const { return (GroupCount > 0 ? Offsets.size() / (GroupCount * 2) : 0); }
+		inline bool empty() const { return Offsets.empty(); }
+
+		inline RegexMatchResult<T> operator[](size_t Index) const
+		{
+			return RegexMatchResult<T>(Subject, Offsets.data() + Index * GroupCount * 2, GroupCount, Names);
+		}
+
+		inline RegexMatchResult<T> back() const { return (*this)[size() - 1]; }
+
+		// The input the offsets refer to. Null if it's no longer around, e.g. after MatchAllInFile.
+		inline const T* GetSubject() const { return Subject; }
+
+		void clear() { Offsets.clear(); }
+
+	private:
+		friend class Regex<T>;
+
+		const T* Subject = nullptr;
+		int GroupCount = 0;
+		const NameMapType* Names = nullptr;
+
+		// GroupCount (begin, end) pairs per match.
+		std::vector<ptrdiff_t> Offsets;
+
+		void Reset(const T* inSubject, int inGroupCount, const NameMapType* inNames)
+		{
+			Subject = inSubject;
+			GroupCount = inGroupCount;
+			Names = inNames;
+			Offsets.clear();
+		}
+
+		// Appends a match with every group marked as not taking part, returning its offsets.
+		ptrdiff_t* AddMatch()
+		{
+			Offsets.resize(Offsets.size() + GroupCount * 2, -1);
+			return Offsets.data() + Offsets.size() - GroupCount * 2;
+		}
+
+		// Appends a copy of a match from other results over the same input.
+		void AppendMatch(const RegexMatchResults<T>& Other, size_t Index)
+		{
+			const ptrdiff_t* From = Other.Offsets.data() + Index * GroupCount * 2;
+			Offsets.insert(Offsets.end(), From, From + GroupCount * 2);
+		}
+	};
+}
@@ -1,35 +1,85 @@
 #pragma once
 
 #include "EvexCharacterClass.h"
+#include "EvexMatchContext.h"
+#include "EvexArena.h"
 
 #include <unordered_set>
 #include <unordered_map>
 #include <sstream>
+#include <functional>
+#include <type_traits>
 
 
 namespace Evex
 {
 	template<typename T> struct RegexNode;
+	template<typename T> struct RegexTicker;
+	template<typename T> struct RegexChunk;
+
+	/*
+		Every concrete kind of node, carried by each so that nodes can be told apart and dispatched on without RTTI.
+		Kinds of group node are kept together, from Group to Conditional, so a node can be told to be one by range.
+	*/
+	enum class RegexNodeKind : unsigned char
+	{
+		GhostIn,
+		GhostOut,
+		Node,
+		Backreference,
+		Subroutine,
+		AtBeginning,
+		AtEnd,
+		WordBoundary,
+		CodeHook,
+		Group,
+		LookAhead,
+		LookBehind,
+		Capture,
+		NoneOrMore,
+		Loop,
+		Recursion,
+		Conditional
+	};
+
+	// Checked downcast by node kind, in place of dynamic_cast. Gives null if the node isn't of the given type.
+	template<typename To, typename From>
+	inline To* RegexNodeCast(From* Node)
+	{
+		return (nullptr != Node && std::remove_const<To>::type::IsKind(Node->Kind) ? static_cast<To*>(Node) : nullptr);
+	}
+
+	// Enters a node as its CanEnter would, picked by switching over its kind rather than through its vtable. Defined in EvexGroupNode.h.
+	template<typename T>
+	inline bool RegexEnterNode(const RegexNode<T>* Node,
+		RegexRangeIterator<T>& Input,
+		RegexMatchContext<T>& MatchContext,
+		std::vector<const RegexNode<T>*>* Outers = nullptr);
 
 	template<typename T>
 	struct RegexNodeBase
 	{
+		// Set once on construction; not const only so that ghosts, which are held by value, stay assignable.
+		RegexNodeKind Kind;
+
 		unsigned int Index = -1;
 
+		// Chunk this is held in (at Index), or null if it hasn't been placed in one.
+		RegexChunk<T>* Owner = nullptr;
+
 		using IterType = RegexRangeIterator<T>;
 		using StringType = std::basic_string<T>;
 
+		explicit RegexNodeBase(RegexNodeKind inKind) : Kind(inKind) {}
+
 		// Used to determine whether or not a node can be collapsed into another node
 		inline virtual bool SimilarTo(const RegexNodeBase* o) const = 0;
 
 		// Used to merge the nexts of another node with this one during a collapse.
 		inline virtual void Incorporate(const RegexNodeBase* o) = 0;
 
-		// Can this node be entered with the given input data?
-		inline virtual bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) = 0;
-
-		// Gets all non-ghost nodes in line to be the next destination during traversal.
-		inline virtual std::vector<RegexNode<T>*> GetNexts() = 0;
+		// Can this node be entered with the given input data? Anything the attempt changes is kept in MatchContext.
+		inline virtual bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const = 0;
 
 		virtual StringType Draw(std::unordered_map<StringType, int>& TypeNumbers,
 			StringType& OutStr,
@@ -41,6 +91,16 @@ namespace Evex
 	template<typename T> struct RegexNodeGhostOut;
 	template<typename T> struct RegexGroupNode;
 
+	// Kinds of node told apart by their signatures, so nodes of different kinds never share one.
+	enum class RegexSignatureKind : size_t
+	{
+		Node = 1,
+		Backreference,
+		Subroutine,
+		WordBoundary,
+		CodeHook
+	};
+
 	template<typename T>
 	struct RegexNode : public RegexNodeBase<T>
 	{
@@ -51,20 +111,34 @@ namespace Evex
 		// The conditions against which incoming inputs are compared to.
 		std::unordered_set<RegexCharacterClassBase<T>*> Comparators;
 
-		RegexNode() {}
-		RegexNode(const std::unordered_set<RegexCharacterClassBase<T>*> inComps) : Comparators(inComps) {}
+		// Every comparator combined into one byte lookup. Only ever present on single-byte regexes.
+		bool HasBitmap = false;
+		RegexByteBitmap Bitmap;
+
+		// Index of this node within its regex's RegexStateTable. Assigned once assembly has finished.
+		int StateIndex = -1;
+
+		RegexNode() : RegexNodeBase<T>(RegexNodeKind::Node) {}
+		RegexNode(const std::unordered_set<RegexCharacterClassBase<T>*> inComps) : RegexNodeBase<T>(RegexNodeKind::Node), Comparators(inComps) {}
 
-		inline virtual RegexNode* Clone()
+		// For the kinds of node deriving from this one.
+		RegexNode(RegexNodeKind inKind, const std::unordered_set<RegexCharacterClassBase<T>*> inComps = {}) : RegexNodeBase<T>(inKind), Comparators(inComps) {}
+
+		// Every kind but the ghosts is a node proper.
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::Node <= inKind; }
+
+		inline virtual RegexNode* Clone(RegexArena& Arena)
 		{
-			RegexNode* Out = new RegexNode(Comparators);
+			RegexNode* Out = Arena.New<RegexNode>(Comparators);
 			return Out;
 		}
 
 		inline bool SimilarTo(const RegexNodeBase<T>* o) const override
 		{
-			const RegexNode* AsType = dynamic_cast<const RegexNode*>(o);
+			const RegexNode* AsType = RegexNodeCast<const RegexNode>(o);
 
-			if (AsType)
+			// The same comparators, not merely some of them, so that Signature finds every node this is similar to.
+			if (AsType && AsType->Comparators.size() == Comparators.size())
 			{
 				for (RegexCharacterClassBase<T>* currCClass : AsType->Comparators)
 				{
@@ -72,15 +146,36 @@ namespace Evex
 						return false;
 				}
 
-				return nullptr == dynamic_cast<const RegexGroupNode<T>*>(o);//o->SimilarTo(this);
+				return !RegexGroupNode<T>::IsKind(o->Kind);//o->SimilarTo(this);
 			}
 
 			return false;
 		}
 
+		/*
+			Hash of everything SimilarTo compares, so that the nodes one may be similar to can be found by lookup
+			rather than by comparing against each in turn. Nodes never similar to any other give 0.
+		*/
+		inline virtual size_t Signature() const
+		{
+			// Summed, as the comparators are unordered.
+			size_t Out = 0;
+			for (RegexCharacterClassBase<T>* currCClass : Comparators)
+				Out += std::hash<RegexCharacterClassBase<T>*>()(currCClass);
+
+			return MakeSignature(RegexSignatureKind::Node, Out);
+		}
+
+		// Mixes a node's kind into the hash of what it compares, never giving 0.
+		static inline size_t MakeSignature(RegexSignatureKind Kind, size_t Contents)
+		{
+			size_t Out = Contents ^ (size_t(Kind) + 0x9e3779b9 + (Contents << 6) + (Contents >> 2));
+			return (0 == Out ? 1 : Out);
+		}
+
 		inline void Incorporate(const RegexNodeBase* o) final
 		{
-			const RegexNode* AsType = dynamic_cast<const RegexNode*>(o);
+			const RegexNode* AsType = RegexNodeCast<const RegexNode>(o);
 
 			if (AsType)
 			{
@@ -89,8 +184,15 @@ namespace Evex
 			}
 		}
 
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr)
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const
 		{
+			// Inputs needn't be null-terminated, so there's nothing to compare past the end.
+			if (Input.IsEnd())
+				return false;
+
+			if (HasBitmap)
+				return Bitmap.Test((unsigned char)*Input);
+
 			for (RegexCharacterClassBase<T>* curr : Comparators)
 			{
 				if (!curr->Matches(Input))
@@ -100,7 +202,24 @@ namespace Evex
 			return true;
 		}
 
-		inline std::vector<RegexNode<T>*> GetNexts();
+		// Combines the bitmaps of every comparator into Bitmap. Comparators must have had theirs built already.
+		void BuildBitmap()
+		{
+			HasBitmap = false;
+			if (sizeof(T) != 1)
+				return;
+
+			Bitmap.SetAll();
+			for (RegexCharacterClassBase<T>* curr : Comparators)
+			{
+				if (!curr->HasBitmap)
+					return;
+
+				Bitmap.Intersect(curr->Bitmap);
+			}
+
+			HasBitmap = true;
+		}
 
 		void DrawNexts(std::unordered_map<StringType, int>& TypeNumbers,
 			StringType& OutStr,
@@ -174,18 +293,21 @@ namespace Evex
 	{
 		std::unordered_set<RegexNode<T>*> Nexts;
 
-		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return nullptr != dynamic_cast<const RegexNodeGhostIn*>(o); }
+		RegexNodeGhostIn() : RegexNodeBase<T>(RegexNodeKind::GhostIn) {}
+
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::GhostIn == inKind; }
+
+		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return IsKind(o->Kind); }
 
 		inline void Incorporate(const RegexNodeBase* o) final
 		{
-			const RegexNodeGhostIn* AsType = dynamic_cast<const RegexNodeGhostIn*>(o);
+			const RegexNodeGhostIn* AsType = RegexNodeCast<const RegexNodeGhostIn>(o);
 
 			if (AsType)
 				Nexts.insert(AsType->Nexts.begin(), AsType->Nexts.end());
 		}
 
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final { return true; }
-		inline std::vector<RegexNode<T>*> GetNexts() final;
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final { return true; }
 
 		StringType Draw(std::unordered_map<StringType, int>& TypeNumbers,
 			StringType& OutStr,
@@ -225,32 +347,21 @@ namespace Evex
 	{
 		std::unordered_set<RegexNodeGhostIn<T>*> GhostNexts;
 
-		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return nullptr != dynamic_cast<const RegexNodeGhostOut*>(o); }
+		RegexNodeGhostOut() : RegexNodeBase<T>(RegexNodeKind::GhostOut) {}
+
+		static inline bool IsKind(RegexNodeKind inKind) { return RegexNodeKind::GhostOut == inKind; }
+
+		inline bool SimilarTo(const RegexNodeBase<T>* o) const final { return IsKind(o->Kind); }
 
 		inline void Incorporate(const RegexNodeBase* o) final
 		{
-			const RegexNodeGhostOut* AsType = dynamic_cast<const RegexNodeGhostOut*>(o);
+			const RegexNodeGhostOut* AsType = RegexNodeCast<const RegexNodeGhostOut>(o);
 
 			if (AsType)
 				GhostNexts.insert(AsType->GhostNexts.begin(), AsType->GhostNexts.end());
 		}
 
-		inline bool CanEnter(IterType& Input, std::vector<RegexNode<T>*>* Outers = nullptr) final { return true; }
-
-		inline std::vector<RegexNode<T>*> GetNexts() final
-		{
-			std::unordered_set<RegexNode<T>*> Out;
-			for (RegexNodeGhostIn<T>* currNext : GhostNexts)
-			{
-				std::vector<RegexNode<T>*> NextNexts = currNext->GetNexts();
-				Out.insert(NextNexts.begin(), NextNexts.end());
-			}
-
-			std::vector<RegexNode<T>*> FinalOut;
-			FinalOut.insert(FinalOut.end(), Out.begin(), Out.end());
-
-			return FinalOut;
-		}
+		inline bool CanEnter(IterType& Input, RegexMatchContext<T>& MatchContext, std::vector<const RegexNode<T>*>* Outers = nullptr) const final { return true; }
 
 		StringType Draw(std::unordered_map<StringType, int>& TypeNumbers,
 			StringType& OutStr,
@@ -284,32 +395,4 @@ namespace Evex
 			return MyName;
 		}
 	};
-
-	template<typename T>
-	inline std::vector<RegexNode<T>*> RegexNode<T>::GetNexts()
-	{
-		std::unordered_set<RegexNode<T>*> Out;
-		for (RegexNode<T>* currNext : Nexts)
-			Out.insert(currNext);
-
-		for (RegexNodeGhostOut<T>* currGhostNext : GhostNexts)
-		{
-			std::vector<RegexNode<T>*> Throughs = currGhostNext->GetNexts();
-			Out.insert(Throughs.begin(), Throughs.end());
-		}
-
-		std::vector<RegexNode<T>*> FinalOut;
-		FinalOut.insert(FinalOut.end(), Out.begin(), Out.end());
-
-		return FinalOut;
-	}
-
-	template<typename T>
-	inline std::vector<RegexNode<T>*> RegexNodeGhostIn<T>::GetNexts()
-	{
-		std::vector<RegexNode<T>*> FinalOut;
-		FinalOut.insert(FinalOut.end(), Nexts.begin(), Nexts.end());
-
-		return FinalOut;
-	}
 }
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "EvexCharacterClass.h"
+
+#include <cstddef>
+#include <string>
+#include <cstring>
+#include <algorithm>
+
+
+namespace Evex
+{
+	/*
+		Cheap test of where a match could possibly start, taken from the start of the automaton.
+
+		Literal is a run of characters every match must start with, if the regex starts that way.
+		Otherwise FirstBytes, if present, is the set of bytes any match must start with.
+		Either lets the matcher jump straight between candidate offsets rather than trying each one.
+	*/
+	template<typename T>
+	struct RegexPrefilter
+	{
+		std::basic_string<T> Literal;
+
+		bool HasFirstBytes = false;
+		RegexByteBitmap FirstBytes;
+
+		inline bool IsActive() const { return !Literal.empty() || HasFirstBytes; }
+
+		void Clear()
+		{
+			Literal.clear();
+			HasFirstBytes = false;
+			FirstBytes = RegexByteBitmap();
+		}
+
+		// Could a match start at the given offset? Offset must be within the input.
+		inline bool CanStartAt(const T* Data, ptrdiff_t Length, ptrdiff_t Offset) const
+		{
+			if (!Literal.empty())
+				return Length - Offset >= ptrdiff_t(Literal.size()) && std::equal(Literal.begin(), Literal.end(), Data + Offset);
+			if (HasFirstBytes)
+				return FirstBytes.Test((unsigned char)Data[Offset]);
+			return true;
+		}
+
+		// Gets the first offset at or after From a match could start at, or -1 if there's none.
+		ptrdiff_t NextCandidate(const T* Data, ptrdiff_t Length, ptrdiff_t From) const
+		{
+			if (From >= Length)
+				return -1;
+
+			if (!Literal.empty())
+				return FindLiteral(Data, Length, From);
+
+			if (HasFirstBytes)
+			{
+				for (ptrdiff_t currOffset = From; currOffset < Length; ++currOffset)
+				{
+					if (FirstBytes.Test((unsigned char)Data[currOffset]))
+						return currOffset;
+				}
+
+				return -1;
+			}
+
+			return From;
+		}
+
+	private:
+		ptrdiff_t FindLiteral(const T* Data, ptrdiff_t Length, ptrdiff_t From) const
+		{
+			const ptrdiff_t LiteralLength = ptrdiff_t(Literal.size());
+
+			if (sizeof(T) == 1)
+			{
+				// Jump between occurrences of the first character, only comparing the rest where it's found.
+				const T* Curr = Data + From;
+				const T* Last = Data + Length - LiteralLength;
+				while (Curr <= Last)
+				{
+					Curr = static_cast<const T*>(memchr(Curr, (unsigned char)Literal[0], size_t(Last - Curr) + 1));
+					if (nullptr == Curr)
+						return -1;
+
+					if (0 == memcmp(Curr + 1, Literal.data() + 1, size_t(LiteralLength - 1)))
+						return Curr - Data;
+
+					++Curr;
+				}
+
+				return -1;
+			}
+
+			const T* Found = std::search(Data + From, Data + Length, Literal.begin(), Literal.end());
+			return (Found == Data + Length ? -1 : Found - Data);
+		}
+	};
+}
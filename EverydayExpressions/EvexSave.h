@@ -4,20 +4,65 @@
 
 #include <fstream>
 #include <streambuf>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
 
 namespace Evex
 {
+	/*
+		Text format: "EVXT" and the format's version on the first line, then the instruction count, then a line per
+		instruction holding its type, its operand count, and its operands, each as a kind tag followed by its value:
+		"i" and an integer, "t" or "f" for a bool, "c" and a character's code, or "n", a length, and that many characters of name.
+	
+		Version 1 files, from before operands were tagged by kind, have no first line. Their operands are untyped strings
+		whose layout has since changed per instruction, so they're refused rather than read as something they aren't.
+	*/
+	struct RegexTextFormat
+	{
+		static const int Version = 2;
+	};
+	
 	template<typename T>
-	std::basic_ofstream<T>& operator<<(std::basic_ofstream<T>& lhs, std::vector<RegexInstruction<T>>& rhs)
+	std::basic_ofstream<T>& operator<<(std::basic_ofstream<T>& lhs, const RegexProgram<T>& rhs)
 	{
 		std::basic_stringstream<T> Output;
-
+	
+		Output << "EVXT " << RegexTextFormat::Version << "\n";
 		Output << rhs.size() << " \n";
-		for (RegexInstruction<T>& currInst : rhs)
+		for (const RegexInstruction& currInst : rhs.Instructions)
 		{
-			Output << T(currInst.InstructionType) << " " << currInst.InstructionData.size() << " ";
-			for (std::basic_string<T> currData : currInst.InstructionData)
-				Output << size_t(currData.length()) << " " << currData << " ";
+			Output << T(currInst.InstructionType) << " " << currInst.OperandCount << " ";
+
+			const RegexOperand<T>* Operands = rhs.GetOperands(currInst);
+			for (uint32_t i = 0; i < currInst.OperandCount; ++i)
+			{
+				const RegexOperand<T>& currOperand = Operands[i];
+				switch (currOperand.Kind)
+				{
+				case RegexOperandKind::Int:
+					Output << "i" << currOperand.Int << " ";
+					break;
+
+				case RegexOperandKind::Bool:
+					Output << (currOperand.Bool ? "t " : "f ");
+					break;
+
+				case RegexOperandKind::Char:
+					Output << "c" << int(currOperand.Char) << " ";
+					break;
+
+				case RegexOperandKind::Name:
+					Output << "n" << currOperand.Name.Length << " " << rhs.GetName(currOperand) << " ";
+					break;
+
+				default:
+					break;
+				}
+			}
 			Output << "\n";
 		}
 
@@ -25,9 +70,12 @@ namespace Evex
 		return lhs;
 	}
 
+	// Sets failbit and leaves the list empty if the file isn't in the current text format or is malformed.
 	template<typename T>
-	std::basic_ifstream<T>& operator>>(std::basic_ifstream<T>& lhs, std::vector<RegexInstruction<T>>& rhs)
+	std::basic_ifstream<T>& operator>>(std::basic_ifstream<T>& lhs, RegexProgram<T>& rhs)
 	{
+		using IterType = typename std::basic_string<T>::iterator;
+
 		std::basic_string<T> Input;
 
 		lhs.seekg(0, std::ios::end);
@@ -36,56 +84,96 @@ namespace Evex
 
 		Input.assign((std::istreambuf_iterator<char>(lhs)), std::istreambuf_iterator<char>());
 
-		auto iter = Input.begin();
+		// Reads a possibly negative decimal number, and skips the separator after it.
+		auto ReadNumber = [&Input](IterType& iter)
+		{
+			bool Negative = iter != Input.end() && *iter == '-';
+			if (Negative)
+				++iter;
+
+			int Out = 0;
+			while (iter != Input.end() && isdigit(*iter))
+			{
+				Out = Out * 10 + int(*iter - '0');
+				++iter;
+			}
+
+			if (iter != Input.end())
+				++iter;
+			return Negative ? -Out : Out;
+		};
 
-		std::basic_string<T> Munch;
-		while (isdigit(*iter))
+		auto Fail = [&lhs, &rhs]() -> std::basic_ifstream<T>&
 		{
-			Munch += *iter;
+			rhs.clear();
+			lhs.setstate(std::ios::failbit);
+			return lhs;
+		};
+	
+		rhs.clear();
+	
+		const T Marker[] = { 'E', 'V', 'X', 'T', ' ' };
+		if (Input.size() < std::size(Marker) || !std::equal(std::begin(Marker), std::end(Marker), Input.begin()))
+			return Fail();
+	
+		IterType iter = Input.begin() + std::size(Marker);
+		if (ReadNumber(iter) != RegexTextFormat::Version)
+			return Fail();
+	
+		rhs.Instructions.reserve(size_t(std::max(ReadNumber(iter), 0)));
+		if (iter != Input.end())
 			++iter;
-		}
-		++(++iter);
-		rhs.reserve(std::stoi(Munch));
 
 		while (iter < Input.end())
 		{
-			rhs.push_back({});
-			RegexInstruction<T>& currInstruction = rhs.back();
-			currInstruction.InstructionType = RegexInstructionType(uint8_t(*iter));
+			if (uint8_t(*iter) >= uint8_t(RegexInstructionType::MAX))
+				return Fail();
+	
+			rhs.Add(RegexInstructionType(uint8_t(*iter)));
 			++(++iter);
 
-			Munch.clear();
-			while (isdigit(*iter))
+			int NumOperands = ReadNumber(iter);
+			while (NumOperands-- > 0)
 			{
-				Munch += *iter;
-				++iter;
-			}
-			++iter;
-
-			size_t NumStrings = std::stoi(Munch);
+				if (iter == Input.end())
+					return Fail();
 
-			while (NumStrings-- > 0)
-			{
-				Munch.clear();
-				while (isdigit(*iter))
+				T Kind = *(iter++);
+				switch (Kind)
 				{
-					Munch += *iter;
-					++iter;
-				}
-				++iter;
+				case 'i':
+					rhs.AddOperand(ReadNumber(iter));
+					break;
 
-				size_t NextStringLength = std::stoi(Munch);
-				std::basic_string<T> NextString;
-				while (NextStringLength-- > 0)
-				{
-					NextString += *iter;
-					++iter;
-				}
-				++iter;
+				case 't':
+				case 'f':
+					rhs.AddOperand(Kind == 't');
+					if (iter != Input.end())
+						++iter;
+					break;
 
-				currInstruction.InstructionData.push_back(NextString);
+				case 'c':
+					rhs.AddOperand(T(ReadNumber(iter)));
+					break;
+
+				case 'n':
+					{
+						int NameLength = ReadNumber(iter);
+						if (NameLength < 0 || NameLength >= Input.end() - iter)
+							return Fail();
+
+						rhs.AddOperand(rhs.Name(std::basic_string_view<T>(&*iter, size_t(NameLength))));
+						iter += NameLength + 1;
+					}
+					break;
+
+				default:
+					return Fail();
+				}
 			}
-			++iter;
+
+			if (iter != Input.end())
+				++iter;
 		}
 
 		return lhs;
@@ -95,7 +183,7 @@ namespace Evex
 		Saves a given regex instruction list out to file so that it can be reloaded later.
 	*/
 	template<typename T>
-	static bool SaveRegex(std::vector<RegexInstruction<T>> Instructions, const std::basic_string<T>& Filepath)
+	static bool SaveRegex(const RegexProgram<T>& Instructions, const std::basic_string<T>& Filepath)
 	{
 		std::basic_ofstream<T> FileStream(Filepath.c_str(), std::ofstream::out | std::ofstream::trunc);
 		if (FileStream.is_open())
@@ -109,17 +197,430 @@ namespace Evex
 
 	/*
 		Loads a regex instruction list from a specified file, allowing you to skip the parsing phase and move straight to the assembly phase.
+		Returns an empty list if the file can't be read, giving the reason through OutLoadError if asked.
 	*/
 	template<typename T>
-	static std::vector<RegexInstruction<T>> LoadRegex(const std::basic_string<T>& Filepath)
+	static RegexProgram<T> LoadRegex(const std::basic_string<T>& Filepath, std::string* OutLoadError = nullptr)
 	{
-		std::vector<RegexInstruction<T>> Instructions;
+		RegexProgram<T> Instructions;
 		std::basic_ifstream<T> FileStream(Filepath.c_str());
 		if (FileStream.is_open())
 		{
-			FileStream >> Instructions;
+			if (!(FileStream >> Instructions) && OutLoadError)
+				*OutLoadError = "Regex Load Error: Not an Evex text file of version " + std::to_string(RegexTextFormat::Version) +
+					". Files saved before operands were tagged by kind have to be saved again from their patterns.";
 			FileStream.close();
 		}
+		else if (OutLoadError)
+			*OutLoadError = "Regex Load Error: Couldn't open file.";
 		return Instructions;
 	}
+
+	/*
+		Binary format for saved instruction lists, holding any number of patterns in one file.
+
+		Header (fixed-width, little-endian):
+			char[4] Magic ("EVXB"), u16 Version, u8 size of T, u8 reserved,
+			u32 pattern count, u32 string count, u32 body size, u32 checksum of the body.
+		Body:
+			u32 offset of each pattern's record within the body,
+			the string table: each distinct name once, as a varint length
+				then its characters, padded so they start on a multiple of the size of T,
+			each pattern's record: a varint instruction count, then for each instruction
+				a u8 type, a varint operand count, and per operand a u8 kind followed by
+				a zigzag varint (int), a u8 (bool), a varint (character) or a varint string table index (name).
+
+		The checksum is 32-bit FNV-1a, guarding against truncated or corrupted files, not tampering.
+	*/
+	struct RegexBinaryFormat
+	{
+		static const uint16_t Version = 2;
+		static const size_t HeaderSize = 24;
+
+		static inline bool HasMagic(const unsigned char* Data) { return 'E' == Data[0] && 'V' == Data[1] && 'X' == Data[2] && 'B' == Data[3]; }
+
+		static uint32_t Checksum(const unsigned char* Data, size_t Size)
+		{
+			uint32_t Out = 2166136261u;
+			for (size_t i = 0; i < Size; ++i)
+			{
+				Out ^= Data[i];
+				Out *= 16777619u;
+			}
+			return Out;
+		}
+
+		static inline void PutFixed(std::string& Out, uint32_t Value, int Bytes)
+		{
+			for (int i = 0; i < Bytes; ++i)
+				Out += char((Value >> (8 * i)) & 0xFF);
+		}
+
+		static inline void SetFixed(std::string& Out, size_t At, uint32_t Value)
+		{
+			for (int i = 0; i < 4; ++i)
+				Out[At + i] = char((Value >> (8 * i)) & 0xFF);
+		}
+
+		static inline uint32_t GetFixed(const unsigned char* Data, int Bytes)
+		{
+			uint32_t Out = 0;
+			for (int i = 0; i < Bytes; ++i)
+				Out |= uint32_t(Data[i]) << (8 * i);
+			return Out;
+		}
+
+		static inline void PutVarint(std::string& Out, uint32_t Value)
+		{
+			while (Value >= 0x80)
+			{
+				Out += char((Value & 0x7F) | 0x80);
+				Value >>= 7;
+			}
+			Out += char(Value);
+		}
+
+		static inline uint32_t ZigZag(int Value) { return (uint32_t(Value) << 1) ^ uint32_t(Value >> 31); }
+		static inline int UnZigZag(uint32_t Value) { return int(Value >> 1) ^ -int(Value & 1); }
+	
+		// Reads a varint at Pos, moving Pos past it. Returns false if it runs past End or is too long.
+		static inline bool GetVarint(const unsigned char* Data, size_t& Pos, size_t End, uint32_t& OutValue)
+		{
+			OutValue = 0;
+			for (int Shift = 0; Shift < 35; Shift += 7)
+			{
+				if (Pos >= End)
+					return false;
+
+				unsigned char Byte = Data[Pos++];
+				OutValue |= uint32_t(Byte & 0x7F) << Shift;
+				if (0 == (Byte & 0x80))
+					return true;
+			}
+			return false;
+		}
+	};
+
+	/*
+		Writes instruction lists out in the binary format, either to a buffer or to a file.
+		Returns false if the patterns are too large for the format's 32-bit fields, or the file can't be written.
+	*/
+	template<typename T>
+	static bool WriteRegexBinary(const std::vector<RegexProgram<T>>& Patterns, std::string& OutBuffer)
+	{
+		using Format = RegexBinaryFormat;
+		using StringViewType = std::basic_string_view<T>;
+	
+		std::unordered_map<StringViewType, uint32_t> StringIds;
+		std::vector<StringViewType> Strings;
+		for (const RegexProgram<T>& currPattern : Patterns)
+		{
+			for (const RegexInstruction& currInst : currPattern.Instructions)
+			{
+				const RegexOperand<T>* Operands = currPattern.GetOperands(currInst);
+				for (uint32_t i = 0; i < currInst.OperandCount; ++i)
+				{
+					if (Operands[i].Kind != RegexOperandKind::Name)
+						continue;
+	
+					StringViewType Name = currPattern.GetName(Operands[i]);
+					if (StringIds.emplace(Name, uint32_t(Strings.size())).second)
+						Strings.push_back(Name);
+				}
+			}
+		}
+
+		OutBuffer.clear();
+		Format::PutFixed(OutBuffer, 'E' | ('V' << 8) | ('X' << 16) | ('B' << 24), 4);
+		Format::PutFixed(OutBuffer, Format::Version, 2);
+		Format::PutFixed(OutBuffer, uint32_t(sizeof(T)), 1);
+		Format::PutFixed(OutBuffer, 0, 1);
+		Format::PutFixed(OutBuffer, uint32_t(Patterns.size()), 4);
+		Format::PutFixed(OutBuffer, uint32_t(Strings.size()), 4);
+		Format::PutFixed(OutBuffer, 0, 4); // body size, filled in below
+		Format::PutFixed(OutBuffer, 0, 4); // checksum, filled in below
+
+		const size_t OffsetTable = OutBuffer.size();
+		OutBuffer.resize(OutBuffer.size() + 4 * Patterns.size());
+
+		for (const StringViewType& currString : Strings)
+		{
+			Format::PutVarint(OutBuffer, uint32_t(currString.size()));
+			while (0 != OutBuffer.size() % sizeof(T))
+				OutBuffer += '\0';
+			OutBuffer.append(reinterpret_cast<const char*>(currString.data()), currString.size() * sizeof(T));
+		}
+
+		for (size_t i = 0; i < Patterns.size(); ++i)
+		{
+			Format::SetFixed(OutBuffer, OffsetTable + 4 * i, uint32_t(OutBuffer.size() - Format::HeaderSize));
+
+			Format::PutVarint(OutBuffer, uint32_t(Patterns[i].size()));
+			for (const RegexInstruction& currInst : Patterns[i].Instructions)
+			{
+				Format::PutFixed(OutBuffer, uint32_t(currInst.InstructionType), 1);
+				Format::PutVarint(OutBuffer, currInst.OperandCount);
+	
+				const RegexOperand<T>* Operands = Patterns[i].GetOperands(currInst);
+				for (uint32_t j = 0; j < currInst.OperandCount; ++j)
+				{
+					const RegexOperand<T>& currOperand = Operands[j];
+					Format::PutFixed(OutBuffer, uint32_t(currOperand.Kind), 1);
+	
+					switch (currOperand.Kind)
+					{
+					case RegexOperandKind::Int:
+						Format::PutVarint(OutBuffer, Format::ZigZag(currOperand.Int));
+						break;
+	
+					case RegexOperandKind::Bool:
+						Format::PutFixed(OutBuffer, currOperand.Bool ? 1 : 0, 1);
+						break;
+	
+					case RegexOperandKind::Char:
+						Format::PutVarint(OutBuffer, uint32_t(typename std::make_unsigned<T>::type(currOperand.Char)));
+						break;
+	
+					default:
+						Format::PutVarint(OutBuffer, StringIds[Patterns[i].GetName(currOperand)]);
+						break;
+					}
+				}
+			}
+		}
+
+		const size_t BodySize = OutBuffer.size() - Format::HeaderSize;
+		if (BodySize > UINT32_MAX || Patterns.size() > UINT32_MAX)
+			return false;
+
+		Format::SetFixed(OutBuffer, 16, uint32_t(BodySize));
+		Format::SetFixed(OutBuffer, 20, Format::Checksum(reinterpret_cast<const unsigned char*>(OutBuffer.data()) + Format::HeaderSize, BodySize));
+		return true;
+	}
+
+	template<typename T>
+	static bool SaveRegexBinary(const std::vector<RegexProgram<T>>& Patterns, const std::string& Filepath)
+	{
+		std::string Buffer;
+		if (!WriteRegexBinary<T>(Patterns, Buffer))
+			return false;
+
+		std::ofstream FileStream(Filepath.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+		if (!FileStream.is_open())
+			return false;
+
+		FileStream.write(Buffer.data(), std::streamsize(Buffer.size()));
+		return bool(FileStream);
+	}
+
+	template<typename T>
+	static bool SaveRegexBinary(const RegexProgram<T>& Instructions, const std::string& Filepath)
+	{
+		return SaveRegexBinary<T>(std::vector<RegexProgram<T>>{ Instructions }, Filepath);
+	}
+
+	/*
+		Reads instruction lists saved in the binary format straight out of a buffer, e.g. a mapped file, without copying it.
+		The header and checksum are checked up front, and the string table is indexed as views into the buffer,
+		which must outlive the reader. Patterns are only decoded when asked for.
+	*/
+	template<typename T>
+	class RegexBinaryReader
+	{
+	public:
+		using StringViewType = std::basic_string_view<T>;
+
+		RegexBinaryReader(const char* inData, size_t inSize) : Data(reinterpret_cast<const unsigned char*>(inData)), Size(inSize) { Open(); }
+
+		bool IsValid() const { return LoadError.empty(); }
+		std::string GetLoadError() const { return LoadError; }
+
+		// Number of patterns held.
+		inline size_t size() const { return PatternOffsets.size(); }
+
+		inline size_t GetStringCount() const { return Strings.size(); }
+		inline StringViewType GetString(size_t Index) const { return Strings[Index]; }
+
+		/*
+			Decodes the instruction list of the given pattern.
+			Returns an empty list if the reader isn't valid or the pattern's record is malformed.
+		*/
+		RegexProgram<T> GetInstructions(size_t Index) const
+		{
+			using Format = RegexBinaryFormat;
+	
+			RegexProgram<T> Out;
+			if (!IsValid() || Index >= size())
+				return Out;
+	
+			size_t Pos = Format::HeaderSize + PatternOffsets[Index];
+			uint32_t InstructionCount = 0;
+			if (!Format::GetVarint(Data, Pos, Size, InstructionCount) || InstructionCount > Size - Pos)
+				return Out;
+	
+			Out.Instructions.reserve(InstructionCount);
+			while (InstructionCount-- > 0)
+			{
+				uint32_t OperandCount = 0;
+				if (Pos >= Size || Data[Pos] >= uint8_t(RegexInstructionType::MAX))
+					return {};
+				Out.Add(RegexInstructionType(Data[Pos++]));
+	
+				if (!Format::GetVarint(Data, Pos, Size, OperandCount) || OperandCount > Size - Pos)
+					return {};
+	
+				while (OperandCount-- > 0)
+				{
+					uint32_t Value = 0;
+					if (Pos >= Size)
+						return {};
+	
+					switch (RegexOperandKind(Data[Pos++]))
+					{
+					case RegexOperandKind::Int:
+						if (!Format::GetVarint(Data, Pos, Size, Value))
+							return {};
+						Out.AddOperand(Format::UnZigZag(Value));
+						break;
+	
+					case RegexOperandKind::Bool:
+						if (Pos >= Size)
+							return {};
+						Out.AddOperand(0 != Data[Pos++]);
+						break;
+	
+					case RegexOperandKind::Char:
+						if (!Format::GetVarint(Data, Pos, Size, Value))
+							return {};
+						Out.AddOperand(T(Value));
+						break;
+	
+					case RegexOperandKind::Name:
+						if (!Format::GetVarint(Data, Pos, Size, Value) || Value >= Strings.size())
+							return {};
+						Out.AddOperand(Out.Name(Strings[Value]));
+						break;
+	
+					default:
+						return {};
+					}
+				}
+			}
+	
+			return Out;
+		}
+
+	private:
+		const unsigned char* Data = nullptr;
+		size_t Size = 0;
+
+		std::string LoadError = "";
+
+		std::vector<uint32_t> PatternOffsets;
+		std::vector<StringViewType> Strings;
+
+		void Open()
+		{
+			using Format = RegexBinaryFormat;
+
+			if (nullptr == Data || Size < Format::HeaderSize || !Format::HasMagic(Data))
+			{
+				LoadError = "Regex Load Error: Not an Evex binary file.";
+				return;
+			}
+
+			if (Format::GetFixed(Data + 4, 2) != Format::Version)
+			{
+				LoadError = "Regex Load Error: Unsupported format version " + std::to_string(Format::GetFixed(Data + 4, 2)) + ".";
+				return;
+			}
+
+			if (Format::GetFixed(Data + 6, 1) != sizeof(T))
+			{
+				LoadError = "Regex Load Error: File was saved for a different character size.";
+				return;
+			}
+
+			const uint32_t PatternCount = Format::GetFixed(Data + 8, 4);
+			const uint32_t StringCount = Format::GetFixed(Data + 12, 4);
+			const uint32_t BodySize = Format::GetFixed(Data + 16, 4);
+
+			if (BodySize != Size - Format::HeaderSize)
+			{
+				LoadError = "Regex Load Error: File is truncated or has trailing data.";
+				return;
+			}
+
+			if (Format::GetFixed(Data + 20, 4) != Format::Checksum(Data + Format::HeaderSize, BodySize))
+			{
+				LoadError = "Regex Load Error: Checksum mismatch.";
+				return;
+			}
+
+			size_t Pos = Format::HeaderSize;
+			if (size_t(PatternCount) * 4 > Size - Pos)
+			{
+				LoadError = "Regex Load Error: Malformed pattern table.";
+				return;
+			}
+
+			PatternOffsets.resize(PatternCount);
+			for (uint32_t& currOffset : PatternOffsets)
+			{
+				currOffset = Format::GetFixed(Data + Pos, 4);
+				Pos += 4;
+
+				if (currOffset >= BodySize)
+				{
+					LoadError = "Regex Load Error: Malformed pattern table.";
+					return;
+				}
+			}
+
+			if (StringCount > Size - Pos)
+			{
+				LoadError = "Regex Load Error: Malformed string table.";
+				return;
+			}
+
+			Strings.reserve(StringCount);
+			for (uint32_t i = 0; i < StringCount; ++i)
+			{
+				uint32_t Length = 0;
+				if (!Format::GetVarint(Data, Pos, Size, Length))
+				{
+					LoadError = "Regex Load Error: Malformed string table.";
+					return;
+				}
+
+				while (0 != Pos % sizeof(T))
+					++Pos;
+
+				if (Pos > Size || Length > (Size - Pos) / sizeof(T))
+				{
+					LoadError = "Regex Load Error: Malformed string table.";
+					return;
+				}
+
+				Strings.emplace_back(reinterpret_cast<const T*>(Data + Pos), Length);
+				Pos += size_t(Length) * sizeof(T);
+			}
+		}
+	};
+
+	/*
+		Loads the first instruction list from a file saved in the binary format. To read many out of one file
+		without copying it, map it with a RegexMappedFile (see EvexFile.h) and hand its contents to a RegexBinaryReader.
+		Returns an empty list if the file can't be read or isn't valid, as LoadRegex does.
+	*/
+	template<typename T>
+	static RegexProgram<T> LoadRegexBinary(const std::string& Filepath)
+	{
+		std::ifstream FileStream(Filepath.c_str(), std::ios::binary);
+		if (!FileStream.is_open())
+			return {};
+	
+		std::vector<char> Contents((std::istreambuf_iterator<char>(FileStream)), std::istreambuf_iterator<char>());
+		return RegexBinaryReader<T>(Contents.data(), Contents.size()).GetInstructions(0);
+	}
 }
@@ -0,0 +1,339 @@
+#pragma once
+
+#include "Evex.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
+
+
+namespace Evex
+{
+	/*
+		Many regexes matched against the same input at once, finding which of them match anywhere within it.
+
+		Patterns made only of plain nodes are merged under one shared root: their state tables are walked side by
+		side as a single lazily built DFA, each state of which is the set of (pattern, state) pairs in flight, so
+		each byte of input costs one cached lookup however many such patterns there are. They're kept apart rather
+		than merged into one graph as Collapse does for alternation branches, since each pattern's greedy choices
+		would otherwise cut off the others'.
+		Every other pattern is only tried at offsets its prefilter allows, found by looking up the byte there.
+
+		Matching fills in the merged DFA and goes through each pattern's own context, so it changes the set.
+		Sets can't be matched through from more than one thread at once; give each thread a set of its own.
+	*/
+	template<typename T>
+	class RegexSet
+	{
+	public:
+		using FuncMapType = typename Regex<T>::FuncMapType;
+
+		// Default cap on the merged DFA's memory, in bytes.
+		static const size_t DefaultMemoryLimit = 1 << 22;
+
+		RegexSet(const std::vector<std::basic_string<T>>& inPatterns, FuncMapType* Funcs = nullptr)
+		{
+			for (const std::basic_string<T>& currPattern : inPatterns)
+				Patterns.push_back(std::make_unique<Regex<T>>(currPattern, Funcs));
+
+			Build();
+		}
+
+		RegexSet(const std::vector<RegexProgram<T>>& PatternInstructions, FuncMapType* Funcs = nullptr)
+		{
+			for (const RegexProgram<T>& currInstructions : PatternInstructions)
+				Patterns.push_back(std::make_unique<Regex<T>>(currInstructions, Funcs));
+
+			Build();
+		}
+
+		inline size_t size() const { return Patterns.size(); }
+		inline const Regex<T>& GetPattern(size_t Index) const { return *Patterns[Index]; }
+
+		bool IsValidForMatching() const { return CompileError.empty(); }
+		std::string GetCompileError() const { return CompileError; }
+		const std::vector<std::string>& GetRuntimeErrors() const { return RuntimeErrors; }
+
+		// Caps the memory used by the merged DFA. Clears it.
+		void SetDfaMemoryLimit(size_t Bytes) { MemoryLimit = Bytes; Flush(); }
+		size_t GetDfaMemoryLimit() const { return MemoryLimit; }
+
+		// Returns true if any pattern matches anywhere in the given text. OutMatched is given the index of each that does, in ascending order.
+		inline bool MatchAll(std::basic_string_view<T> String, std::vector<int>& OutMatched) { return MatchAllInternal(String.data(), String.data() + String.size(), OutMatched); }
+
+		/*
+			As above, with OutResults[i] also given every match of pattern OutMatched[i], as its own MatchAll would give them.
+			Only patterns found to match are run again for their positions.
+		*/
+		bool MatchAll(std::basic_string_view<T> String, std::vector<int>& OutMatched, std::vector<RegexMatchResults<T>>& OutResults)
+		{
+			const T* Begin = String.data();
+			const T* End = Begin + String.size();
+
+			bool Success = MatchAllInternal(Begin, End, OutMatched);
+
+			OutResults.resize(OutMatched.size());
+			for (size_t i = 0; i < OutMatched.size(); ++i)
+			{
+				Regex<T>& Pattern = *Patterns[OutMatched[i]];
+				Pattern.MatchAllInternal(Begin, End, OutResults[i], Pattern.DefaultContext);
+			}
+
+			return Success;
+		}
+
+	private:
+		using MemberList = std::vector<std::pair<int, int>>;
+
+		enum : int
+		{
+			// Transition not computed yet.
+			Unknown = -1
+		};
+
+		std::vector<std::unique_ptr<Regex<T>>> Patterns;
+
+		std::string CompileError = "";
+		std::vector<std::string> RuntimeErrors;
+
+		// Patterns run as part of the merged DFA.
+		std::vector<int> Merged;
+
+		// Other patterns, either by a byte every match must start with, or if they could start with any.
+		std::vector<int> ByFirstByte[256];
+		std::vector<int> AnyFirstByte;
+
+		// Patterns whose matches depend on where the last one ended (i.e. "\\G") or on code hooks, and so are run through MatchAll.
+		std::vector<int> WholeInput;
+
+		/*
+			The merged DFA. Each state is a sorted list of (index into Merged, state) pairs, with state 0 being the empty list.
+			Transitions are filled in as the input comes across them, along with the patterns found to have matched on each.
+			Lists are held once, as keys of DfaStateIds, which DfaStates points to by state.
+		*/
+		std::vector<const MemberList*> DfaStates;
+		std::map<MemberList, int> DfaStateIds;
+		size_t MemberBytes = 0;
+		std::vector<int> Transitions;
+		std::vector<int> TransitionMatches;
+		std::vector<std::vector<int>> MatchLists;
+
+		size_t MemoryLimit = DefaultMemoryLimit;
+
+		// Which patterns have been found to match in the current input.
+		std::vector<bool> Found;
+		size_t FoundCount = 0;
+
+		// Scratch results for patterns run through MatchAll.
+		RegexMatchResults<T> WholeInputResults;
+
+		void Build()
+		{
+			for (size_t i = 0; i < Patterns.size(); ++i)
+			{
+				const Regex<T>& Pattern = *Patterns[i];
+				if (!Pattern.IsValidForMatching())
+				{
+					if (CompileError.empty())
+						CompileError = "Pattern " + std::to_string(i) + ": " + Pattern.GetCompileError();
+					continue;
+				}
+
+				const RegexPrefilter<T>& Prefilter = Pattern.Prefilter;
+				if (Pattern.AllFrontiersPlain)
+					Merged.push_back(int(i));
+				else if (!Pattern.CanMatchInParallel)
+					WholeInput.push_back(int(i));
+				else if (!Prefilter.Literal.empty())
+					ByFirstByte[(unsigned char)Prefilter.Literal[0]].push_back(int(i));
+				else if (Prefilter.HasFirstBytes)
+				{
+					for (int currByte = 0; currByte < 256; ++currByte)
+					{
+						if (Prefilter.FirstBytes.Test((unsigned char)currByte))
+							ByFirstByte[currByte].push_back(int(i));
+					}
+				}
+				else
+					AnyFirstByte.push_back(int(i));
+			}
+
+			Flush();
+		}
+
+		void Flush()
+		{
+			DfaStates.clear();
+			DfaStateIds.clear();
+			Transitions.clear();
+			TransitionMatches.clear();
+			MatchLists.clear();
+			MemberBytes = 0;
+
+			Intern(MemberList());
+		}
+
+		int Intern(const MemberList& Members)
+		{
+			auto Inserted = DfaStateIds.emplace(Members, int(DfaStates.size()));
+			if (!Inserted.second)
+				return Inserted.first->second;
+
+			int NewState = Inserted.first->second;
+			DfaStates.push_back(&Inserted.first->first);
+			MemberBytes += sizeof(MemberList) + Members.size() * sizeof(std::pair<int, int>);
+			Transitions.resize(Transitions.size() + 256, Unknown);
+			TransitionMatches.resize(TransitionMatches.size() + 256, -1);
+			return NewState;
+		}
+
+		/*
+			Fills in the transition of the given state on the given byte: every pair in flight steps over it,
+			and every merged pattern starts a new walk on it. Walks that can't take the byte finish there,
+			matching if their last state accepts. If the DFA is full it's flushed first, and State is moved to its new id.
+		*/
+		void ComputeTransition(int& State, unsigned char Byte)
+		{
+			// Each state's transitions and the patterns matched on them, besides its member list.
+			const size_t StateBytes = 256 * 2 * sizeof(int) + sizeof(const MemberList*);
+			if (DfaStates.size() >= 2 && DfaStates.size() * StateBytes + MemberBytes >= MemoryLimit)
+			{
+				MemberList Current = *DfaStates[State];
+				Flush();
+				State = Intern(Current);
+			}
+
+			const T Char = T(Byte);
+			RegexRangeIterator<T> Iter(&Char, &Char, &Char + 1);
+
+			MemberList Next;
+			std::vector<int> Matched;
+
+			auto Step =
+				[this, &Iter, &Next, &Matched](int Slot, int FromState)
+				{
+					Regex<T>& Pattern = *Patterns[Merged[Slot]];
+					int ToState = Pattern.StepPlain(FromState, Iter, Pattern.DefaultContext);
+					if (ToState >= 0)
+						Next.emplace_back(Slot, ToState);
+					else if (FromState >= 0 && Pattern.StateTable.IsAccepting(FromState, 0))
+						Matched.push_back(Merged[Slot]);
+				};
+
+			const MemberList& Current = *DfaStates[State];
+			for (const std::pair<int, int>& currMember : Current)
+				Step(currMember.first, currMember.second);
+
+			for (int currSlot = 0; currSlot < int(Merged.size()); ++currSlot)
+				Step(currSlot, -1);
+
+			std::sort(Next.begin(), Next.end());
+			Next.erase(std::unique(Next.begin(), Next.end()), Next.end());
+
+			int NextState = Intern(Next);
+
+			const size_t Index = (size_t(State) << 8) + Byte;
+			Transitions[Index] = NextState;
+
+			if (!Matched.empty())
+			{
+				std::sort(Matched.begin(), Matched.end());
+				Matched.erase(std::unique(Matched.begin(), Matched.end()), Matched.end());
+
+				TransitionMatches[Index] = int(MatchLists.size());
+				MatchLists.push_back(Matched);
+			}
+		}
+
+		inline void MarkFound(int Pattern)
+		{
+			if (!Found[Pattern])
+			{
+				Found[Pattern] = true;
+				++FoundCount;
+			}
+		}
+
+		// Tries a pattern outside the merged DFA at the given offset, unless it's already been found.
+		inline void TrySeparate(int PatternIndex, const T* Begin, const T* End, ptrdiff_t Offset)
+		{
+			if (Found[PatternIndex])
+				return;
+
+			Regex<T>& Pattern = *Patterns[PatternIndex];
+			Pattern.DefaultContext.RuntimeErrors.clear();
+
+			ptrdiff_t MatchEnd = -1, LastRead = -1;
+			if (Pattern.AttemptAt(Begin, End, Offset, MatchEnd, LastRead, Pattern.DefaultContext))
+				MarkFound(PatternIndex);
+
+			RuntimeErrors.insert(RuntimeErrors.end(), Pattern.DefaultContext.RuntimeErrors.begin(), Pattern.DefaultContext.RuntimeErrors.end());
+		}
+
+		bool MatchAllInternal(const T* Begin, const T* End, std::vector<int>& OutMatched)
+		{
+			if (!CompileError.empty())
+				throw RegexCompileException(CompileError);
+
+			RuntimeErrors.clear();
+			Found.assign(Patterns.size(), false);
+			FoundCount = 0;
+
+			for (int currPattern : WholeInput)
+			{
+				Regex<T>& Pattern = *Patterns[currPattern];
+				if (Pattern.MatchAllInternal(Begin, End, WholeInputResults, Pattern.DefaultContext) || !WholeInputResults.empty())
+					MarkFound(currPattern);
+			}
+
+			const ptrdiff_t Length = End - Begin;
+			int CurrState = 0;
+
+			for (ptrdiff_t currPos = 0; currPos < Length && FoundCount < Patterns.size(); ++currPos)
+			{
+				const unsigned char Byte = (unsigned char)Begin[currPos];
+
+				if (!Merged.empty())
+				{
+					if (Unknown == Transitions[(size_t(CurrState) << 8) + Byte])
+						ComputeTransition(CurrState, Byte);
+
+					const size_t Index = (size_t(CurrState) << 8) + Byte;
+					if (TransitionMatches[Index] >= 0)
+					{
+						for (int currPattern : MatchLists[TransitionMatches[Index]])
+							MarkFound(currPattern);
+					}
+
+					CurrState = Transitions[Index];
+				}
+
+				for (int currPattern : ByFirstByte[Byte])
+					TrySeparate(currPattern, Begin, End, currPos);
+
+				for (int currPattern : AnyFirstByte)
+					TrySeparate(currPattern, Begin, End, currPos);
+			}
+
+			// Whatever's still in flight at the end of the input finishes there.
+			for (const std::pair<int, int>& currMember : *DfaStates[CurrState])
+			{
+				const Regex<T>& Pattern = *Patterns[Merged[currMember.first]];
+				if (Pattern.StateTable.IsAccepting(currMember.second, 0))
+					MarkFound(Merged[currMember.first]);
+			}
+
+			OutMatched.clear();
+			for (size_t i = 0; i < Patterns.size(); ++i)
+			{
+				if (Found[i])
+					OutMatched.push_back(int(i));
+			}
+
+			return !OutMatched.empty();
+		}
+	};
+}
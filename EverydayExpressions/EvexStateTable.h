@@ -0,0 +1,177 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+
+namespace Evex
+{
+	template<typename T> struct RegexNode;
+	template<typename T> struct RegexTicker;
+	template<typename T> struct RegexMatchContext;
+
+	/*
+		Flattened form of a finished regex automaton.
+
+		Every reachable RegexNode is given an integer state index in breadth-first order, and the
+		ghost-resolved successors of each state are laid out contiguously (CSR-style), so traversal
+		never has to chase ghost nodes or iterate hash sets during a match.
+
+		A 'context' is a set of entry states paired with the set of exits that count as reaching
+		the end, i.e. the whole regex (always context 0) or the inside of a group node.
+	*/
+	template<typename T>
+	struct RegexStateTable
+	{
+		// The node occupying each state index.
+		std::vector<RegexNode<T>*> States;
+
+		// Successors of state i are Edges[EdgeStarts[i]] up to Edges[EdgeStarts[i + 1]], in order of priority.
+		std::vector<unsigned int> EdgeStarts = { 0 };
+		std::vector<int> Edges;
+
+		// Exits (i.e. ghost-out ids) directly reachable from state i, laid out the same way as Edges.
+		std::vector<unsigned int> ExitStarts = { 0 };
+		std::vector<int> Exits;
+
+		// Ticker bound to state i if it is a loop. Its times are stored and reset when first tried within a sub-match.
+		std::vector<RegexTicker<T>*> LoopTickers;
+
+		// Mandatory ticker which, while it has yet to be exhausted, restricts state i's successors to itself.
+		std::vector<RegexTicker<T>*> GateTickers;
+
+		// Selves[i] == i. Backs the single-successor list used by gated loops.
+		std::vector<int> Selves;
+
+		// Entry states and accepting exits of each context, laid out the same way as Edges.
+		std::vector<unsigned int> ContextEntryStarts = { 0 };
+		std::vector<int> ContextEntries;
+		std::vector<unsigned int> ContextExitStarts = { 0 };
+		std::vector<int> ContextExits;
+
+		// Contexts fully matched upon entering state i, sorted and laid out the same way as Edges. Worked out from the exits once every context is in.
+		std::vector<unsigned int> AcceptStarts = { 0 };
+		std::vector<int> AcceptingContexts;
+
+		inline int StateCount() const { return int(States.size()); }
+		inline int ContextCount() const { return int(ContextEntryStarts.size() - 1); }
+
+		inline void GetEntries(int Context, const int*& OutBegin, const int*& OutEnd) const
+		{
+			OutBegin = ContextEntries.data() + ContextEntryStarts[Context];
+			OutEnd = ContextEntries.data() + ContextEntryStarts[Context + 1];
+		}
+
+		inline void GetSuccessors(int State, const RegexMatchContext<T>& MatchContext, const int*& OutBegin, const int*& OutEnd) const
+		{
+			RegexTicker<T>* Gate = GateTickers[State];
+			if (Gate && !Gate->IsExhausted(MatchContext))
+			{
+				OutBegin = &Selves[State];
+				OutEnd = OutBegin + 1;
+				return;
+			}
+
+			OutBegin = Edges.data() + EdgeStarts[State];
+			OutEnd = Edges.data() + EdgeStarts[State + 1];
+		}
+
+		// Does entering the given state mean the given context has been fully matched?
+		inline bool IsAccepting(int State, int Context) const
+		{
+			const int* Begin = AcceptingContexts.data() + AcceptStarts[State];
+			const int* End = AcceptingContexts.data() + AcceptStarts[State + 1];
+
+			// Almost always empty or a single context.
+			if (Begin == End)
+				return false;
+			if (End - Begin == 1)
+				return *Begin == Context;
+
+			return std::binary_search(Begin, End, Context);
+		}
+
+		// Does entering the given state mean some context has been fully matched?
+		inline bool IsAcceptingAny(int State) const { return AcceptStarts[State] != AcceptStarts[State + 1]; }
+
+		// As IsAccepting, but not while the state's gate still holds it to looping on itself, i.e. a counted loop short of its count.
+		inline bool IsAccepting(int State, int Context, const RegexMatchContext<T>& MatchContext) const
+		{
+			RegexTicker<T>* Gate = GateTickers[State];
+			return (nullptr == Gate || Gate->IsExhausted(MatchContext)) && IsAccepting(State, Context);
+		}
+
+		// Works out which contexts each state accepts, from the exits of both. Must be called once every state and context is in.
+		void BuildAcceptance()
+		{
+			int ExitCount = 0;
+			for (int currExit : Exits)
+				ExitCount = std::max(ExitCount, currExit + 1);
+			for (int currExit : ContextExits)
+				ExitCount = std::max(ExitCount, currExit + 1);
+
+			// Contexts each exit counts towards, laid out the same way as Edges.
+			std::vector<unsigned int> ExitContextStarts(ExitCount + 1, 0);
+			for (int currExit : ContextExits)
+				++ExitContextStarts[currExit + 1];
+			for (int i = 0; i < ExitCount; ++i)
+				ExitContextStarts[i + 1] += ExitContextStarts[i];
+
+			std::vector<int> ExitContexts(ContextExits.size());
+			std::vector<unsigned int> Filled(ExitContextStarts.begin(), ExitContextStarts.end() - 1);
+			for (int currContext = 0; currContext < ContextCount(); ++currContext)
+			{
+				for (unsigned int i = ContextExitStarts[currContext]; i < ContextExitStarts[currContext + 1]; ++i)
+					ExitContexts[Filled[ContextExits[i]]++] = currContext;
+			}
+
+			AcceptStarts = { 0 };
+			AcceptingContexts.clear();
+			for (int currState = 0; currState < StateCount(); ++currState)
+			{
+				const size_t First = AcceptingContexts.size();
+				for (unsigned int i = ExitStarts[currState]; i < ExitStarts[currState + 1]; ++i)
+				{
+					AcceptingContexts.insert(AcceptingContexts.end(),
+						ExitContexts.begin() + ExitContextStarts[Exits[i]],
+						ExitContexts.begin() + ExitContextStarts[Exits[i] + 1]);
+				}
+
+				std::sort(AcceptingContexts.begin() + First, AcceptingContexts.end());
+				AcceptingContexts.erase(std::unique(AcceptingContexts.begin() + First, AcceptingContexts.end()), AcceptingContexts.end());
+				AcceptStarts.push_back(AcceptingContexts.size());
+			}
+		}
+
+		// Bytes held by the table's arrays.
+		size_t MemoryUsage() const
+		{
+			return States.capacity() * sizeof(RegexNode<T>*) +
+				EdgeStarts.capacity() * sizeof(unsigned int) + Edges.capacity() * sizeof(int) +
+				ExitStarts.capacity() * sizeof(unsigned int) + Exits.capacity() * sizeof(int) +
+				(LoopTickers.capacity() + GateTickers.capacity()) * sizeof(RegexTicker<T>*) +
+				Selves.capacity() * sizeof(int) +
+				ContextEntryStarts.capacity() * sizeof(unsigned int) + ContextEntries.capacity() * sizeof(int) +
+				ContextExitStarts.capacity() * sizeof(unsigned int) + ContextExits.capacity() * sizeof(int) +
+				AcceptStarts.capacity() * sizeof(unsigned int) + AcceptingContexts.capacity() * sizeof(int);
+		}
+
+		void Clear()
+		{
+			States.clear();
+			EdgeStarts = { 0 };
+			Edges.clear();
+			ExitStarts = { 0 };
+			Exits.clear();
+			LoopTickers.clear();
+			GateTickers.clear();
+			Selves.clear();
+			ContextEntryStarts = { 0 };
+			ContextEntries.clear();
+			ContextExitStarts = { 0 };
+			ContextExits.clear();
+			AcceptStarts = { 0 };
+			AcceptingContexts.clear();
+		}
+	};
+}
@@ -0,0 +1,487 @@
+#pragma once
+
+#include "Evex.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+namespace Evex
+{
+	// Problems a pattern can be found to have before it's ever compiled.
+	enum class RegexSyntaxError
+	{
+		None,
+		UnclosedCharClass,
+		UnclosedGroup,
+		UnclosedBackreference,
+		UnclosedSubroutine,
+		UnclosedMinMaxRepeat,
+		UnclosedMinRepeat,
+		UnclosedExactRepeat,
+		UnclosedNamedGroup,
+		UnclosedNamedCollection,
+		UnclosedManualCapture,
+		UnclosedCodeHook,
+		UnclosedDefinitionName,
+		UnclosedDefinitionBody,
+		MalformedBackreference,
+		MalformedSubroutine,
+		MalformedDefinition,
+		MalformedConditional,
+		TooManyConditionalBranches,
+		InvalidModifier,
+		LoneEscape,
+		NestingTooDeep
+	};
+
+	struct RegexSyntaxCheck
+	{
+		RegexSyntaxError Error = RegexSyntaxError::None;
+
+		// Offset into the pattern the problem was found at, or -1.
+		int Offset = -1;
+
+		constexpr bool IsValid() const { return RegexSyntaxError::None == Error; }
+	};
+
+	/*
+		Checks of a pattern's syntax that can be made at compile time, mirroring how RegexTranslator reads
+		patterns closely enough that a pattern failing them would also fail to translate.
+		Every group is looked into, special groups included, as are escapes and every form of repeat quantifier.
+		What a character class holds and which groups references point at are left to the translator, so passing
+		doesn't guarantee translation succeeds; e.g. "[z-a]" or a backreference to a group that doesn't exist.
+
+		Keep in sync with RegexTranslator<char>::Translate, which it copies the rules of: CheckRange follows Translate
+		and MunchOp, CheckGroup follows MunchGroup, and CheckConditional the conditional branch of MunchGroup.
+		Example.cpp runs a list of patterns through both and reports any they disagree on.
+	*/
+	class RegexSyntaxChecker
+	{
+	public:
+		static constexpr int DefaultMaxNestingDepth = 100;
+
+		static constexpr RegexSyntaxCheck Check(std::string_view Pattern, int MaxNestingDepth = DefaultMaxNestingDepth)
+		{
+			return CheckRange(Pattern, 0, int(Pattern.size()), MaxNestingDepth);
+		}
+
+		// What Regex::GetCompileError begins with when the translator hits the same error; some add details after it. Matches RegexStaticAssert.
+		static constexpr std::string_view Message(RegexSyntaxError Error)
+		{
+			switch (Error)
+			{
+			case RegexSyntaxError::UnclosedCharClass: return "Regex Compile Error: Couldn't find closing bracket for character class.";
+			case RegexSyntaxError::UnclosedGroup: return "Regex Compile Error: Couldn't find closing bracket for group.";
+			case RegexSyntaxError::UnclosedBackreference: return "Regex Compile Error: Couldn't find closing bracket to backreference.";
+			case RegexSyntaxError::UnclosedSubroutine: return "Regex Compile Error: Couldn't find closing bracket to subroutine.";
+			case RegexSyntaxError::UnclosedMinMaxRepeat: return "Regex Compile Error: Min-Max Repeat quantifier is missing closing bracket.";
+			case RegexSyntaxError::UnclosedMinRepeat: return "Regex Compile Error: Min Repeat quantifier is missing closing bracket.";
+			case RegexSyntaxError::UnclosedExactRepeat: return "Regex Compile Error: Exact repeat quantifier is missing closing bracket.";
+			case RegexSyntaxError::UnclosedNamedGroup: return "Regex Compile Error: Couldn't find closing bracket for Named Capture Group or Subroutine.";
+			case RegexSyntaxError::UnclosedNamedCollection: return "Regex Compile Error: Couldn't find closing bracket for Named Capture Collection Group.";
+			case RegexSyntaxError::UnclosedManualCapture: return "Regex Compile Error: Couldn't find closing bracket for Named Manual Capture.";
+			case RegexSyntaxError::UnclosedCodeHook: return "Regex Compile Error: Couldn't find closing bracket for Code Hook.";
+			case RegexSyntaxError::UnclosedDefinitionName: return "Regex Compile Error: Failed to find closing bracket for subroutine definition name.";
+			case RegexSyntaxError::UnclosedDefinitionBody: return "Regex Compile Error: Failed to find closing bracket for subroutine definition internal regex.";
+			case RegexSyntaxError::MalformedBackreference: return "Regex Compile Error: Malformed backreference.";
+			case RegexSyntaxError::MalformedSubroutine: return "Regex Compile Error: Malformed subroutine.";
+			case RegexSyntaxError::MalformedDefinition: return "Regex Compile Error: Malformed subroutine definition.";
+			case RegexSyntaxError::MalformedConditional: return "Regex Compile Error: Malformed Conditional; Missing closing parenthesis in conditional statement.";
+			case RegexSyntaxError::TooManyConditionalBranches: return "Regex Compile Error: too many branches in conditional.";
+			case RegexSyntaxError::InvalidModifier: return "Regex Compile Error: Group holds a character that is not a valid modifier.";
+			case RegexSyntaxError::LoneEscape: return "Regex Compile Error: Pattern ends in a lone escape.";
+			case RegexSyntaxError::NestingTooDeep: return "Regex Compile Error: Group nesting surpasses the Max Nesting Depth limit.";
+			default: return "";
+			}
+		}
+
+	private:
+		static constexpr bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+		static constexpr bool IsAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+		static constexpr bool IsModifier(char c) { return std::string_view("icsmndla^").find(c) != std::string_view::npos; }
+
+		// The character at Pos, or a null past End. The translator reads the closing bracket there instead, which is just as inert.
+		static constexpr char At(std::string_view Pattern, int Pos, int End) { return Pos < End ? Pattern[Pos] : '\0'; }
+
+		// Offset of the first Glyph from Pos onward, or End if there is none.
+		static constexpr int FindGlyph(std::string_view Pattern, int Pos, int End, char Glyph)
+		{
+			while (Pos < End && Pattern[Pos] != Glyph)
+				++Pos;
+			return Pos;
+		}
+
+		static constexpr char EndGlyphOf(char StartGlyph) { return StartGlyph == '<' ? '>' : (StartGlyph == '\'' ? '\'' : '}'); }
+
+		// As RegexTranslator::MunchBackref and MunchSubroutine, for what lies between a reference's brackets.
+		static constexpr bool IsWellFormedReference(std::string_view Pattern, int Begin, int End, bool AllowRecursion)
+		{
+			const char First = At(Pattern, Begin, End);
+			if (AllowRecursion && First == 'R')
+				return true;
+			if (First == '-' || First == '+')
+				return IsDigit(At(Pattern, Begin + 1, End));
+			return IsDigit(First) || IsAlpha(First);
+		}
+
+		static constexpr RegexSyntaxCheck Fail(RegexSyntaxError Error, int Offset)
+		{
+			RegexSyntaxCheck Out;
+			Out.Error = Error;
+			Out.Offset = Offset;
+			return Out;
+		}
+
+		// As RegexTranslator::FindEnd. Returns the offset of the closing bracket, or End if there is none.
+		static constexpr int FindEnd(std::string_view Pattern, int Pos, int End, char StartBracket, char EndBracket)
+		{
+			int Depth = 0;
+			while (++Pos != End)
+			{
+				if (Pattern[Pos] == StartBracket)
+				{
+					if (Pattern[Pos - 1] != '\\')
+						++Depth;
+				}
+				else if (Pattern[Pos] == EndBracket && Pattern[Pos - 1] != '\\')
+				{
+					if (Depth == 0)
+						break;
+					else
+						--Depth;
+				}
+			}
+			return Pos;
+		}
+
+		static constexpr RegexSyntaxCheck CheckRange(std::string_view Pattern, int Begin, int End, int MaxDepth)
+		{
+			for (int Pos = Begin; Pos < End; ++Pos)
+			{
+				switch (Pattern[Pos])
+				{
+				case '[':
+					{
+						int EndBracket = FindEnd(Pattern, Pos, End, '[', ']');
+						if (EndBracket == End)
+							return Fail(RegexSyntaxError::UnclosedCharClass, Pos);
+						Pos = EndBracket;
+					}
+					break;
+
+				case '(':
+					{
+						int EndBracket = FindEnd(Pattern, Pos, End, '(', ')');
+						if (EndBracket == End)
+							return Fail(RegexSyntaxError::UnclosedGroup, Pos);
+
+						RegexSyntaxCheck Inner = CheckGroup(Pattern, Pos + 1, EndBracket, MaxDepth);
+						if (!Inner.IsValid())
+							return Inner;
+
+						Pos = EndBracket;
+					}
+					break;
+
+				case '\\':
+					{
+						if (++Pos == End)
+							return Fail(RegexSyntaxError::LoneEscape, Pos - 1);
+
+						if (Pattern[Pos] == 'Q')
+						{
+							while (++Pos != End && !(Pattern[Pos] == '\\' && Pos + 1 != End && Pattern[Pos + 1] == 'E'));
+							if (Pos != End)
+								++Pos;
+						}
+						else if ((Pattern[Pos] == 'k' || Pattern[Pos] == 'g') && Pos + 1 != End &&
+							(Pattern[Pos + 1] == '<' || Pattern[Pos + 1] == '\'' || Pattern[Pos + 1] == '{'))
+						{
+							const bool Backref = Pattern[Pos] == 'k';
+							const char EndGlyph = (Pattern[Pos + 1] == '<' ? '>' : (Pattern[Pos + 1] == '\'' ? '\'' : '}'));
+							int Copy = Pos + 1;
+							while (++Copy != End && Pattern[Copy] != EndGlyph);
+
+							if (Copy == End)
+								return Fail(Backref ? RegexSyntaxError::UnclosedBackreference : RegexSyntaxError::UnclosedSubroutine, Pos - 1);
+							if (!IsWellFormedReference(Pattern, Pos + 2, Copy, !Backref))
+								return Fail(Backref ? RegexSyntaxError::MalformedBackreference : RegexSyntaxError::MalformedSubroutine, Pos - 1);
+							Pos = Copy;
+						}
+					}
+					break;
+
+				case '{': // Only a repeat if followed by a digit, and then only "{N}", "{N,}" and "{N,M}" with single digits.
+					if (Pos + 1 != End && IsDigit(Pattern[Pos + 1]))
+					{
+						const int Start = Pos;
+						Pos += 2;
+						if (At(Pattern, Pos, End) == ',')
+						{
+							if (IsDigit(At(Pattern, ++Pos, End)))
+							{
+								if (At(Pattern, ++Pos, End) != '}')
+									return Fail(RegexSyntaxError::UnclosedMinMaxRepeat, Start);
+							}
+							else if (At(Pattern, Pos, End) != '}')
+								return Fail(RegexSyntaxError::UnclosedMinRepeat, Start);
+						}
+						else if (At(Pattern, Pos, End) != '}')
+							return Fail(RegexSyntaxError::UnclosedExactRepeat, Start);
+					}
+					break;
+
+				default:
+					break;
+				}
+			}
+
+			return RegexSyntaxCheck();
+		}
+
+		// As RegexTranslator::MunchGroup, for a group whose contents lie within [Begin, End).
+		static constexpr RegexSyntaxCheck CheckGroup(std::string_view Pattern, int Begin, int End, int MaxDepth)
+		{
+			const int Open = Begin - 1;
+			if (MaxDepth <= 0)
+				return Fail(RegexSyntaxError::NestingTooDeep, Open);
+
+			if (At(Pattern, Begin, End) != '?') // regular group
+				return CheckRange(Pattern, Begin, End, MaxDepth - 1);
+
+			int Pos = Begin + 1;
+			switch (At(Pattern, Pos, End))
+			{
+			case '|': // branch reset group ("(?|(a)|(b))")
+			case '=': // positive lookahead ("(?=regex)")
+			case '!': // negative lookahead ("(?!regex)")
+			case ':': // non-capturing group ("(?:regex)")
+				return CheckRange(Pattern, Pos + 1, End, MaxDepth - 1);
+
+			case '<': // lookbehind ("(?<=regex)", "(?<!regex)"), or as below
+			case '\'': // named capture group ("(?<name>regex)", "(?'name'regex)") or subroutine call ("(?<name>)", "(?'name')")
+				{
+					if (Pattern[Pos] == '<' && (At(Pattern, Pos + 1, End) == '=' || At(Pattern, Pos + 1, End) == '!'))
+						return CheckRange(Pattern, Pos + 2, End, MaxDepth - 1);
+
+					const int NameEnd = FindGlyph(Pattern, Pos + 1, End, EndGlyphOf(Pattern[Pos]));
+					if (NameEnd == End)
+						return Fail(RegexSyntaxError::UnclosedNamedGroup, Open);
+					return CheckRange(Pattern, NameEnd + 1, End, MaxDepth - 1);
+				}
+
+			case '@': // capture collection ("(?@regex)", "(?@<name>regex)", "(?@'name'regex)")
+				if (At(Pattern, Pos + 1, End) == '<' || At(Pattern, Pos + 1, End) == '\'')
+				{
+					const int NameEnd = FindGlyph(Pattern, Pos + 2, End, EndGlyphOf(Pattern[Pos + 1]));
+					if (NameEnd == End)
+						return Fail(RegexSyntaxError::UnclosedNamedCollection, Open);
+					return CheckRange(Pattern, NameEnd + 1, End, MaxDepth - 1);
+				}
+				return CheckRange(Pattern, Pos + 1, End, MaxDepth - 1);
+
+			case '{': // code hook ("(?{funcname})")
+				if (FindGlyph(Pattern, Pos + 1, End, '}') == End)
+					return Fail(RegexSyntaxError::UnclosedCodeHook, Open);
+				return RegexSyntaxCheck();
+
+			case '$': // manual capture ("(?$)", "(?$<name>)", "(?$@'name')", ...)
+				if (At(Pattern, Pos + 1, End) == '@')
+					++Pos;
+				if ((At(Pattern, Pos + 1, End) == '<' || At(Pattern, Pos + 1, End) == '\'') &&
+					FindGlyph(Pattern, Pos + 2, End, EndGlyphOf(Pattern[Pos + 1])) == End)
+					return Fail(RegexSyntaxError::UnclosedManualCapture, Open);
+				return RegexSyntaxCheck();
+
+			case '(': // conditional or subroutine definition
+				return CheckConditional(Pattern, Pos + 1, End, MaxDepth);
+
+			default: // inline modifiers ("(?i)", "(?-i)", "(?i:regex)"), or a subroutine call or recursion ("(?1)", "(?-1)", "(?R)")
+				{
+					const char First = At(Pattern, Pos, End);
+					if ((IsAlpha(First) && First != 'R') || First == '^' || (First == '-' && !IsDigit(At(Pattern, Pos + 1, End))))
+					{
+						if (First == '-')
+							++Pos;
+
+						int Further = Pos;
+						while (Further < End && IsModifier(Pattern[Further]))
+							++Further;
+
+						if (Further == End)
+							return RegexSyntaxCheck();
+						if (Further != Pos && Pattern[Further] == ':')
+							return CheckRange(Pattern, Further + 1, End, MaxDepth - 1);
+						return Fail(RegexSyntaxError::InvalidModifier, Open);
+					}
+
+					if (!IsWellFormedReference(Pattern, Pos, End, true))
+						return Fail(RegexSyntaxError::MalformedSubroutine, Open);
+					return RegexSyntaxCheck();
+				}
+			}
+		}
+
+		// As the conditional half of RegexTranslator::MunchGroup. Cond is the offset just within the condition's bracket.
+		static constexpr RegexSyntaxCheck CheckConditional(std::string_view Pattern, int Cond, int End, int MaxDepth)
+		{
+			const int Open = Cond - 3;
+			const char First = At(Pattern, Cond, End);
+
+			int CondEnd = End;
+			if (First == '<' || First == '\'' || First == '{') // named backref conditional ("(?(<name>)a|b)")
+			{
+				CondEnd = FindGlyph(Pattern, Cond + 1, End, EndGlyphOf(First));
+				if (CondEnd == End)
+					return Fail(RegexSyntaxError::UnclosedNamedCollection, Open);
+				if (!IsWellFormedReference(Pattern, Cond + 1, CondEnd, false))
+					return Fail(RegexSyntaxError::MalformedBackreference, Open);
+				if (At(Pattern, ++CondEnd, End) != ')')
+					return Fail(RegexSyntaxError::MalformedConditional, Open);
+			}
+			else if (First == '-' || First == '+' || IsDigit(First)) // relative, forward or numbered backref conditional ("(?(1)a|b)")
+			{
+				CondEnd = FindGlyph(Pattern, Cond, End, ')');
+				if (CondEnd == End)
+					return Fail(RegexSyntaxError::MalformedConditional, Open);
+				if (!IsWellFormedReference(Pattern, Cond, CondEnd, false))
+					return Fail(RegexSyntaxError::MalformedBackreference, Open);
+			}
+			else // subroutine definition or regular conditional
+			{
+				CondEnd = FindEnd(Pattern, Cond, End, '(', ')');
+				if (CondEnd == End)
+					return Fail(RegexSyntaxError::MalformedConditional, Open);
+
+				if (Pattern.substr(Cond, CondEnd - Cond) == "DEFINE") // subroutine definition ("(?(DEFINE)(?<name>regex))")
+				{
+					const char NameGlyph = At(Pattern, CondEnd + 3, End);
+					if (At(Pattern, CondEnd + 1, End) != '(' || At(Pattern, CondEnd + 2, End) != '?' ||
+						(NameGlyph != '<' && NameGlyph != '\'' && NameGlyph != '{'))
+						return Fail(RegexSyntaxError::MalformedDefinition, Open);
+
+					const int NameEnd = FindGlyph(Pattern, CondEnd + 4, End, EndGlyphOf(NameGlyph));
+					if (NameEnd == End)
+						return Fail(RegexSyntaxError::UnclosedDefinitionName, Open);
+
+					const int BodyEnd = FindEnd(Pattern, NameEnd, End, '(', ')');
+					if (BodyEnd == End)
+						return Fail(RegexSyntaxError::UnclosedDefinitionBody, Open);
+
+					return CheckRange(Pattern, NameEnd + 1, BodyEnd, MaxDepth - 1);
+				}
+
+				// The condition is read as a group of its own, a non-capturing one unless it says otherwise.
+				RegexSyntaxCheck Condition = CheckGroup(Pattern, Cond, CondEnd, MaxDepth - 1);
+				if (!Condition.IsValid())
+					return Condition;
+			}
+
+			// As the translator splits branches, brackets aside, only a second non-empty branch may follow a '|'.
+			bool PrevFilled = false, CurrFilled = false;
+			int Depth = 0;
+			for (int Pos = CondEnd + 1; Pos < End; ++Pos)
+			{
+				if (Pattern[Pos] == '|' && Depth == 0)
+				{
+					if (PrevFilled)
+						return Fail(RegexSyntaxError::TooManyConditionalBranches, Pos);
+					PrevFilled = CurrFilled;
+					CurrFilled = false;
+				}
+				else if (Pattern[Pos] == '(')
+					++Depth;
+				else if (Pattern[Pos] == ')')
+					--Depth;
+				else
+					CurrFilled = true;
+			}
+
+			return CheckRange(Pattern, CondEnd + 1, End, MaxDepth - 1);
+		}
+	};
+
+	// Fails the build with the translator's own message for whichever error a pattern was found to have.
+	template<RegexSyntaxError Error>
+	struct RegexStaticAssert
+	{
+		static_assert(Error != RegexSyntaxError::UnclosedCharClass, "Regex Compile Error: Couldn't find closing bracket for character class.");
+		static_assert(Error != RegexSyntaxError::UnclosedGroup, "Regex Compile Error: Couldn't find closing bracket for group.");
+		static_assert(Error != RegexSyntaxError::UnclosedBackreference, "Regex Compile Error: Couldn't find closing bracket to backreference.");
+		static_assert(Error != RegexSyntaxError::UnclosedSubroutine, "Regex Compile Error: Couldn't find closing bracket to subroutine.");
+		static_assert(Error != RegexSyntaxError::UnclosedMinMaxRepeat, "Regex Compile Error: Min-Max Repeat quantifier is missing closing bracket.");
+		static_assert(Error != RegexSyntaxError::UnclosedMinRepeat, "Regex Compile Error: Min Repeat quantifier is missing closing bracket.");
+		static_assert(Error != RegexSyntaxError::UnclosedExactRepeat, "Regex Compile Error: Exact repeat quantifier is missing closing bracket.");
+		static_assert(Error != RegexSyntaxError::UnclosedNamedGroup, "Regex Compile Error: Couldn't find closing bracket for Named Capture Group or Subroutine.");
+		static_assert(Error != RegexSyntaxError::UnclosedNamedCollection, "Regex Compile Error: Couldn't find closing bracket for Named Capture Collection Group.");
+		static_assert(Error != RegexSyntaxError::UnclosedManualCapture, "Regex Compile Error: Couldn't find closing bracket for Named Manual Capture.");
+		static_assert(Error != RegexSyntaxError::UnclosedCodeHook, "Regex Compile Error: Couldn't find closing bracket for Code Hook.");
+		static_assert(Error != RegexSyntaxError::UnclosedDefinitionName, "Regex Compile Error: Failed to find closing bracket for subroutine definition name.");
+		static_assert(Error != RegexSyntaxError::UnclosedDefinitionBody, "Regex Compile Error: Failed to find closing bracket for subroutine definition internal regex.");
+		static_assert(Error != RegexSyntaxError::MalformedBackreference, "Regex Compile Error: Malformed backreference.");
+		static_assert(Error != RegexSyntaxError::MalformedSubroutine, "Regex Compile Error: Malformed subroutine.");
+		static_assert(Error != RegexSyntaxError::MalformedDefinition, "Regex Compile Error: Malformed subroutine definition.");
+		static_assert(Error != RegexSyntaxError::MalformedConditional, "Regex Compile Error: Malformed Conditional; Missing closing parenthesis in conditional statement.");
+		static_assert(Error != RegexSyntaxError::TooManyConditionalBranches, "Regex Compile Error: too many branches in conditional.");
+		static_assert(Error != RegexSyntaxError::InvalidModifier, "Regex Compile Error: Group holds a character that is not a valid modifier.");
+		static_assert(Error != RegexSyntaxError::LoneEscape, "Regex Compile Error: Pattern ends in a lone escape.");
+		static_assert(Error != RegexSyntaxError::NestingTooDeep, "Regex Compile Error: Group nesting surpasses the Max Nesting Depth limit.");
+
+		static constexpr bool Value = true;
+	};
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+	// String literal usable as a template argument, i.e. StaticRegex<"...">.
+	template<size_t N>
+	struct RegexPatternLiteral
+	{
+		char Chars[N] = {};
+
+		constexpr RegexPatternLiteral(const char (&inChars)[N])
+		{
+			for (size_t i = 0; i < N; ++i)
+				Chars[i] = inChars[i];
+		}
+
+		constexpr std::string_view View() const { return std::string_view(Chars, N - 1); }
+	};
+
+	/*
+		A regex given as a string literal, whose syntax is checked as the program is built.
+		It's compiled once per process the first time it's used, and shared from then on.
+		Matching through the default context isn't thread-safe, as with any Regex; give each thread its own context.
+	*/
+	template<RegexPatternLiteral Pattern>
+	class StaticRegex
+	{
+		static_assert(RegexStaticAssert<RegexSyntaxChecker::Check(Pattern.View()).Error>::Value);
+
+	public:
+		static Regex<char>& Get()
+		{
+			static Regex<char> Compiled{ std::string(Pattern.View()) };
+			return Compiled;
+		}
+
+		static inline bool Match(std::string_view String) { return Get().Match(String); }
+		static inline bool Match(RegexMatchContext<char>& MatchContext, std::string_view String) { return Get().Match(MatchContext, String); }
+
+		static inline bool MatchAll(std::string_view String, RegexMatchResults<char>& OutResults) { return Get().MatchAll(String, OutResults); }
+		static inline bool MatchAll(RegexMatchContext<char>& MatchContext, std::string_view String, RegexMatchResults<char>& OutResults) { return Get().MatchAll(MatchContext, String, OutResults); }
+	};
+#endif
+}
+
+/*
+	C++17 counterpart of Evex::StaticRegex. Checks the given string literal's syntax as the program is built,
+	and evaluates to a Regex<char>& compiled once per process, the first time the expression is reached.
+*/
+#define EVEX_STATIC_REGEX(Pattern) \
+	([]() -> ::Evex::Regex<char>& \
+	{ \
+		static_assert(::Evex::RegexStaticAssert<::Evex::RegexSyntaxChecker::Check(Pattern).Error>::Value, ""); \
+		static ::Evex::Regex<char> EvexCompiled{ std::string(Pattern) }; \
+		return EvexCompiled; \
+	}())
@@ -0,0 +1,280 @@
+#pragma once
+
+#include "Evex.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+
+namespace Evex
+{
+	/*
+		A match found by a RegexStreamScanner, with offsets counted from the very start of the stream.
+		Views point into what the scanner has kept of the stream, so only last until the callback returns.
+	*/
+	template<typename T>
+	class RegexStreamMatch
+	{
+	public:
+		using StringViewType = typename RegexMatchResult<T>::StringViewType;
+
+		RegexStreamMatch(unsigned long long inBase, const RegexMatchResult<T>& inResult) : Base(inBase), Result(inResult) {}
+
+		// Number of groups, including the whole match as group 0.
+		inline int GetGroupCount() const { return Result.GetGroupCount(); }
+
+		// Did the given group take part in the match?
+		inline bool HasGroup(int Group) const { return Result.HasGroup(Group); }
+		inline bool HasGroup(const std::basic_string<T>& Name) const { return Result.HasGroup(Name); }
+
+		// Offsets into the stream. Both are -1 if the group didn't take part in the match.
+		inline long long Begin(int Group = 0) const { return (HasGroup(Group) ? (long long)(Base + Result.Begin(Group)) : -1); }
+		inline long long End(int Group = 0) const { return (HasGroup(Group) ? (long long)(Base + Result.End(Group)) : -1); }
+		inline long long Length(int Group = 0) const { return End(Group) - Begin(Group); }
+
+		inline StringViewType View(int Group = 0) const { return Result.View(Group); }
+		inline StringViewType View(const std::basic_string<T>& Name) const { return Result.View(Name); }
+
+		inline int GroupIndex(const std::basic_string<T>& Name) const { return Result.GroupIndex(Name); }
+
+	private:
+		// Stream offset of the start of the scanner's history when the match was found.
+		unsigned long long Base = 0;
+		RegexMatchResult<T> Result;
+	};
+
+	/*
+		Finds every match in a stream given to it a piece at a time, exactly as MatchAll would over the
+		whole stream at once, without ever holding the whole stream.
+
+		Regexes made only of plain nodes carry their walks from one piece to the next, and keep nothing
+		from before the start of the oldest walk still in flight.
+		Anything else is rescanned from wherever its last settled attempt left off. An attempt that looks
+		within Lookaround characters of the newest input waits for more before it's settled, and as much
+		is kept from before where the next attempt starts, for lookbehinds, "\\b" and the like. Lookarounds
+		and backreferences reaching further than that may see the stream as starting or ending early.
+
+		Either way, a match that's still growing (e.g. one ending in ".*") keeps everything since its start.
+	*/
+	template<typename T>
+	class RegexStreamScanner
+	{
+	public:
+		using CallbackType = std::function<void(const RegexStreamMatch<T>&)>;
+
+		static const size_t DefaultLookaround = 4096;
+
+		// Throws a RegexCompileException if the given regex failed to compile. The regex must outlive the scanner.
+		RegexStreamScanner(const Regex<T>& inAutomaton, CallbackType inOnMatch, size_t inLookaround = DefaultLookaround)
+			: Automaton(inAutomaton), OnMatch(inOnMatch), Lookaround(inLookaround)
+		{
+			if (!Automaton.IsValidForMatching())
+				throw RegexCompileException(Automaton.GetCompileError());
+
+			Automaton.PrepareContext(MatchContext);
+			Reset();
+		}
+
+		// Scans the next piece of the stream, reporting every match it settles.
+		void Feed(const T* Data, size_t Length)
+		{
+			if (Finished)
+			{
+				RuntimeErrors.clear();
+				Finished = false;
+			}
+
+			History.append(Data, Length);
+			Scan(false);
+		}
+
+		inline void Feed(std::basic_string_view<T> Data) { Feed(Data.data(), Data.size()); }
+
+		// Ends the stream, reporting every match left in it. Feeding the scanner afterward starts a new stream.
+		void Finish()
+		{
+			Scan(true);
+			Finished = true;
+		}
+
+		// Amount of the current stream fed so far.
+		inline unsigned long long GetStreamLength() const { return HistoryBase + History.size(); }
+
+		// Amount of the current stream still kept.
+		inline size_t GetHistoryLength() const { return History.size(); }
+
+		// Runtime errors met since the stream began.
+		inline const std::vector<std::string>& GetRuntimeErrors() const { return RuntimeErrors; }
+
+	private:
+		const Regex<T>& Automaton;
+		CallbackType OnMatch;
+		size_t Lookaround;
+
+		RegexMatchContext<T> MatchContext;
+
+		// Matches found in the latest scan, waiting to be reported.
+		RegexMatchResults<T> Pending;
+
+		// What's kept of the stream, and the stream offset of its first character.
+		std::basic_string<T> History;
+		unsigned long long HistoryBase = 0;
+
+		/*
+			Offsets into History. NextStart is the next offset to scan from, MinStart the offset before which
+			no walk may start, being covered by an earlier match, and LastEnd the end of the last match, or -1.
+		*/
+		ptrdiff_t NextStart = 0;
+		ptrdiff_t MinStart = 0;
+		ptrdiff_t LastEnd = -1;
+
+		std::vector<std::string> RuntimeErrors;
+		bool Finished = false;
+
+		void Scan(bool Final)
+		{
+			Automaton.BeginResults(Pending, History.data());
+
+			if (Automaton.AllFrontiersPlain)
+				ScanWalks(Final);
+			else
+				ScanAttempts(Final);
+
+			for (size_t i = 0; i < Pending.size(); ++i)
+				OnMatch(RegexStreamMatch<T>(HistoryBase, Pending[i]));
+			Pending.clear();
+
+			if (Final)
+				Reset();
+			else
+				Trim();
+		}
+
+		/*
+			Characters at the end of the history not yet scanned from, as the prefilter's literal doesn't fit
+			after them, and so can't yet tell whether a match could start there.
+		*/
+		inline ptrdiff_t HeldBack() const { return std::max<ptrdiff_t>(Automaton.Prefilter.Literal.size() - 1, 0); }
+
+		// Advances the walks carried over from earlier pieces, as MatchAllUnanchored does.
+		void ScanWalks(bool Final)
+		{
+			const T* Begin = History.data();
+			const T* End = Begin + History.size();
+			const ptrdiff_t Length = ptrdiff_t(History.size());
+
+			// The end of the stream is a position of its own, where every walk still in flight finishes.
+			const ptrdiff_t Limit = (Final ? Length + 1 : Length - HeldBack());
+
+			ptrdiff_t currPos = NextStart;
+			for (; currPos < Limit; ++currPos)
+			{
+				if (MatchContext.Walks.empty())
+				{
+					currPos = Automaton.Prefilter.NextCandidate(Begin, Length, currPos);
+					if (currPos < 0 || currPos >= Limit)
+						break;
+				}
+
+				Automaton.StepWalks(Begin, End, currPos, currPos < Length, MinStart, LastEnd, Pending, MatchContext);
+			}
+
+			NextStart = std::max(NextStart, Limit);
+		}
+
+		// Tries each offset in turn, as MatchAllRange does, stopping at the first attempt more input could change.
+		void ScanAttempts(bool Final)
+		{
+			const T* Begin = History.data();
+			const T* End = Begin + History.size();
+			const ptrdiff_t Length = ptrdiff_t(History.size());
+
+			ptrdiff_t Pos = NextStart;
+			while (true)
+			{
+				ptrdiff_t Candidate = Automaton.Prefilter.NextCandidate(Begin, Length, Pos);
+				if (Candidate < 0)
+				{
+					if (!Final)
+						Pos = std::max(Pos, Length - HeldBack());
+					break;
+				}
+
+				Pos = Candidate;
+
+				MatchContext.LastMatchEnd = (LastEnd > 0 ? RegexRangeIterator<T>(Begin + LastEnd - 1, Begin, End) : RegexRangeIterator<T>());
+				MatchContext.RuntimeErrors.clear();
+
+				ptrdiff_t MatchEnd = -1, LastRead = -1;
+				bool Matched = Automaton.AttemptAt(Begin, End, Pos, MatchEnd, LastRead, MatchContext);
+
+				if (!Final && (long long)LastRead + (long long)Lookaround >= Length)
+					break;
+
+				RuntimeErrors.insert(RuntimeErrors.end(), MatchContext.RuntimeErrors.begin(), MatchContext.RuntimeErrors.end());
+
+				if (Matched)
+				{
+					Automaton.RecordMatch(Pending, Begin, End, Pos, MatchEnd, MatchContext);
+
+					// An empty match leaves the next attempt to start one further on.
+					Pos = (MatchEnd > Pos ? MatchEnd : Pos + 1);
+					LastEnd = MatchEnd;
+				}
+				else
+					++Pos;
+			}
+
+			NextStart = Pos;
+		}
+
+		// Drops whatever of the history can no longer matter, once it's at least as much as would be kept.
+		void Trim()
+		{
+			ptrdiff_t Keep = NextStart;
+			if (Automaton.AllFrontiersPlain)
+			{
+				if (!MatchContext.Walks.empty())
+					Keep = MatchContext.Walks.front().Start;
+			}
+			else
+				Keep = std::max<ptrdiff_t>(0, NextStart - ptrdiff_t(Lookaround));
+
+			if (Keep <= 0 || size_t(Keep) * 2 < History.size())
+				return;
+
+			History.erase(0, size_t(Keep));
+			HistoryBase += Keep;
+
+			NextStart -= Keep;
+			MinStart -= Keep;
+			LastEnd = std::max<ptrdiff_t>(LastEnd - Keep, -1);
+
+			for (RegexSearchWalk& currWalk : MatchContext.Walks)
+			{
+				currWalk.Start -= Keep;
+				currWalk.End -= Keep;
+			}
+
+			// Stamps are offsets too, and only ever compared against the offset being scanned.
+			std::fill(MatchContext.StateStamps.begin(), MatchContext.StateStamps.end(), -1);
+		}
+
+		void Reset()
+		{
+			History.clear();
+			HistoryBase = 0;
+
+			NextStart = MinStart = 0;
+			LastEnd = -1;
+
+			MatchContext.Walks.clear();
+			std::fill(MatchContext.StateStamps.begin(), MatchContext.StateStamps.end(), -1);
+			MatchContext.LastMatchEnd = RegexRangeIterator<T>();
+			Automaton.ResetPreMatch(MatchContext);
+		}
+	};
+}
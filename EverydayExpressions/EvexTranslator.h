@@ -1,54 +1,58 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
+#include <string_view>
+#include <initializer_list>
+#include <cstdint>
 
 namespace Evex
 {
 	enum class RegexInstructionType : uint8_t
 	{
-		MakeCapture, // std::string manual, std::string[] names (if empty then will just be reffed by index)
-		MakeCaptureCollection, // std::string manual, std::string[] names (if empty then will just be reffed by index)
+		MakeCapture, // bool manual, name[] names (if empty then will just be reffed by index)
+		MakeCaptureCollection, // bool manual, name[] names (if empty then will just be reffed by index)
 	
-		MakeCharClassSymbol, // std::string minChar, std::string maxChar
-		MakeCharClassLigatureSymbol, // std::string[] charsInvolved
+		MakeCharClassSymbol, // char minChar, char maxChar
+		MakeCharClassLigatureSymbol, // char[] charsInvolved
 	
-		MakeLiteralCharClass, // std::string negated, std::string caseinsensitive, std::string[] inds
+		MakeLiteralCharClass, // bool negated, bool caseinsensitive, int[] inds
 	
-		MakeUnitedCharClass, // std::string lhsInd, std::string rhsInd
-		MakeSubtractedCharClass, // std::string lhsInd, std::string rhsInd
-		MakeIntersectedCharClass, // std::string lhsInd, std::string rhsInd
+		MakeUnitedCharClass, // int lhsInd, int rhsInd
+		MakeSubtractedCharClass, // int lhsInd, int rhsInd
+		MakeIntersectedCharClass, // int lhsInd, int rhsInd
 	
-		Literal, // std::string[] characterclassindices
+		Literal, // int[] characterclassindices
 	
-		StartCheck, // std::string IsExclusive, std::string IsLastMatchEnd, std::string LineCharsInd
-		EndCheck, // std::string IsExclusive, std::string BeforeLastNewline, std::string LineCharsInd
+		StartCheck, // bool IsExclusive, bool IsLastMatchEnd, int LineCharsInd
+		EndCheck, // bool IsExclusive, bool BeforeLastNewline, int LineCharsInd
 	
-		WordBoundary, // std::string negated, std::string WordCharsInd
+		WordBoundary, // bool negated, int WordCharsInd
 	
-		Backref_Numbered, // std::string capturenumber
-		Backref_Named, // std::string capturename
+		Backref_Numbered, // int capturenumber
+		Backref_Named, // name capturename
 	
-		Subroutine_Numbered, // std::string capturenumber, std::string maxdepth
-		Subroutine_Named, // std::string capturename, std::string maxdepth
+		Subroutine_Numbered, // int capturenumber, int maxdepth
+		Subroutine_Named, // name capturename, int maxdepth
 	
-		Recursion, // std::string maxdepth, std::string Lazy
+		Recursion, // int maxdepth, bool Lazy
 	
-		CaptureGroup_Numbered, // std::string index, std::string Lazy. Pop one off stack, make group, put back in.
-		CaptureGroup_Named, // std::string name, std::string Lazy. Pop one off stack, make group, put back in.
+		CaptureGroup_Numbered, // int index, bool Lazy. Pop one off stack, make group, put back in.
+		CaptureGroup_Named, // name name, bool Lazy. Pop one off stack, make group, put back in.
 	
-		NonCaptureGroup, // std::string Lazy. Pop one off stack, make group, put back in.
+		NonCaptureGroup, // bool Lazy. Pop one off stack, make group, put back in.
 	
-		LookAhead, // std::string negated, std::string lazy. pop one off stack, make lookahead, put back in.
-		LookBehind, // std::string negated, std::string lazy. pop one off stack, make lookbehind, put back in.
+		LookAhead, // bool negated, bool lazy. pop one off stack, make lookahead, put back in.
+		LookBehind, // bool negated, bool lazy. pop one off stack, make lookbehind, put back in.
 	
-		DefineAsSubroutine, // std::string name. pops one off the stack, and that's it. i.e. makes a chunk only accessible via subroutine call.
+		DefineAsSubroutine, // name name. pops one off the stack, and that's it. i.e. makes a chunk only accessible via subroutine call.
 	
-		CodeHook, // std::string funcname
+		CodeHook, // name funcname
 	
-		Conditional, // std::string NumConds, std::string Lazy. pop NumConds + 1, i.e. 2 or 3, off the top, create a conditional with them, place back in
+		Conditional, // int NumConds, bool Lazy. pop NumConds + 1, i.e. 2 or 3, off the top, create a conditional with them, place back in
 	
 		NOnce, // pop one off stack, make none-or-once, put back in
 		NOnceLazy,
@@ -56,7 +60,7 @@ namespace Evex
 		NPlusLazy,
 		OPlus, // pop one off stack, make one-plus, put back in
 		OPlusLazy,
-		Repeat, // std::string type, std::string mintimes, std::string maxtimes. pop one off stack, make the respective repeat, put back in
+		Repeat, // int type (RegexRepeatType), int mintimes, int maxtimes. pop one off stack, make the respective repeat, put back in
 		RepeatLazy,
 	
 		Concat, // pop two off the top, concat them together, place back in.
@@ -66,13 +70,365 @@ namespace Evex
 		MAX
 	};
 	
+	// Which of its forms a Repeat instruction takes, i.e. "{N}", "{N,}" or "{N,M}".
+	enum class RegexRepeatType : uint8_t
+	{
+		Exact,
+		Min,
+		MinMax
+	};
+	
+	enum class RegexOperandKind : uint8_t
+	{
+		Int,
+		Bool,
+		Char,
+		Name,
+	
+		MAX
+	};
+	
+	/*
+		What an instruction takes, for checking programs the translator didn't make before they're assembled.
+		Operands are the fixed kinds in order, followed by at least MinTrailing of the trailing kind when there is one.
+		Pops and Pushes are the chunks taken off and put onto the assembler's stack; a Conditional pops one more than its condition count instead.
+	*/
+	struct RegexInstructionShape
+	{
+		RegexOperandKind Fixed[3];
+		uint32_t FixedCount;
+		RegexOperandKind Trailing;
+		uint32_t MinTrailing;
+		uint32_t Pops, Pushes;
+	
+		static RegexInstructionShape Of(RegexInstructionType Type)
+		{
+			const RegexOperandKind I = RegexOperandKind::Int, B = RegexOperandKind::Bool, C = RegexOperandKind::Char,
+				N = RegexOperandKind::Name, None = RegexOperandKind::MAX;
+	
+			switch (Type)
+			{
+			case RegexInstructionType::MakeCapture:
+			case RegexInstructionType::MakeCaptureCollection:
+				return { { B }, 1, N, 0, 0, 0 };
+	
+			case RegexInstructionType::MakeCharClassSymbol:
+				return { { C, C }, 2, None, 0, 0, 0 };
+			case RegexInstructionType::MakeCharClassLigatureSymbol:
+				return { {}, 0, C, 1, 0, 0 };
+	
+			case RegexInstructionType::MakeLiteralCharClass:
+				return { { B, B }, 2, I, 0, 0, 0 };
+	
+			case RegexInstructionType::MakeUnitedCharClass:
+			case RegexInstructionType::MakeSubtractedCharClass:
+			case RegexInstructionType::MakeIntersectedCharClass:
+				return { { I, I }, 2, None, 0, 0, 0 };
+	
+			case RegexInstructionType::Literal:
+				return { {}, 0, I, 1, 0, 1 };
+	
+			case RegexInstructionType::StartCheck:
+			case RegexInstructionType::EndCheck:
+				return { { B, B, I }, 3, None, 0, 0, 1 };
+	
+			case RegexInstructionType::WordBoundary:
+				return { { B, I }, 2, None, 0, 0, 1 };
+	
+			case RegexInstructionType::Backref_Numbered:
+				return { { I }, 1, None, 0, 0, 1 };
+			case RegexInstructionType::Backref_Named:
+				return { { N }, 1, None, 0, 0, 1 };
+	
+			case RegexInstructionType::Subroutine_Numbered:
+				return { { I, I }, 2, None, 0, 0, 1 };
+			case RegexInstructionType::Subroutine_Named:
+				return { { N, I }, 2, None, 0, 0, 1 };
+	
+			case RegexInstructionType::Recursion:
+				return { { I, B }, 2, None, 0, 0, 1 };
+	
+			case RegexInstructionType::CaptureGroup_Numbered:
+				return { { I, B }, 2, None, 0, 1, 1 };
+			case RegexInstructionType::CaptureGroup_Named:
+				return { { N, B }, 2, None, 0, 1, 1 };
+	
+			case RegexInstructionType::NonCaptureGroup:
+				return { { B }, 1, None, 0, 1, 1 };
+	
+			case RegexInstructionType::LookAhead:
+			case RegexInstructionType::LookBehind:
+				return { { B, B }, 2, None, 0, 1, 1 };
+	
+			case RegexInstructionType::DefineAsSubroutine:
+				return { { N }, 1, None, 0, 1, 0 };
+	
+			case RegexInstructionType::CodeHook:
+				return { { N }, 1, None, 0, 0, 1 };
+	
+			case RegexInstructionType::Conditional:
+				return { { I, B }, 2, None, 0, 0, 1 };
+	
+			case RegexInstructionType::Repeat:
+			case RegexInstructionType::RepeatLazy:
+				return { { I, I, I }, 3, None, 0, 1, 1 };
+	
+			case RegexInstructionType::Concat:
+			case RegexInstructionType::Alternate:
+				return { {}, 0, None, 0, 2, 1 };
+	
+			default: // quantifiers without operands
+				return { {}, 0, None, 0, 1, 1 };
+			}
+		}
+	};
+	
+	// Where a name operand's characters sit in its program's name pool.
+	struct RegexNameSpan
+	{
+		uint32_t Offset, Length;
+	};
+	
+	// A single instruction operand, i.e. an index, count, flag, character, or name.
 	template<typename T>
+	struct RegexOperand
+	{
+		RegexOperandKind Kind;
+		union
+		{
+			int Int;
+			bool Bool;
+			T Char;
+			RegexNameSpan Name;
+		};
+	
+		RegexOperand() : Kind(RegexOperandKind::Int), Int(0) {}
+		RegexOperand(int inInt) : Kind(RegexOperandKind::Int), Int(inInt) {}
+		RegexOperand(bool inBool) : Kind(RegexOperandKind::Bool), Bool(inBool) {}
+		RegexOperand(T inChar) : Kind(RegexOperandKind::Char), Char(inChar) {}
+		RegexOperand(RegexNameSpan inName) : Kind(RegexOperandKind::Name), Name(inName) {}
+	};
+	
+	// An instruction, and where its operands sit in its program's operand list.
 	struct RegexInstruction
 	{
 		RegexInstructionType InstructionType;
-		std::vector<std::basic_string<T>> InstructionData;
+		uint32_t OperandBegin, OperandCount;
 	};
 	
+	/*
+		A postfix instruction list, as the translator makes it and the assembler follows it.
+	
+		Operands of every instruction are kept in one list, and the characters of every name in one string,
+		so a program costs a handful of allocations however many instructions it holds.
+	*/
+	template<typename T>
+	struct RegexProgram
+	{
+		std::vector<RegexInstruction> Instructions;
+		std::vector<RegexOperand<T>> Operands;
+		std::basic_string<T> NamePool;
+	
+		inline size_t size() const { return Instructions.size(); }
+		inline bool empty() const { return Instructions.empty(); }
+	
+		inline RegexInstruction& back() { return Instructions.back(); }
+		inline const RegexInstruction& back() const { return Instructions.back(); }
+	
+		inline RegexInstruction& operator[](size_t Index) { return Instructions[Index]; }
+		inline const RegexInstruction& operator[](size_t Index) const { return Instructions[Index]; }
+	
+		void clear()
+		{
+			Instructions.clear();
+			Operands.clear();
+			NamePool.clear();
+		}
+	
+		// Adds an instruction with the given operands.
+		void Add(RegexInstructionType Type, std::initializer_list<RegexOperand<T>> inOperands = {})
+		{
+			Instructions.push_back({ Type, uint32_t(Operands.size()), uint32_t(inOperands.size()) });
+			Operands.insert(Operands.end(), inOperands.begin(), inOperands.end());
+		}
+	
+		// Adds an operand to the last instruction added.
+		void AddOperand(RegexOperand<T> Operand)
+		{
+			Operands.push_back(Operand);
+			++Instructions.back().OperandCount;
+		}
+	
+		// Pools the given name, returning the operand referring to it.
+		RegexOperand<T> Name(std::basic_string_view<T> inName)
+		{
+			RegexNameSpan Out{ uint32_t(NamePool.size()), uint32_t(inName.size()) };
+			NamePool.append(inName.data(), inName.size());
+			return Out;
+		}
+	
+		// Appends the instructions of another program, moving its operands and names over.
+		void Append(const RegexProgram& Other)
+		{
+			const uint32_t OperandBase = uint32_t(Operands.size());
+			const uint32_t NameBase = uint32_t(NamePool.size());
+	
+			Instructions.reserve(Instructions.size() + Other.Instructions.size());
+			for (const RegexInstruction& currInstruction : Other.Instructions)
+				Instructions.push_back({ currInstruction.InstructionType, currInstruction.OperandBegin + OperandBase, currInstruction.OperandCount });
+	
+			Operands.insert(Operands.end(), Other.Operands.begin(), Other.Operands.end());
+			for (size_t i = OperandBase; i < Operands.size(); ++i)
+			{
+				if (Operands[i].Kind == RegexOperandKind::Name)
+					Operands[i].Name.Offset += NameBase;
+			}
+	
+			NamePool += Other.NamePool;
+		}
+	
+		inline const RegexOperand<T>* GetOperands(const RegexInstruction& Instruction) const { return Operands.data() + Instruction.OperandBegin; }
+	
+		inline std::basic_string_view<T> GetName(const RegexOperand<T>& Operand) const
+		{
+			return std::basic_string_view<T>(NamePool.data() + Operand.Name.Offset, Operand.Name.Length);
+		}
+	
+		/*
+			Checks the program can be assembled as is: every operand and name lies within its list, every instruction
+			has the operands its RegexInstructionShape gives, refers only to character classes and symbols made before it,
+			and never takes more chunks than are on the stack, leaving exactly one at the end.
+			The assembler checks this before following any program, giving why it failed in OutError.
+		*/
+		bool IsWellFormed(std::string& OutError) const
+		{
+			for (const RegexOperand<T>& currOperand : Operands)
+			{
+				if (currOperand.Kind >= RegexOperandKind::MAX ||
+					(currOperand.Kind == RegexOperandKind::Name &&
+					(currOperand.Name.Offset > NamePool.size() || currOperand.Name.Length > NamePool.size() - currOperand.Name.Offset)))
+				{
+					OutError = "Regex Compile Error: Instructions given are malformed; an operand is of no known kind or names past the end of the name pool.";
+					return false;
+				}
+			}
+	
+			int Symbols = 0, Classes = 0;
+			size_t Chunks = 0;
+	
+			for (size_t i = 0; i < Instructions.size(); ++i)
+			{
+				const RegexInstruction& currInstruction = Instructions[i];
+				const char* Problem = nullptr;
+	
+				if (currInstruction.InstructionType >= RegexInstructionType::MAX)
+					Problem = " is of no known type.";
+				else if (currInstruction.OperandBegin > Operands.size() ||
+					currInstruction.OperandCount > Operands.size() - currInstruction.OperandBegin)
+					Problem = " has operands past the end of the operand list.";
+	
+				if (!Problem)
+				{
+					const RegexInstructionShape Shape = RegexInstructionShape::Of(currInstruction.InstructionType);
+					const RegexOperand<T>* Data = GetOperands(currInstruction);
+					const uint32_t DataCount = currInstruction.OperandCount;
+	
+					bool Fits = DataCount >= Shape.FixedCount + Shape.MinTrailing &&
+						(Shape.Trailing != RegexOperandKind::MAX || DataCount == Shape.FixedCount);
+					for (uint32_t j = 0; Fits && j < DataCount; ++j)
+						Fits = Data[j].Kind == (j < Shape.FixedCount ? Shape.Fixed[j] : Shape.Trailing);
+	
+					// Which operands are indices, and how many of what they index have been made so far.
+					uint32_t IndexBegin = 0, IndexEnd = 0;
+					int IndexLimit = Classes;
+					size_t Pops = Shape.Pops;
+	
+					if (Fits)
+					{
+						switch (currInstruction.InstructionType)
+						{
+						case RegexInstructionType::MakeCharClassSymbol:
+						case RegexInstructionType::MakeCharClassLigatureSymbol:
+							++Symbols;
+							break;
+	
+						case RegexInstructionType::MakeLiteralCharClass:
+							IndexBegin = 2;
+							IndexEnd = DataCount;
+							IndexLimit = Symbols;
+							++Classes;
+							break;
+	
+						case RegexInstructionType::MakeUnitedCharClass:
+						case RegexInstructionType::MakeSubtractedCharClass:
+						case RegexInstructionType::MakeIntersectedCharClass:
+							IndexEnd = 2;
+							++Classes;
+							break;
+	
+						case RegexInstructionType::Literal:
+							IndexEnd = DataCount;
+							break;
+	
+						case RegexInstructionType::StartCheck:
+						case RegexInstructionType::EndCheck:
+							IndexBegin = 2;
+							IndexEnd = 3;
+							break;
+	
+						case RegexInstructionType::WordBoundary:
+							IndexBegin = 1;
+							IndexEnd = 2;
+							break;
+	
+						case RegexInstructionType::Conditional:
+							Fits = Data[0].Int == 1 || Data[0].Int == 2;
+							Pops = size_t(Data[0].Int) + 1;
+							break;
+	
+						default:
+							break;
+						}
+					}
+	
+					if (!Fits)
+						Problem = " doesn't have the operands its type takes.";
+	
+					for (uint32_t j = IndexBegin; !Problem && j < IndexEnd; ++j)
+					{
+						if (Data[j].Int < 0 || Data[j].Int >= IndexLimit)
+							Problem = " refers to a character class or symbol not made before it.";
+					}
+	
+					if (!Problem && Chunks < Pops)
+						Problem = " takes more chunks than the instructions before it leave.";
+					else if (!Problem)
+						Chunks = Chunks - Pops + Shape.Pushes;
+				}
+	
+				if (Problem)
+				{
+					OutError = "Regex Compile Error: Instruction " + std::to_string(i) + Problem;
+					return false;
+				}
+			}
+	
+			if (Chunks != 1)
+			{
+				OutError = Chunks == 0 ? "Regex Compile Error: No nodes constructed from given regex." :
+					"Regex Compile Error: Instructions given leave more than one chunk unjoined.";
+				return false;
+			}
+	
+			return true;
+		}
+	
+		inline bool IsWellFormed() const
+		{
+			std::string Discarded;
+			return IsWellFormed(Discarded);
+		}
+	};
 	
 	/*
 		Translates a given infix regex into a postfix set of instructions.
@@ -84,7 +440,7 @@ namespace Evex
 	{
 	public:
 		template<typename ContainerType, typename IterType>
-		static std::vector<RegexInstruction<T>> Translate(ContainerType& Infix, IterType& iter, std::string& error)
+		static RegexProgram<T> Translate(ContainerType& Infix, IterType& iter, std::string& error)
 		{
 			static_assert(false, "RegexTranslator<T> requires a specialization for the current type.");
 			return {};
@@ -97,7 +453,7 @@ namespace Evex
 		using ContainerType = std::basic_string<char>;
 		using IterType = std::basic_string<char>::iterator;
 		using ConstIterType = std::basic_string<char>::const_iterator;
-		using InstructionSet = std::vector<RegexInstruction<char>>;
+		using InstructionSet = RegexProgram<char>;
 	
 		struct IndexTracker
 		{
@@ -126,7 +482,7 @@ namespace Evex
 		};
 	
 		// Handles creation of Character Class Symbols.
-		static ContainerType MunchCharClassSymbol(IterType& iter,
+		static int MunchCharClassSymbol(IterType& iter,
 			ConstIterType& endIter,
 			std::string& error,
 			IndexTracker& CCSymbsToInds,
@@ -146,7 +502,7 @@ namespace Evex
 				if (found != CCSymbsToInds.Indices.end())
 				{
 					iter = EndDot;
-					return std::to_string(found->second);
+					return found->second;
 				}
 	
 				if (--EndDot != iter)
@@ -155,16 +511,14 @@ namespace Evex
 					SnippedMunched.erase(SnippedMunched.begin());
 					SnippedMunched.pop_back();
 	
-					std::vector<ContainerType> Pieces;
-					for (char& currPiece : SnippedMunched)
-						Pieces.push_back(ContainerType(1, currPiece));
-	
 					iter = ++EndDot;
 	
-					OutInstructions.push_back({ RegexInstructionType::MakeCharClassLigatureSymbol, Pieces });
+					OutInstructions.Add(RegexInstructionType::MakeCharClassLigatureSymbol);
+					for (char& currPiece : SnippedMunched)
+						OutInstructions.AddOperand(currPiece);
 	
 					CCSymbsToInds.Indices[Munched] = CCSymbsToInds.NextIndex;
-					return std::to_string(CCSymbsToInds.NextIndex++);
+					return CCSymbsToInds.NextIndex++;
 				}
 			}
 			Munched.clear();
@@ -180,16 +534,16 @@ namespace Evex
 				if (found != CCSymbsToInds.Indices.end())
 				{
 					iter = ahead;
-					return std::to_string(found->second);
+					return found->second;
 				}
 	
 				if (min[0] < max[0])
-					OutInstructions.push_back({ RegexInstructionType::MakeCharClassSymbol, { min, max } });
+					OutInstructions.Add(RegexInstructionType::MakeCharClassSymbol, { min[0], max[0] });
 				else
 				{
 					error = "Regex Compile Error: Character range invalid. "
 						"(#" + std::to_string((int)min[0]) + "-#" + std::to_string((int)max[0]) + ")";
-					return "-1";
+					return -1;
 				}
 				iter = ahead;
 			}
@@ -199,13 +553,13 @@ namespace Evex
 	
 				auto found = CCSymbsToInds.Indices.find(Munched);
 				if (found != CCSymbsToInds.Indices.end())
-					return std::to_string(found->second);
+					return found->second;
 	
-				OutInstructions.push_back({ RegexInstructionType::MakeCharClassSymbol, { Munched, Munched } });
+				OutInstructions.Add(RegexInstructionType::MakeCharClassSymbol, { Munched[0], Munched[0] });
 			}
 	
 			CCSymbsToInds.Indices[Munched] = CCSymbsToInds.NextIndex;
-			return std::to_string(CCSymbsToInds.NextIndex++);
+			return CCSymbsToInds.NextIndex++;
 		}
 	
 		// Handles creation of direct literal nodes, i.e. nodes that are just "a" rather than a Character Class like "[a-z]".
@@ -222,29 +576,29 @@ namespace Evex
 			auto found = CCsToInds.Indices.find(CCName);
 			if (found != CCsToInds.Indices.end())
 			{
-				OutInstructions.push_back({ RegexInstructionType::Literal, { std::to_string(found->second) } });
+				OutInstructions.Add(RegexInstructionType::Literal, { found->second });
 				return;
 			}
 	
-			ContainerType Ind;
+			int Ind;
 			{
 				ContainerType CCSymbName(1, *iter);
 	
 				auto found = CCSymbsToInds.Indices.find(CCSymbName);
 				if (found != CCSymbsToInds.Indices.end())
-					Ind = std::to_string(found->second);
+					Ind = found->second;
 	
-				OutInstructions.push_back({ RegexInstructionType::MakeCharClassSymbol,{ CCSymbName, CCSymbName } });
+				OutInstructions.Add(RegexInstructionType::MakeCharClassSymbol, { CCSymbName[0], CCSymbName[0] });
 	
 				CCSymbsToInds.Indices[CCSymbName] = CCSymbsToInds.NextIndex;
-				Ind = std::to_string(CCSymbsToInds.NextIndex++);
+				Ind = CCSymbsToInds.NextIndex++;
 			}
 	
-			OutInstructions.push_back({ RegexInstructionType::MakeLiteralCharClass, { "f", (Modifs.CaseInsensitive ? "t" : "f"), Ind } });
+			OutInstructions.Add(RegexInstructionType::MakeLiteralCharClass, { false, Modifs.CaseInsensitive, Ind });
 	
 			CCsToInds.Indices[CCName] = CCsToInds.NextIndex;
 	
-			OutInstructions.push_back({ RegexInstructionType::Literal, { std::to_string(CCsToInds.NextIndex++) } });
+			OutInstructions.Add(RegexInstructionType::Literal, { CCsToInds.NextIndex++ });
 		}
 	
 		// Does not handle Shorthand Character Classes on its own; rather, it returns the real class behind the shorthand for construction elsewhere.
@@ -322,7 +676,7 @@ namespace Evex
 		}
 	
 		// Handles construction of Character Classes.
-		static ContainerType MunchCharClass(IterType& iter,
+		static int MunchCharClass(IterType& iter,
 			ConstIterType& endIter,
 			std::string& error,
 			IndexTracker& CCSymbsToInds,
@@ -334,7 +688,7 @@ namespace Evex
 			if (MaxDepth <= 0)
 			{
 				error = "Regex Compile Error: Char class nesting surpasses the Max Nesting Depth limit.";
-				return "";
+				return -1;
 			}
 	
 			ContainerType FullCCName;
@@ -346,7 +700,7 @@ namespace Evex
 			{
 				auto found = CCsToInds.Indices.find(FullCCName);
 				if (found != CCsToInds.Indices.end())
-					return std::to_string(found->second);
+					return found->second;
 			}
 	
 			std::vector<RegexInstructionType> Types;
@@ -414,7 +768,7 @@ namespace Evex
 							if (Stragglers.empty() && Chunks.empty())
 							{
 								error = "Regex Compile Error: Malformed character class intersect.";
-								return "";
+								return -1;
 							}
 	
 							if (!Stragglers.empty())
@@ -447,7 +801,7 @@ namespace Evex
 						if (Stragglers.empty() && Chunks.empty())
 						{
 							error = "Regex Compile Error: Malformed character class subtract.";
-							return "";
+							return -1;
 						}
 	
 						if (!Stragglers.empty())
@@ -501,7 +855,8 @@ namespace Evex
 	
 			if (!Types.empty())
 			{
-				ContainerType rhs, Ind, RollingName;
+				int rhs, Ind;
+				ContainerType RollingName;
 				if (Chunks[0].empty())
 				{
 					Ind =
@@ -511,17 +866,17 @@ namespace Evex
 				}
 				else
 				{
-					ContainerType lhs =
+					int lhs =
 						MunchCharClass(Chunks[0].begin(), Chunks[0].end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
-					ContainerType rhs =
+					int rhs =
 						MunchCharClass(Chunks[1].begin(), Chunks[1].end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
 	
-					OutInstructions.push_back({ Types[0],{ lhs, rhs } });
+					OutInstructions.Add(Types[0], { lhs, rhs });
 	
 					RollingName = Chunks[0] + Chunks[1];
 	
 					CCsToInds.Indices[RollingName] = CCsToInds.NextIndex;
-					Ind = std::to_string(CCsToInds.NextIndex++);
+					Ind = CCsToInds.NextIndex++;
 				}
 	
 				for (unsigned int i = 2; i < Chunks.size(); ++i)
@@ -529,12 +884,12 @@ namespace Evex
 					rhs =
 						MunchCharClass(Chunks[i].begin(), Chunks[i].end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
 	
-					OutInstructions.push_back({ Types[i - 1],{ Ind, rhs } });
+					OutInstructions.Add(Types[i - 1], { Ind, rhs });
 	
 					RollingName += Chunks[i];
 	
 					CCsToInds.Indices[RollingName] = CCsToInds.NextIndex;
-					Ind = std::to_string(CCsToInds.NextIndex++);
+					Ind = CCsToInds.NextIndex++;
 				}
 	
 				return Ind;
@@ -543,19 +898,13 @@ namespace Evex
 			{
 				if (!Stragglers.empty())
 				{
-					std::vector<ContainerType> RollingSymbolInds;
+					std::vector<int> RollingSymbolInds;
 	
 					IterType TrueIter = Stragglers.begin();
 	
-					if (Stragglers[0] == '^')
-					{
-						RollingSymbolInds.push_back("t");
+					bool Negated = Stragglers[0] == '^';
+					if (Negated)
 						++TrueIter;
-					}
-					else
-						RollingSymbolInds.push_back("f");
-	
-					RollingSymbolInds.push_back((Modifs.CaseInsensitive ? "t" : "f"));
 	
 					for (; TrueIter != Stragglers.end(); ++TrueIter)
 					{
@@ -564,15 +913,17 @@ namespace Evex
 						RollingSymbolInds.push_back(MunchCharClassSymbol(TrueIter, Stragglers.end(), error, CCSymbsToInds, OutInstructions));
 					}
 	
-					OutInstructions.push_back({ RegexInstructionType::MakeLiteralCharClass, RollingSymbolInds });
+					OutInstructions.Add(RegexInstructionType::MakeLiteralCharClass, { Negated, Modifs.CaseInsensitive });
+					for (int currInd : RollingSymbolInds)
+						OutInstructions.AddOperand(currInd);
 	
 					CCsToInds.Indices[FullCCName] = CCsToInds.NextIndex;
-					return std::to_string(CCsToInds.NextIndex++);
+					return CCsToInds.NextIndex++;
 				}
 				else
 				{
 					error = "Regex Compile Error: Empty Character Class.";
-					return "";
+					return -1;
 				}
 			}
 		}
@@ -622,15 +973,15 @@ namespace Evex
 				{
 					if (sign > 0) // forward
 					{
-						ContainerType TrueCap = std::to_string(std::stoi(Munch) + NextCapGroup);
-						OutInstructions.push_back({ RegexInstructionType::Backref_Numbered, { TrueCap } });
+						int TrueCap = std::stoi(Munch) + NextCapGroup;
+						OutInstructions.Add(RegexInstructionType::Backref_Numbered, { TrueCap });
 					}
 					else // relative
 					{
 						int TrueCap = NextCapGroup + 1 + (-std::stoi(Munch));
 	
 						if (TrueCap > 0)
-							OutInstructions.push_back({ RegexInstructionType::Backref_Numbered, { std::to_string(TrueCap) } });
+							OutInstructions.Add(RegexInstructionType::Backref_Numbered, { TrueCap });
 						else
 						{
 							error = "Regex Compile Error: Capture Group \'" + std::to_string(TrueCap) + "\' does not and cannot exist. "
@@ -641,8 +992,9 @@ namespace Evex
 				}
 				else // numbered
 				{
-					if (std::stoi(Munch) > 0)
-						OutInstructions.push_back({ RegexInstructionType::Backref_Numbered, { Munch } });
+					int Cap = std::stoi(Munch);
+					if (Cap > 0)
+						OutInstructions.Add(RegexInstructionType::Backref_Numbered, { Cap });
 					else
 					{
 						error = "Regex Compile Error: Capture Group \'" + Munch + "\' does not and cannot exist. "
@@ -652,7 +1004,7 @@ namespace Evex
 				}
 			}
 			else // named
-				OutInstructions.push_back({ RegexInstructionType::Backref_Named, { Munch } });
+				OutInstructions.Add(RegexInstructionType::Backref_Named, { OutInstructions.Name(Munch) });
 		}
 
 		// Handles numbered, named, relative, and forward subroutines, as well as recursion
@@ -666,7 +1018,7 @@ namespace Evex
 		{
 			if (*iter == 'R' || *iter == '0') // recursion
 			{
-				OutInstructions.push_back({ RegexInstructionType::Recursion, { std::to_string(MaxDepth), (Modifs.LazyGroups ? "t" : "f") } });
+				OutInstructions.Add(RegexInstructionType::Recursion, { MaxDepth, Modifs.LazyGroups });
 				++iter;
 				return;
 			}
@@ -713,15 +1065,15 @@ namespace Evex
 				{
 					if (sign > 0) // forward
 					{
-						ContainerType TrueCap = std::to_string(std::stoi(Munch) + NextCapGroup);
-						OutInstructions.push_back({ RegexInstructionType::Subroutine_Numbered,{ Munch, TrueCap } });
+						int TrueCap = std::stoi(Munch) + NextCapGroup;
+						OutInstructions.Add(RegexInstructionType::Subroutine_Numbered, { TrueCap, MaxDepth });
 					}
 					else // relative
 					{
 						int TrueCap = NextCapGroup + 1 + (-std::stoi(Munch));
 	
 						if (TrueCap > 0)
-							OutInstructions.push_back({ RegexInstructionType::Subroutine_Numbered,{ Munch, std::to_string(TrueCap) } });
+							OutInstructions.Add(RegexInstructionType::Subroutine_Numbered, { TrueCap, MaxDepth });
 						else
 						{
 							error = "Regex Compile Error: Capture Group \'" + std::to_string(TrueCap) + "\' does not and cannot exist. "
@@ -732,8 +1084,9 @@ namespace Evex
 				}
 				else // numbered
 				{
-					if (std::stoi(Munch) > 0)
-						OutInstructions.push_back({ RegexInstructionType::Subroutine_Numbered,{ Munch, std::to_string(MaxDepth) } });
+					int Cap = std::stoi(Munch);
+					if (Cap > 0)
+						OutInstructions.Add(RegexInstructionType::Subroutine_Numbered, { Cap, MaxDepth });
 					else
 					{
 						error = "Regex Compile Error: Capture Group \'" + Munch + "\' does not and cannot exist. "
@@ -743,7 +1096,7 @@ namespace Evex
 				}
 			}
 			else // named
-				OutInstructions.push_back({ RegexInstructionType::Subroutine_Named,{ Munch, std::to_string(MaxDepth) } });
+				OutInstructions.Add(RegexInstructionType::Subroutine_Named, { OutInstructions.Name(Munch), MaxDepth });
 		}
 
 		// Handles special characters/escapes
@@ -757,65 +1110,71 @@ namespace Evex
 			Modifiers& Modifs,
 			int MaxDepth)
 		{
-			switch (*(++iter))
+			if (++iter == endIter)
+			{
+				error = "Regex Compile Error: Pattern ends in a lone escape.";
+				return;
+			}
+	
+			switch (*iter)
 			{
 			case 'A': // Exclusive start of string
 				{
 					ContainerType LineChars = "\r\n\v\f]";
-					ContainerType Ind =
+					int Ind =
 						MunchCharClass(LineChars.begin(), LineChars.end() - 1, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
 	
-					OutInstructions.push_back({ RegexInstructionType::StartCheck, { "t", "f", Ind } });
+					OutInstructions.Add(RegexInstructionType::StartCheck, { true, false, Ind });
 				}
 				break;
 	
 			case 'z': // Exclusive end of string
 				{
 					ContainerType LineChars = "\r\n\v\f";
-					ContainerType Ind =
+					int Ind =
 						MunchCharClass(LineChars.begin(), LineChars.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
 	
-					OutInstructions.push_back({ RegexInstructionType::EndCheck,{ "t", "f", Ind } });
+					OutInstructions.Add(RegexInstructionType::EndCheck, { true, false, Ind });
 				}
 				break;
 	
 			case 'Z': // end of string before final line break
 				{
 					ContainerType LineChars = "\r\n\v\f";
-					ContainerType Ind =
+					int Ind =
 						MunchCharClass(LineChars.begin(), LineChars.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
 	
-					OutInstructions.push_back({ RegexInstructionType::EndCheck,{ "t", "t", Ind } });
+					OutInstructions.Add(RegexInstructionType::EndCheck, { true, true, Ind });
 				}
 				break;
 	
 			case 'b': // word boundary
 				{
 					ContainerType WordChars = "A-Za-z0-9_";
-					ContainerType Ind =
+					int Ind =
 						MunchCharClass(WordChars.begin(), WordChars.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
 	
-					OutInstructions.push_back({ RegexInstructionType::WordBoundary,{ "f", Ind } });
+					OutInstructions.Add(RegexInstructionType::WordBoundary, { false, Ind });
 				}
 				break;
 	
 			case 'B': // not-word boundary
 				{
 					ContainerType WordChars = "A-Za-z0-9_";
-					ContainerType Ind =
+					int Ind =
 						MunchCharClass(WordChars.begin(), WordChars.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
 	
-					OutInstructions.push_back({ RegexInstructionType::WordBoundary,{ "t", Ind } });
+					OutInstructions.Add(RegexInstructionType::WordBoundary, { true, Ind });
 				}
 				break;
 	
 			case 'G': // start of string or end of last match
 				{
 					ContainerType LineChars = "\r\n\v\f";
-					ContainerType Ind =
+					int Ind =
 						MunchCharClass(LineChars.begin(), LineChars.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
 	
-					OutInstructions.push_back({ RegexInstructionType::StartCheck,{ "t", "t", Ind } });
+					OutInstructions.Add(RegexInstructionType::StartCheck, { true, true, Ind });
 				}
 				break;
 	
@@ -832,7 +1191,7 @@ namespace Evex
 						}
 						MunchLiteral(iter, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs);
 						if (++Lits > 1)
-							OutInstructions.push_back({ RegexInstructionType::Concat, {} });
+							OutInstructions.Add(RegexInstructionType::Concat);
 					}
 	
 					if (iter == endIter)
@@ -904,14 +1263,14 @@ namespace Evex
 							MunchLiteral(iter, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs);
 						else
 						{
-							ContainerType Ind;
+							int Ind;
 							auto found = CCsToInds.Indices.find(Short);
 							if (found != CCsToInds.Indices.end())
-								Ind = std::to_string(found->second);
+								Ind = found->second;
 							else
 								Ind = MunchCharClass(Short.begin(), Short.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth);
 	
-							OutInstructions.push_back({ RegexInstructionType::Literal,{ Ind } });
+							OutInstructions.Add(RegexInstructionType::Literal, { Ind });
 						}
 					}
 				}
@@ -919,70 +1278,13 @@ namespace Evex
 			}
 		}
 
-		// Helper function for reversing a group. Specifically used during construction of lookbehinds.
-		static ContainerType ReverseGroup(IterType& iter, ConstIterType& endIter)
-		{
-			ContainerType Munch;
-			while (++iter != endIter)
-			{
-				if (*iter == '\\')
-				{
-					Munch.insert(Munch.begin(), *iter);
-					Munch.insert(Munch.begin() + 1, *(++iter));
-					continue;
-				}
-				if (*iter == '[')
-				{
-					if (*(--iter) != '\\')
-					{
-						ContainerType SubChunk;
-						IterType Copy = ++iter;
-						SubChunk += *Copy;
-						while (++Copy != endIter)
-						{
-							if (*Copy == ']')
-							{
-								if (*(--Copy) != '\\')
-									break;
-								++Copy;
-							}
-							SubChunk += *Copy;
-						}
-						SubChunk += *(++Copy);
-						Munch.insert(Munch.begin(), SubChunk.begin(), SubChunk.end());
-						iter = Copy;
-						continue;
-					}
-					++iter;
-				}
-				if (*iter == '(')
-				{
-					if (*(--iter) != '\\')
-					{
-						ContainerType SubChunk;
-						IterType Copy = ++iter;
-						SubChunk += *Copy;
-						while (++Copy != endIter)
-						{
-							if (*Copy == ')')
-							{
-								if (*(--Copy) != '\\')
-									break;
-								++Copy;
-							}
-							SubChunk += *Copy;
-						}
-						SubChunk += *(++Copy);
-						Munch.insert(Munch.begin(), SubChunk.begin(), SubChunk.end());
-						iter = Copy;
-						continue;
-					}
-					++iter;
-				}
-				Munch.insert(Munch.begin(), *iter);
-			}
+		// Moves iter up to endIter, past a group body that was translated in place.
+		static inline void SkipTo(IterType& iter, ConstIterType endIter) { iter += endIter - iter; }
 	
-			return Munch;
+		static inline bool IsMakeCapture(const RegexInstruction& Instruction)
+		{
+			return Instruction.InstructionType == RegexInstructionType::MakeCapture ||
+				Instruction.InstructionType == RegexInstructionType::MakeCaptureCollection;
 		}
 
 		// Handles special and regular groups.
@@ -1009,91 +1311,61 @@ namespace Evex
 				case '|': // branch reset group ("(?|(a)|(b)|(c))")
 					{
 						int AltCount = 0;
-						std::vector<ContainerType> Branches;
-						Branches.push_back("");
-						while (++iter != endIter)
-						{
-							if (*iter == '|')
-							{
-								++AltCount;
-								Branches.push_back("");
-							}
-							else
-								Branches[Branches.size() - 1] += *iter;
-						}
 	
-						std::vector<std::pair<unsigned int, unsigned int>> Caps;
-						for (ContainerType& currBranch : Branches)
+						// Captures are shared between branches, so each branch's n-th capture only needs making once.
+						unsigned int CapsMade = 0;
+	
+						// Each branch is translated on its own first, as its captures are made ahead of all of it.
+						InstructionSet Branch;
+						IterType BranchBegin = iter + 1;
+						do
 						{
-							unsigned int CurrCap = 0;
-							InstructionSet Chunks =
-								TranslateInternal(currBranch, currBranch.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
+							++iter;
+							if (iter != endIter && *iter != '|')
+								continue;
+	
+							Branch.clear();
+							TranslateInternal(BranchBegin, iter, error, CCSymbsToInds, CCsToInds, Branch, Modifs, MaxDepth - 1);
 	
-							if (Chunks.empty())
+							if (Branch.empty())
 								--AltCount;
 							else
 							{
-								for (unsigned int i = 0; i < Chunks.size(); ++i)
+								unsigned int CurrCap = 0;
+								for (const RegexInstruction& currInstruction : Branch.Instructions)
 								{
-									if (Chunks[i].InstructionType == RegexInstructionType::MakeCapture)
-									{
-										if (Caps.empty() || CurrCap >= Caps.size())
-										{
-											OutInstructions.push_back({ RegexInstructionType::MakeCapture, { "f" } });
-											Caps.push_back({ ++NextCapGroup, OutInstructions.size() - 1 });
-										}
-										else
-										{
-											RegexInstruction<char> LastInst = OutInstructions[Caps[CurrCap].second];
-											std::vector<ContainerType>& NamesToCopy = Chunks[i].InstructionData;
-	
-											LastInst.InstructionData.insert(LastInst.InstructionData.end(), NamesToCopy.begin() + 1, NamesToCopy.end());
-										}
-										Chunks.erase(Chunks.begin() + i);
-										--i;
-										++CurrCap;
-									}
-									else if (Chunks[i].InstructionType == RegexInstructionType::MakeCaptureCollection)
+									if (IsMakeCapture(currInstruction) && CurrCap++ >= CapsMade)
 									{
-										if (Caps.empty() || CurrCap >= Caps.size())
-										{
-											OutInstructions.push_back({ RegexInstructionType::MakeCaptureCollection, { "f" } });
-											Caps.push_back({ ++NextCapGroup, OutInstructions.size() - 1 });
-										}
-										else
-										{
-											RegexInstruction<char> LastInst = OutInstructions[Caps[CurrCap].second];
-											std::vector<ContainerType>& NamesToCopy = Chunks[i].InstructionData;
-	
-											LastInst.InstructionType = RegexInstructionType::MakeCaptureCollection;
-											LastInst.InstructionData.insert(LastInst.InstructionData.end(), NamesToCopy.begin() + 1, NamesToCopy.end());
-										}
-										Chunks.erase(Chunks.begin() + i);
-										--i;
-										++CurrCap;
+										OutInstructions.Add(currInstruction.InstructionType, { false });
+										++NextCapGroup;
+										++CapsMade;
 									}
 								}
-								OutInstructions.insert(OutInstructions.end(), Chunks.begin(), Chunks.end());
+	
+								Branch.Instructions.erase(std::remove_if(Branch.Instructions.begin(), Branch.Instructions.end(), IsMakeCapture),
+									Branch.Instructions.end());
+								OutInstructions.Append(Branch);
 							}
-						}
+	
+							if (iter != endIter)
+							{
+								++AltCount;
+								BranchBegin = iter + 1;
+							}
+						} while (iter != endIter);
 	
 						while (AltCount-- > 0)
-							OutInstructions.push_back({ RegexInstructionType::Alternate, {} });
+							OutInstructions.Add(RegexInstructionType::Alternate);
 	
-						OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
+						OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
 					}
 					break;
 	
 				case '=': // positive lookahead ("(?=regex)")
 					{
-						ContainerType Munch;
-						while (++iter != endIter)
-							Munch += *iter;
-	
-						InstructionSet NewInsts =
-							TranslateInternal(Munch, Munch.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-						OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
-						OutInstructions.push_back({ RegexInstructionType::LookAhead, { "f", (Modifs.LazyGroups ? "t" : "f") } });
+						TranslateInternal(iter + 1, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+						SkipTo(iter, endIter);
+						OutInstructions.Add(RegexInstructionType::LookAhead, { false, Modifs.LazyGroups });
 					}
 					break;
 	
@@ -1102,23 +1374,17 @@ namespace Evex
 					{
 					case '=': // positive lookbehind ("(?<=regex)")
 						{
-							ContainerType Munch = ReverseGroup(iter, endIter);
-	
-							InstructionSet NewInsts =
-								TranslateInternal(Munch, Munch.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-							OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
-							OutInstructions.push_back({ RegexInstructionType::LookBehind,{ "f", (Modifs.LazyGroups ? "t" : "f") } });
+							TranslateInternal(iter + 1, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+							SkipTo(iter, endIter);
+							OutInstructions.Add(RegexInstructionType::LookBehind, { false, Modifs.LazyGroups });
 						}
 						break;
 	
 					case '!': // negative lookbehind ("(?<!regex)")
 						{
-							ContainerType Munch = ReverseGroup(iter, endIter);
-	
-							InstructionSet NewInsts =
-								TranslateInternal(Munch, Munch.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-							OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
-							OutInstructions.push_back({ RegexInstructionType::LookBehind,{ "t", (Modifs.LazyGroups ? "t" : "f") } });
+							TranslateInternal(iter + 1, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+							SkipTo(iter, endIter);
+							OutInstructions.Add(RegexInstructionType::LookBehind, { true, Modifs.LazyGroups });
 						}
 						break;
 	
@@ -1141,23 +1407,18 @@ namespace Evex
 	
 							if (iter + 1 == endIter) // named subroutine
 							{
-								OutInstructions.push_back({ RegexInstructionType::Subroutine_Named, { Name, std::to_string(MaxDepth) } });
+								OutInstructions.Add(RegexInstructionType::Subroutine_Named, { OutInstructions.Name(Name), MaxDepth });
 								++iter;
 							}
 							else // named capture group
 							{
 								++NextCapGroup;
-								OutInstructions.push_back({ RegexInstructionType::MakeCapture, { "f", Name } });
-	
-								ContainerType Regex;
-								while (++iter != endIter)
-									Regex += *iter;
+								OutInstructions.Add(RegexInstructionType::MakeCapture, { false, OutInstructions.Name(Name) });
 	
-								InstructionSet NewInsts =
-									TranslateInternal(Regex, Regex.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-								OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
+								TranslateInternal(iter + 1, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+								SkipTo(iter, endIter);
 	
-								OutInstructions.push_back({ RegexInstructionType::CaptureGroup_Named, { Name, (Modifs.LazyGroups ? "t" : "f") } });
+								OutInstructions.Add(RegexInstructionType::CaptureGroup_Named, { OutInstructions.Name(Name), Modifs.LazyGroups });
 							}
 						}
 						break;
@@ -1166,15 +1427,10 @@ namespace Evex
 	
 				case ':': // non-capturing group ("(?:regex)")
 					{
-						ContainerType Regex;
-						while (++iter != endIter)
-							Regex += *iter;
-	
-						InstructionSet NewInsts =
-							TranslateInternal(Regex, Regex.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-						OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
+						TranslateInternal(iter + 1, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+						SkipTo(iter, endIter);
 	
-						OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
+						OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
 					}
 					break;
 	
@@ -1238,22 +1494,17 @@ namespace Evex
 								currPiece.clear();
 							}
 	
-							InstructionSet ThenSet =
-								TranslateInternal(prevPiece, prevPiece.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-							OutInstructions.insert(OutInstructions.end(), ThenSet.begin(), ThenSet.end());
-							OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
+							TranslateInternal(prevPiece.begin(), prevPiece.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+							OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
 	
 							if (!currPiece.empty())
 							{
-								InstructionSet ElseSet =
-									TranslateInternal(currPiece, currPiece.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-	
-								OutInstructions.insert(OutInstructions.end(), ElseSet.begin(), ElseSet.end());
-								OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
-								OutInstructions.push_back({ RegexInstructionType::Conditional, { "2", (Modifs.LazyGroups ? "t" : "f") } });
+								TranslateInternal(currPiece.begin(), currPiece.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+								OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
+								OutInstructions.Add(RegexInstructionType::Conditional, { 2, Modifs.LazyGroups });
 							}
 							else
-								OutInstructions.push_back({ RegexInstructionType::Conditional, { "1", (Modifs.LazyGroups ? "t" : "f") } });
+								OutInstructions.Add(RegexInstructionType::Conditional, { 1, Modifs.LazyGroups });
 						}
 						break;
 	
@@ -1301,22 +1552,17 @@ namespace Evex
 								currPiece.clear();
 							}
 	
-							InstructionSet ThenSet =
-								TranslateInternal(prevPiece, prevPiece.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-							OutInstructions.insert(OutInstructions.end(), ThenSet.begin(), ThenSet.end());
-							OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
+							TranslateInternal(prevPiece.begin(), prevPiece.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+							OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
 	
 							if (!currPiece.empty())
 							{
-								InstructionSet ElseSet =
-									TranslateInternal(currPiece, currPiece.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-	
-								OutInstructions.insert(OutInstructions.end(), ElseSet.begin(), ElseSet.end());
-								OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
-								OutInstructions.push_back({ RegexInstructionType::Conditional,{ "2", (Modifs.LazyGroups ? "t" : "f") } });
+								TranslateInternal(currPiece.begin(), currPiece.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+								OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
+								OutInstructions.Add(RegexInstructionType::Conditional, { 2, Modifs.LazyGroups });
 							}
 							else
-								OutInstructions.push_back({ RegexInstructionType::Conditional,{ "1", (Modifs.LazyGroups ? "t" : "f") } });
+								OutInstructions.Add(RegexInstructionType::Conditional, { 1, Modifs.LazyGroups });
 						}
 						break;
 	
@@ -1365,22 +1611,17 @@ namespace Evex
 								currPiece.clear();
 							}
 	
-							InstructionSet ThenSet =
-								TranslateInternal(prevPiece, prevPiece.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-							OutInstructions.insert(OutInstructions.end(), ThenSet.begin(), ThenSet.end());
-							OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
+							TranslateInternal(prevPiece.begin(), prevPiece.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+							OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
 	
 							if (!currPiece.empty())
 							{
-								InstructionSet ElseSet =
-									TranslateInternal(currPiece, currPiece.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-	
-								OutInstructions.insert(OutInstructions.end(), ElseSet.begin(), ElseSet.end());
-								OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
-								OutInstructions.push_back({ RegexInstructionType::Conditional,{ "2", (Modifs.LazyGroups ? "t" : "f") } });
+								TranslateInternal(currPiece.begin(), currPiece.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+								OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
+								OutInstructions.Add(RegexInstructionType::Conditional, { 2, Modifs.LazyGroups });
 							}
 							else
-								OutInstructions.push_back({ RegexInstructionType::Conditional,{ "1", (Modifs.LazyGroups ? "t" : "f") } });
+								OutInstructions.Add(RegexInstructionType::Conditional, { 1, Modifs.LazyGroups });
 						}
 						else // Subroutine Definition or Regular Conditional
 						{
@@ -1407,8 +1648,8 @@ namespace Evex
 										return;
 									}
 	
-									Regex.clear();
-									FindEnd(iter, endIter, '(', ')', &Regex);
+									IterType BodyBegin = iter + 1;
+									FindEnd(iter, endIter, '(', ')', nullptr);
 	
 									if (iter == endIter)
 									{
@@ -1416,14 +1657,11 @@ namespace Evex
 										return;
 									}
 	
+									TranslateInternal(BodyBegin, iter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
 									++iter;
 	
-									InstructionSet NewInsts =
-										TranslateInternal(Regex, Regex.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-									OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
-	
-									OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
-									OutInstructions.push_back({ RegexInstructionType::DefineAsSubroutine, { Name } });
+									OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
+									OutInstructions.Add(RegexInstructionType::DefineAsSubroutine, { OutInstructions.Name(Name) });
 								}
 								else
 								{
@@ -1468,22 +1706,17 @@ namespace Evex
 									currPiece.clear();
 								}
 	
-								InstructionSet ThenSet =
-									TranslateInternal(prevPiece, prevPiece.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-								OutInstructions.insert(OutInstructions.end(), ThenSet.begin(), ThenSet.end());
-								OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
+								TranslateInternal(prevPiece.begin(), prevPiece.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+								OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
 	
 								if (!currPiece.empty())
 								{
-									InstructionSet ElseSet =
-										TranslateInternal(currPiece, currPiece.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-	
-									OutInstructions.insert(OutInstructions.end(), ElseSet.begin(), ElseSet.end());
-									OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
-									OutInstructions.push_back({ RegexInstructionType::Conditional,{ "2", (Modifs.LazyGroups ? "t" : "f") } });
+									TranslateInternal(currPiece.begin(), currPiece.end(), error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+									OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
+									OutInstructions.Add(RegexInstructionType::Conditional, { 2, Modifs.LazyGroups });
 								}
 								else
-									OutInstructions.push_back({ RegexInstructionType::Conditional,{ "1", (Modifs.LazyGroups ? "t" : "f") } });
+									OutInstructions.Add(RegexInstructionType::Conditional, { 1, Modifs.LazyGroups });
 							}
 						}
 						break;
@@ -1510,37 +1743,27 @@ namespace Evex
 	
 						if (iter + 1 == endIter) // named subroutine
 						{
-							OutInstructions.push_back({ RegexInstructionType::Subroutine_Named, { Name, std::to_string(MaxDepth) } });
+							OutInstructions.Add(RegexInstructionType::Subroutine_Named, { OutInstructions.Name(Name), MaxDepth });
 							++iter;
 						}
 						else // named capture group
 						{
 							++NextCapGroup;
-							OutInstructions.push_back({ RegexInstructionType::MakeCapture, { "f", Name } });
-	
-							ContainerType Regex;
-							while (++iter != endIter)
-								Regex += *iter;
+							OutInstructions.Add(RegexInstructionType::MakeCapture, { false, OutInstructions.Name(Name) });
 	
-							InstructionSet NewInsts =
-								TranslateInternal(Regex, Regex.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-							OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
+							TranslateInternal(iter + 1, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+							SkipTo(iter, endIter);
 	
-							OutInstructions.push_back({ RegexInstructionType::CaptureGroup_Named,{ Name, (Modifs.LazyGroups ? "t" : "f") } });
+							OutInstructions.Add(RegexInstructionType::CaptureGroup_Named, { OutInstructions.Name(Name), Modifs.LazyGroups });
 						}
 					}
 					break;
 	
 				case '!': // negative lookahead ("(?!regex)")
 					{
-						ContainerType Munch;
-						while (++iter != endIter)
-							Munch += *iter;
-	
-						InstructionSet NewInsts =
-							TranslateInternal(Munch, Munch.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-						OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
-						OutInstructions.push_back({ RegexInstructionType::LookAhead,{ "t", (Modifs.LazyGroups ? "t" : "f") } });
+						TranslateInternal(iter + 1, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+						SkipTo(iter, endIter);
+						OutInstructions.Add(RegexInstructionType::LookAhead, { true, Modifs.LazyGroups });
 					}
 					break;
 	
@@ -1564,38 +1787,25 @@ namespace Evex
 	
 	
 						++NextCapGroup;
-						OutInstructions.push_back({ RegexInstructionType::MakeCaptureCollection, { "f", Name } });
-	
-						ContainerType Regex;
-						while (++iter != endIter)
-							Regex += *iter;
+						OutInstructions.Add(RegexInstructionType::MakeCaptureCollection, { false, OutInstructions.Name(Name) });
 	
-						InstructionSet NewInsts =
-							TranslateInternal(Regex, Regex.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-						OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
+						TranslateInternal(iter + 1, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+						SkipTo(iter, endIter);
 	
-						OutInstructions.push_back({ RegexInstructionType::CaptureGroup_Named,{ Name, (Modifs.LazyGroups ? "t" : "f") } });
+						OutInstructions.Add(RegexInstructionType::CaptureGroup_Named, { OutInstructions.Name(Name), Modifs.LazyGroups });
 					}
 					else // numbered
 					{
 						if (!Modifs.NoAutoCap)
-							OutInstructions.push_back({ RegexInstructionType::MakeCaptureCollection, { "f" } });
+							OutInstructions.Add(RegexInstructionType::MakeCaptureCollection, { false });
 	
-						ContainerType Regex;
-						while (iter != endIter)
-						{
-							Regex += *iter;
-							++iter;
-						}
-	
-						InstructionSet NewInsts =
-							TranslateInternal(Regex, Regex.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-						OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
+						TranslateInternal(iter, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+						SkipTo(iter, endIter);
 	
 						if (!Modifs.NoAutoCap)
-							OutInstructions.push_back({ RegexInstructionType::CaptureGroup_Numbered, { std::to_string(++NextCapGroup), (Modifs.LazyGroups ? "t" : "f") } });
+							OutInstructions.Add(RegexInstructionType::CaptureGroup_Numbered, { ++NextCapGroup, Modifs.LazyGroups });
 						else
-							OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
+							OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
 					}
 					break;
 	
@@ -1615,7 +1825,7 @@ namespace Evex
 							return;
 						}
 	
-						OutInstructions.push_back({ RegexInstructionType::CodeHook, { FuncName } });
+						OutInstructions.Add(RegexInstructionType::CodeHook, { OutInstructions.Name(FuncName) });
 						++iter;
 					}
 					break;
@@ -1650,13 +1860,13 @@ namespace Evex
 	
 	
 							++NextCapGroup;
-							OutInstructions.push_back({ CapType, { "t", Name } });
+							OutInstructions.Add(CapType, { true, OutInstructions.Name(Name) });
 							++iter;
 						}
 						else // numbered
 						{
 							++NextCapGroup;
-							OutInstructions.push_back({ CapType, { "t" } });
+							OutInstructions.Add(CapType, { true });
 						}
 					}
 					break;
@@ -1722,23 +1932,18 @@ namespace Evex
 						if (Out && Further != iter && *Further == ':') // modifier noncap
 						{
 							iter = Further;
-							ContainerType Regex;
-							while (++iter != endIter)
-								Regex += *iter;
-	
-							InstructionSet NewInsts =
-								TranslateInternal(Regex, Regex.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-							OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
+							TranslateInternal(iter + 1, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+							SkipTo(iter, endIter);
 	
-							OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup,{ (Modifs.LazyGroups ? "t" : "f") } });
+							OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
 	
 							Modifs = Old;
 						}
 						else if (Out) // error
 						{
-							error = "Regex Compile Error: \'";
+							error = "Regex Compile Error: Group holds a character that is not a valid modifier. (Found: \'";
 							error += *iter;
-							error += "\' is not a valid modifier.";
+							error += "\')";
 							return;
 						}
 						else
@@ -1808,23 +2013,18 @@ namespace Evex
 							if (Out && Further != iter && *Further == ':') // modifier noncap
 							{
 								iter = Further;
-								ContainerType Regex;
-								while (++iter != endIter)
-									Regex += *iter;
-	
-								InstructionSet NewInsts =
-									TranslateInternal(Regex, Regex.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-								OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
+								TranslateInternal(iter + 1, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+								SkipTo(iter, endIter);
 	
-								OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
+								OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
 	
 								Modifs = Old;
 							}
 							else if (Out) // error
 							{
-								error = "Regex Compile Error: \'";
+								error = "Regex Compile Error: Group holds a character that is not a valid modifier. (Found: \'";
 								error += *iter;
-								error += "\' is not a valid modifier.";
+								error += "\')";
 								return;
 							}
 							else
@@ -1839,23 +2039,15 @@ namespace Evex
 			else // regular group
 			{
 				if (!Modifs.NoAutoCap)
-					OutInstructions.push_back({ RegexInstructionType::MakeCapture, { "f" } });
+					OutInstructions.Add(RegexInstructionType::MakeCapture, { false });
 	
-				ContainerType Regex;
-				while (iter != endIter)
-				{
-					Regex += *iter;
-					++iter;
-				}
-	
-				InstructionSet NewInsts =
-					TranslateInternal(Regex, Regex.begin(), error, CCSymbsToInds, CCsToInds, Modifs, MaxDepth - 1);
-				OutInstructions.insert(OutInstructions.end(), NewInsts.begin(), NewInsts.end());
+				TranslateInternal(iter, endIter, error, CCSymbsToInds, CCsToInds, OutInstructions, Modifs, MaxDepth - 1);
+				SkipTo(iter, endIter);
 	
 				if (!Modifs.NoAutoCap)
-					OutInstructions.push_back({ RegexInstructionType::CaptureGroup_Numbered,{ std::to_string(++NextCapGroup), (Modifs.LazyGroups ? "t" : "f") } });
+					OutInstructions.Add(RegexInstructionType::CaptureGroup_Numbered, { ++NextCapGroup, Modifs.LazyGroups });
 				else
-					OutInstructions.push_back({ RegexInstructionType::NonCaptureGroup, { (Modifs.LazyGroups ? "t" : "f") } });
+					OutInstructions.Add(RegexInstructionType::NonCaptureGroup, { Modifs.LazyGroups });
 			}
 		}
 
@@ -1881,28 +2073,28 @@ namespace Evex
 			switch (Op)
 			{
 			case '?': // none or once
-				OutInstructions.push_back({ (Lazy ? RegexInstructionType::NOnceLazy : RegexInstructionType::NOnce), {} });
+				OutInstructions.Add(Lazy ? RegexInstructionType::NOnceLazy : RegexInstructionType::NOnce);
 				break;
 	
 			case '*': // none or more
-				OutInstructions.push_back({ (Lazy ? RegexInstructionType::NPlusLazy : RegexInstructionType::NPlus),{} });
+				OutInstructions.Add(Lazy ? RegexInstructionType::NPlusLazy : RegexInstructionType::NPlus);
 				break;
 	
 			case '+': // one or more
-				OutInstructions.push_back({ (Lazy ? RegexInstructionType::OPlusLazy : RegexInstructionType::OPlus),{} });
+				OutInstructions.Add(Lazy ? RegexInstructionType::OPlusLazy : RegexInstructionType::OPlus);
 				break;
 	
 			case '{': // potential repetition
 				{
 					if (++iter != endIter && isdigit(*iter)) // most likely a repetition ("{N}", "{N,}", "{N,M}")
 					{
-						ContainerType Min(1, *iter);
+						int Min = *iter - '0';
 	
 						if (++iter != endIter && *iter == ',')
 						{
 							if (++iter != endIter && isdigit(*iter))
 							{
-								ContainerType Max(1, *iter);
+								int Max = *iter - '0';
 	
 								if (++iter != endIter && *iter == '}')
 								{
@@ -1911,7 +2103,7 @@ namespace Evex
 									else
 										--iter;
 	
-									OutInstructions.push_back({ (Lazy ? RegexInstructionType::RepeatLazy : RegexInstructionType::Repeat), { "MinMax", Min, Max } });
+									OutInstructions.Add(Lazy ? RegexInstructionType::RepeatLazy : RegexInstructionType::Repeat, { int(RegexRepeatType::MinMax), Min, Max });
 								}
 								else
 									error = "Regex Compile Error: Min-Max Repeat quantifier is missing closing bracket.";
@@ -1923,7 +2115,7 @@ namespace Evex
 								else
 									--iter;
 	
-								OutInstructions.push_back({ (Lazy ? RegexInstructionType::RepeatLazy : RegexInstructionType::Repeat), { "Min", Min, Min } });
+								OutInstructions.Add(Lazy ? RegexInstructionType::RepeatLazy : RegexInstructionType::Repeat, { int(RegexRepeatType::Min), Min, Min });
 							}
 							else
 								error = "Regex Compile Error: Min Repeat quantifier is missing closing bracket.";
@@ -1935,7 +2127,7 @@ namespace Evex
 							else
 								--iter;
 	
-							OutInstructions.push_back({ (Lazy ? RegexInstructionType::RepeatLazy : RegexInstructionType::Repeat), { "Exact", Min, Min } });
+							OutInstructions.Add(Lazy ? RegexInstructionType::RepeatLazy : RegexInstructionType::Repeat, { int(RegexRepeatType::Exact), Min, Min });
 						}
 						else
 							error = "Regex Compile Error: Exact repeat quantifier is missing closing bracket.";
@@ -1951,16 +2143,27 @@ namespace Evex
 			}
 		}
 
-		// Inlet of the recursive descent parser; branches out into all of the functions above.
-		static InstructionSet TranslateInternal(const ContainerType& Infix,
-			IterType& iter,
+		/*
+			Inlet of the recursive descent parser; branches out into all of the functions above.
+	
+			Translates the range [iter, endIter) of the pattern straight onto the end of Out, so group bodies are
+			translated where they lie rather than copied out first. Alternatives are translated one after the other,
+			so only group nesting recurses, and that only as deep as MaxDepth allows.
+		*/
+		static void TranslateInternal(IterType iter,
+			ConstIterType endIter,
 			std::string& error,
 			IndexTracker& CCSymbolsToInds,
 			IndexTracker& CCsToInds,
+			InstructionSet& Out,
 			Modifiers Modifs,
 			int MaxDepth)
 		{
-			InstructionSet Out;
+			const IterType Begin = iter;
+	
+			// Where the current alternative's instructions start, and how many alternatives have made any so far.
+			size_t BranchStart = Out.size();
+			int FilledBranches = 0;
 	
 			int NumNodes = 0;
 	
@@ -1968,19 +2171,19 @@ namespace Evex
 			int LastGroup = 0;
 	
 			int PrevNumNodes = NumNodes;
-			while (iter != Infix.end())
+			while (iter != endIter)
 			{
 				switch (*iter)
 				{
 				case '[': // begin character class
 					{
 						IterType EndBracket = iter;
-						FindEnd(EndBracket, Infix.end(), '[', ']', nullptr);
+						FindEnd(EndBracket, endIter, '[', ']', nullptr);
 	
-						if (EndBracket != Infix.end())
+						if (EndBracket != endIter)
 						{
-							ContainerType Ind = MunchCharClass(++iter, EndBracket, error, CCSymbolsToInds, CCsToInds, Out, Modifs, MaxDepth);
-							Out.push_back({ RegexInstructionType::Literal, { Ind } });
+							int Ind = MunchCharClass(++iter, EndBracket, error, CCSymbolsToInds, CCsToInds, Out, Modifs, MaxDepth);
+							Out.Add(RegexInstructionType::Literal, { Ind });
 						}
 						else
 							error = "Regex Compile Error: Couldn't find closing bracket for character class.";
@@ -1990,13 +2193,13 @@ namespace Evex
 					break;
 	
 				case '\\': // begin escaped metacharacter or special character
-					MunchEscaped(iter, Infix.end(), error, CCSymbolsToInds, CCsToInds, Out, LastGroup, Modifs, MaxDepth);
+					MunchEscaped(iter, endIter, error, CCSymbolsToInds, CCsToInds, Out, LastGroup, Modifs, MaxDepth);
 					++NumNodes;
 					break;
 	
 				case '^': // start of string/line (only valid at beginning of regex)
-					if (!Out.empty() && iter != Infix.begin())
-						MunchLiteral(iter, Infix.end(), error, CCSymbolsToInds, CCsToInds, Out, Modifs);
+					if (Out.size() > BranchStart && iter != Begin)
+						MunchLiteral(iter, endIter, error, CCSymbolsToInds, CCsToInds, Out, Modifs);
 					else
 					{
 						ContainerType LineChars;
@@ -2004,20 +2207,20 @@ namespace Evex
 							LineChars = "[\n]";
 						else
 							LineChars = "[\r\n\v\f]";
-						ContainerType Ind =
+						int Ind =
 							MunchCharClass(LineChars.begin() + 1, LineChars.end() - 1, error, CCSymbolsToInds, CCsToInds, Out, Modifs, MaxDepth);
 	
 						if (Modifs.SingleLine)
-							Out.push_back({ RegexInstructionType::StartCheck, { "t", "f", Ind } });
+							Out.Add(RegexInstructionType::StartCheck, { true, false, Ind });
 						else
-							Out.push_back({ RegexInstructionType::StartCheck, { "f", "f", Ind } });
+							Out.Add(RegexInstructionType::StartCheck, { false, false, Ind });
 					}
 					++NumNodes;
 					break;
 	
 				case '$': // end of string/line (only valid at end of regex)
-					if (iter + 1 != Infix.end())
-						MunchLiteral(iter, Infix.end(), error, CCSymbolsToInds, CCsToInds, Out, Modifs);
+					if (iter + 1 != endIter)
+						MunchLiteral(iter, endIter, error, CCSymbolsToInds, CCsToInds, Out, Modifs);
 					else
 					{
 						ContainerType LineChars;
@@ -2025,13 +2228,13 @@ namespace Evex
 							LineChars = "[\n]";
 						else
 							LineChars = "[\r\n\v\f]";
-						ContainerType Ind =
+						int Ind =
 							MunchCharClass(LineChars.begin() + 1, LineChars.end() - 1, error, CCSymbolsToInds, CCsToInds, Out, Modifs, MaxDepth);
 	
 						if (Modifs.SingleLine)
-							Out.push_back({ RegexInstructionType::EndCheck, { "t", "f", Ind } });
+							Out.Add(RegexInstructionType::EndCheck, { true, false, Ind });
 						else
-							Out.push_back({ RegexInstructionType::EndCheck, { "f", "f", Ind } });
+							Out.Add(RegexInstructionType::EndCheck, { false, false, Ind });
 					}
 					++NumNodes;
 					break;
@@ -2052,35 +2255,29 @@ namespace Evex
 	
 						DotClass += "]";
 	
-						ContainerType Ind =
+						int Ind =
 							MunchCharClass(DotClass.begin() + 1, DotClass.end() - 1, error, CCSymbolsToInds, CCsToInds, Out, Modifs, MaxDepth);
 	
-						Out.push_back({ RegexInstructionType::Literal, { Ind } });
+						Out.Add(RegexInstructionType::Literal, { Ind });
 	
 						++NumNodes;
 					}
 					break;
 	
-				case '|': // choice
-					{
-						InstructionSet SecondPart = TranslateInternal(Infix, ++iter, error, CCSymbolsToInds, CCsToInds, Modifs, MaxDepth);
-						if (!Out.empty() && !SecondPart.empty())
-						{
-							Out.insert(Out.end(), SecondPart.begin(), SecondPart.end());
-							Out.push_back({ RegexInstructionType::Alternate,{} });
-						}
-						else
-							Out.insert(Out.end(), SecondPart.begin(), SecondPart.end());
+				case '|': // choice. Each alternative starts afresh, and they're all alternated once the last is done.
+					if (Out.size() > BranchStart)
+						++FilledBranches;
+					BranchStart = Out.size();
 	
-						return Out;
-					}
-					break;
+					NumNodes = PrevNumNodes = LastGroup = 0;
+					++iter;
+					continue;
 	
 				case '?': // none or once
 				case '*': // none or more
 				case '+': // one or more
 				case '{': // Repetition ("{N}", "{N,}", "{N,M}")
-					MunchOp(iter, Infix.end(), error, CCSymbolsToInds, CCsToInds, Out, Modifs, *iter);
+					MunchOp(iter, endIter, error, CCSymbolsToInds, CCsToInds, Out, Modifs, *iter);
 					break;
 	
 				case '(': // group
@@ -2088,9 +2285,9 @@ namespace Evex
 						size_t PriorSize = Out.size();
 						{
 							IterType EndBracket = iter;
-							FindEnd(EndBracket, Infix.end(), '(', ')', nullptr);
+							FindEnd(EndBracket, endIter, '(', ')', nullptr);
 	
-							if (EndBracket != Infix.end())
+							if (EndBracket != endIter)
 								MunchGroup(++iter, EndBracket, error, CCSymbolsToInds, CCsToInds, Out, LastGroup, Modifs, MaxDepth);
 							else
 								error = "Regex Compile Error: Couldn't find closing bracket for group.";
@@ -2105,38 +2302,41 @@ namespace Evex
 					break;
 	
 				default: // literals
-					MunchLiteral(iter, Infix.end(), error, CCSymbolsToInds, CCsToInds, Out, Modifs);
+					MunchLiteral(iter, endIter, error, CCSymbolsToInds, CCsToInds, Out, Modifs);
 					++NumNodes;
 					break;
 				}
 	
+				if (!error.empty())
+					return;
+	
 				bool ShouldConcat = true;
 				{
 					IterType Copy = iter;
-					ShouldConcat = ++Copy == Infix.end();
+					ShouldConcat = ++Copy == endIter;
 					if (!ShouldConcat)
 					{
 						ShouldConcat =
 							*Copy != '?' &&
 							*Copy != '*' &&
 							*Copy != '+' &&
-							!(*Copy == '{' && (++Copy != Infix.end() && isdigit(*Copy)));
+							!(*Copy == '{' && (++Copy != endIter && isdigit(*Copy)));
 					}
 				}
 	
-				if (!error.empty())
-					return {};
-	
 				if (NumNodes > 1 && NumNodes > PrevNumNodes && ShouldConcat)
 				{
-					Out.push_back({ RegexInstructionType::Concat, {} });
+					Out.Add(RegexInstructionType::Concat);
 					PrevNumNodes = NumNodes;
 				}
 	
 				++iter;
 			}
 	
-			return Out;
+			if (Out.size() > BranchStart)
+				++FilledBranches;
+			while (FilledBranches-- > 1)
+				Out.Add(RegexInstructionType::Alternate);
 		}
 	
 	public:
@@ -2144,11 +2344,12 @@ namespace Evex
 		// Translates a given string into instructions for the regex assembler to follow.
 		static InstructionSet Translate(ContainerType& Infix, std::string& error, int MaxDepth)
 		{
-			IterType Iter = Infix.begin();
+			InstructionSet Out;
 			Modifiers Modifs;
 			IndexTracker CCSymbolsToInds;
 			IndexTracker CCsToInds;
-			return TranslateInternal(Infix, Iter, error, CCSymbolsToInds, CCsToInds, Modifs, MaxDepth);
+			TranslateInternal(Infix.begin(), Infix.end(), error, CCSymbolsToInds, CCsToInds, Out, Modifs, MaxDepth);
+			return Out;
 		}
 	};
 }
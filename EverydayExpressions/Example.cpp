@@ -1,6 +1,13 @@
 #include "Evex.h"
 #include "EvexDraw.h"
 #include "EvexSave.h"
+#include "EvexStream.h"
+#include "EvexSet.h"
+#include "EvexStatic.h"
+#include "EvexCache.h"
+
+// Opt-in, and last, as it brings in the platform's headers for mapping files.
+#include "EvexFile.h"
 
 #include <iostream>
 
@@ -27,6 +34,128 @@ int main()
 		Regex.MatchAll("Hello", AllResult);
 
 
+		/*
+			Retrieving matches and their groups as offsets into the input,
+			without copying any of it.
+		*/
+		Evex::Regex<char> Grouped("(?<greeting>[Hh]ello) (\\w+)");
+
+		std::string Input = "hello world, Hello there";
+		Evex::RegexMatchResults<char> Matches;
+		if (Grouped.MatchAll(Input, Matches))
+		{
+			for (size_t i = 0; i < Matches.size(); ++i)
+			{
+				std::string_view Whole = Matches[i].View();
+				std::string_view Greeting = Matches[i].View("greeting");
+				std::string_view Who = Matches[i].View(2);
+			}
+		}
+
+
+		/*
+			Matching through a context of your own. The regex itself is left untouched,
+			so it can be shared between threads as long as each has its own context.
+		*/
+		Evex::RegexMatchContext<char> Context;
+		if (Grouped.MatchAll(Context, Input, Matches))
+		{
+			std::string Greeting;
+			bool GreetingSucceeded = false;
+			Grouped.GetCapture(Context, "greeting", Greeting, GreetingSucceeded);
+		}
+
+
+		/*
+			Splitting MatchAll over a large input across threads, here one per core.
+			The matches found are exactly those a single thread would find.
+		*/
+		Grouped.MatchAll(Input, Matches, 0);
+
+
+		/*
+			Scanning a stream a piece at a time, e.g. as it comes in from a socket.
+			Matches are reported with their offsets from the start of the stream.
+		*/
+		Evex::RegexStreamScanner<char> Scanner(Grouped,
+			[](const Evex::RegexStreamMatch<char>& Match)
+			{
+				long long Where = Match.Begin();
+				std::string_view Greeting = Match.View("greeting");
+			});
+
+		Scanner.Feed("hello wo");
+		Scanner.Feed("rld, Hello there");
+		Scanner.Finish();
+
+
+		/*
+			Matching many regexes against the same input in one go, finding which of them match.
+		*/
+		Evex::RegexSet<char> Set({ "error", "warn(ing)?", "[0-9]+ms" });
+
+		std::vector<int> MatchedPatterns;
+		std::vector<Evex::RegexMatchResults<char>> PatternMatches;
+		if (Set.MatchAll("warning: took 250ms", MatchedPatterns, PatternMatches))
+		{
+			// MatchedPatterns is { 1, 2 }, and PatternMatches[1][0].View() is "250ms".
+		}
+
+
+		/*
+			Regexes given as string literals can have their syntax checked as the program is built,
+			and be compiled once per process rather than wherever they're used.
+			With C++20 this can also be written as Evex::StaticRegex<"[0-9]+ms">::Match(...).
+		*/
+		if (EVEX_STATIC_REGEX("[0-9]+ms").Match("250ms")) {}
+
+		// The build-time checker copies the translator's rules, so both should agree on every pattern here.
+		const std::initializer_list<const char*> ErrorPatterns =
+		{
+			"[abc", "(abc", "(ab(c)", "\\k<1", "\\g<x", "a{2,3", "a{2,", "a{2", "(?<n", "(?'n'", "(?@<x", "(?#x",
+			"(?%x", "(?(DEFINE)", "(?z:a)", "(?:a|", "\\"
+		};
+		const std::initializer_list<const char*> SuccessPatterns =
+		{
+			"abc", "[a-z]+", "(a)(b)\\1", "(?<n>a)\\k<n>", "a{2,3}", "a{2,}", "a{2}", "(?i:abc)", "(?(1)a|b)",
+			"\\d+\\.\\d*", "(a|b)*c", "a?b+?c*?", "a{x}", "[\\]]", "(?=a)", "(?<!a)", "a\\\\"
+		};
+
+		for (const auto& CurrPatterns : { ErrorPatterns, SuccessPatterns })
+		{
+			for (const char* CurrPattern : CurrPatterns)
+			{
+				std::string_view Expected = Evex::RegexSyntaxChecker::Message(Evex::RegexSyntaxChecker::Check(CurrPattern).Error);
+				Evex::Regex<char> Translated(CurrPattern);
+
+				if (Translated.GetCompileError().compare(0, Expected.size(), Expected) != 0 || Expected.empty() != Translated.GetCompileError().empty())
+					std::cout << CurrPattern << " is read differently by RegexSyntaxChecker and Regex\n";
+			}
+		}
+
+
+		/*
+			Sharing compiled regexes across the process, so patterns built from configuration are only compiled once.
+			Handles are read-only; each thread matches through a context of its own.
+		*/
+		std::shared_ptr<const Evex::Regex<char>> Cached = Evex::RegexCache<char>::Global().Get("warn(ing)?");
+
+		Evex::RegexMatchContext<char> ThreadContext;
+		if (Cached->Match(ThreadContext, "warning")) {}
+
+
+		/*
+			Looking behind past stars and counted loops, which are matched from their end back towards their beginning.
+		*/
+		Evex::Regex<char> BehindStar("(?<=ba*c)x");
+		if (!BehindStar.MatchAll("bcx baacx", Matches) || Matches.size() != 2)
+			std::cout << "(?<=ba*c)x should find both x's, with or without a's\n";
+
+		Evex::Regex<char> BehindCount("(?<=a{2}b)x");
+		if (BehindCount.MatchAll("abx", Matches) || !BehindCount.MatchAll("aabx", Matches))
+			std::cout << "(?<=a{2}b)x should only find the x after both a's\n";
+
+
 		/*
 			Using Evex::DrawRegex to draw a debug representation
 			of a regex's internal automaton.
@@ -38,7 +167,7 @@ int main()
 		/*
 			Saving an Evex regex instruction list out to a file with Evex::SaveRegex
 		*/
-		std::vector<Evex::RegexInstruction<char>> InstructionsToSave;
+		Evex::RegexProgram<char> InstructionsToSave;
 		Evex::Regex<char> SaveExample("Sample Text", nullptr, &InstructionsToSave);
 
 		Evex::SaveRegex<char>(InstructionsToSave, "../InstructionsOut.txt");
@@ -47,13 +176,57 @@ int main()
 		/*
 			Loading an Evex regex instruction list from a file with Evex::LoadRegex
 		*/
-		std::vector<Evex::RegexInstruction<char>> LoadedInstructions = Evex::LoadRegex<char>("../InstructionsOut.txt");
+		Evex::RegexProgram<char> LoadedInstructions = Evex::LoadRegex<char>("../InstructionsOut.txt");
 		Evex::Regex<char> FromInstructions(LoadedInstructions);
 
 		// Alternatively:
 		Evex::Regex<char> DirectlyLoaded(Evex::LoadRegex<char>("../InstructionsOut.txt"));
 
 		Evex::DrawRegex<char>(FromInstructions, "../GraphOut.txt");
+
+		// Instruction lists are checked before being followed, so broken ones give a compile error rather than crash.
+		Evex::RegexProgram<char> Unjoined;
+		Unjoined.Add(Evex::RegexInstructionType::Concat);
+
+		Evex::RegexProgram<char> NoSuchClass;
+		NoSuchClass.Add(Evex::RegexInstructionType::Literal, { 3 });
+
+		Evex::RegexProgram<char> Truncated = InstructionsToSave;
+		Truncated[0].OperandCount = 1;
+
+		for (const Evex::RegexProgram<char>* CurrBroken : { &Unjoined, &NoSuchClass, &Truncated })
+		{
+			if (Evex::Regex<char>(*CurrBroken).GetCompileError().empty())
+				std::cout << "A broken instruction list should give a compile error\n";
+		}
+
+
+		/*
+			Saving many instruction lists into one compact binary file, and reading them back
+			straight out of the mapped file.
+		*/
+		Evex::SaveRegexBinary<char>({ InstructionsToSave, LoadedInstructions }, "../InstructionsOut.bin");
+
+		Evex::RegexMappedFile BinaryFile("../InstructionsOut.bin");
+		Evex::RegexBinaryReader<char> Reader(BinaryFile.GetData(), BinaryFile.GetSize());
+		if (Reader.IsValid())
+		{
+			Evex::RegexProgram<char> SecondInstructions = Reader.GetInstructions(1);
+			Evex::Regex<char> FromBinary(SecondInstructions);
+		}
+
+
+		/*
+			Matching against a file in place with EvexFile.h, without reading it into a string first.
+			Matches are given as offsets from the start of the file.
+		*/
+		Evex::RegexMatchResults<char> FileMatches;
+		Evex::MatchAllInFile(FromInstructions, "../InstructionsOut.txt", FileMatches);
+
+		// Keeping the file mapped, so the matches can be viewed as well.
+		Evex::RegexMappedFile MappedFile("../InstructionsOut.txt");
+		if (Evex::MatchAllInFile(FromInstructions, MappedFile, FileMatches))
+			std::string_view FirstMatch = FileMatches[0].View();
 	}
 
 	system("pause");